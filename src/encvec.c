@@ -4,8 +4,9 @@
    
    Notes:
 
-      This file contains routines which generate each of the PostScript
-      enccoding vectors necessary to support the various languages.
+      This file contains the PostScript encoding vectors necessary to support
+      the various languages (as constant tables of glyph names) and the
+      routine which generates the one in use.
 
    Revision history:
 
@@ -24,6 +25,10 @@
 
 #include <stdio.h>
 
+#include "pcaldefs.h"
+#include "pcallang.h"
+#include "protos.h"
+
 /* ---------------------------------------------------------------------------
 
    Type, Struct, & Enum Declarations
@@ -42,12 +47,772 @@
 
 */
 
+/* number of entries in encoding vector table (cf. print_encvec()) */
+#define NUM_ENCVECS (sizeof(encvecs) / sizeof(encvecs[0]))
+
 /* ---------------------------------------------------------------------------
 
    Data Declarations (including externals)
 
 */
 
+/* ISO 8859-1 (Latin1) */
+
+static const char iso8859_1_header[] =
+   "%\n"
+   "% ISO 8859-1 (Latin1) character mappings\n"
+   "%\n";
+
+static const char *const iso8859_1_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              "grave",           "acute",           "circumflex",
+   /* 8#224 */ "tilde",           "macron",          "breve",           "dotaccent",
+   /* 8#230 */ "dieresis",        ".notdef",         "ring",            "cedilla",
+   /* 8#234 */ ".notdef",         "hungarumlaut",    "ogonek",          "caron",
+   /* 8#240 */ "space",           "exclamdown",      "cent",            "sterling",
+   /* 8#244 */ "currency",        "yen",             "brokenbar",       "section",
+   /* 8#250 */ "dieresis",        "copyright",       "ordfeminine",     "guillemotleft",
+   /* 8#254 */ "logicalnot",      "hyphen",          "registered",      "macron",
+   /* 8#260 */ "degree",          "plusminus",       "twosuperior",     "threesuperior",
+   /* 8#264 */ "acute",           "mu",              "paragraph",       "periodcentered",
+   /* 8#270 */ "cedilla",         "onesuperior",     "ordmasculine",    "guillemotright",
+   /* 8#274 */ "onequarter",      "onehalf",         "threequarters",   "questiondown",
+   /* 8#300 */ "Agrave",          "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Aring",           "AE",              "Ccedilla",
+   /* 8#310 */ "Egrave",          "Eacute",          "Ecircumflex",     "Edieresis",
+   /* 8#314 */ "Igrave",          "Iacute",          "Icircumflex",     "Idieresis",
+   /* 8#320 */ "Eth",             "Ntilde",          "Ograve",          "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Otilde",          "Odieresis",       "multiply",
+   /* 8#330 */ "Oslash",          "Ugrave",          "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Yacute",          "Thorn",           "germandbls",
+   /* 8#340 */ "agrave",          "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "aring",           "ae",              "ccedilla",
+   /* 8#350 */ "egrave",          "eacute",          "ecircumflex",     "edieresis",
+   /* 8#354 */ "igrave",          "iacute",          "icircumflex",     "idieresis",
+   /* 8#360 */ "eth",             "ntilde",          "ograve",          "oacute",
+   /* 8#364 */ "ocircumflex",     "otilde",          "odieresis",       "divide",
+   /* 8#370 */ "oslash",          "ugrave",          "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "yacute",          "thorn",           "ydieresis",
+};
+
+/* ISO 8859-2 (Latin2) */
+
+static const char iso8859_2_header[] =
+   "%\n"
+   "% ISO 8859-2 (Latin2) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_2_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "Aogonek",         "breve",           "Lslash",
+   /* 8#244 */ "currency",        "Lcaron",          "Sacute",          "section",
+   /* 8#250 */ "dieresis",        "Scaron",          "Scedilla",        "Tcaron",
+   /* 8#254 */ "Zacute",          "uni00AD",         "Zcaron",          "Zdotaccent",
+   /* 8#260 */ "degree",          "aogonek",         "ogonek",          "lslash",
+   /* 8#264 */ "acute",           "lcaron",          "sacute",          "caron",
+   /* 8#270 */ "cedilla",         "scaron",          "scedilla",        "tcaron",
+   /* 8#274 */ "zacute",          "hungarumlaut",    "zcaron",          "zdotaccent",
+   /* 8#300 */ "Racute",          "Aacute",          "Acircumflex",     "Abreve",
+   /* 8#304 */ "Adieresis",       "Lacute",          "Cacute",          "Ccedilla",
+   /* 8#310 */ "Ccaron",          "Eacute",          "Eogonek",         "Edieresis",
+   /* 8#314 */ "Ecaron",          "Iacute",          "Icircumflex",     "Dcaron",
+   /* 8#320 */ "Dcroat",          "Nacute",          "Ncaron",          "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Ohungarumlaut",   "Odieresis",       "multiply",
+   /* 8#330 */ "Rcaron",          "Uring",           "Uacute",          "Uhungarumlaut",
+   /* 8#334 */ "Udieresis",       "Yacute",          "uni0162",         "germandbls",
+   /* 8#340 */ "racute",          "aacute",          "acircumflex",     "abreve",
+   /* 8#344 */ "adieresis",       "lacute",          "cacute",          "ccedilla",
+   /* 8#350 */ "ccaron",          "eacute",          "eogonek",         "edieresis",
+   /* 8#354 */ "ecaron",          "iacute",          "icircumflex",     "dcaron",
+   /* 8#360 */ "dcroat",          "nacute",          "ncaron",          "oacute",
+   /* 8#364 */ "ocircumflex",     "ohungarumlaut",   "odieresis",       "divide",
+   /* 8#370 */ "rcaron",          "uring",           "uacute",          "uhungarumlaut",
+   /* 8#374 */ "udieresis",       "yacute",          "uni0163",         "dotaccent",
+};
+
+/* ISO 8859-3 (Latin3) */
+
+static const char iso8859_3_header[] =
+   "%\n"
+   "% ISO 8859-3 (Latin3) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_3_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "Hbar",            "breve",           "sterling",
+   /* 8#244 */ "currency",        "yen",             "Hcircumflex",     "section",
+   /* 8#250 */ "dieresis",        "Idotaccent",      "Scedilla",        "Gbreve",
+   /* 8#254 */ "Jcircumflex",     "uni00AD",         "registered",      "Zdotaccent",
+   /* 8#260 */ "degree",          "hbar",            "twosuperior",     "threesuperior",
+   /* 8#264 */ "acute",           "mu",              "hcircumflex",     "periodcentered",
+   /* 8#270 */ "cedilla",         "dotlessi",        "scedilla",        "gbreve",
+   /* 8#274 */ "jcircumflex",     "onehalf",         "threequarters",   "zdotaccent",
+   /* 8#300 */ "Agrave",          "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Cdotaccent",      "Ccircumflex",     "Ccedilla",
+   /* 8#310 */ "Egrave",          "Eacute",          "Ecircumflex",     "Edieresis",
+   /* 8#314 */ "Igrave",          "Iacute",          "Icircumflex",     "Idieresis",
+   /* 8#320 */ "Eth",             "Ntilde",          "Ograve",          "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Gdotaccent",      "Odieresis",       "multiply",
+   /* 8#330 */ "Gcircumflex",     "Ugrave",          "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Ubreve",          "Scircumflex",     "germandbls",
+   /* 8#340 */ "agrave",          "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "cdotaccent",      "ccircumflex",     "ccedilla",
+   /* 8#350 */ "egrave",          "eacute",          "ecircumflex",     "edieresis",
+   /* 8#354 */ "igrave",          "iacute",          "icircumflex",     "idieresis",
+   /* 8#360 */ "eth",             "ntilde",          "ograve",          "oacute",
+   /* 8#364 */ "ocircumflex",     "gdotaccent",      "odieresis",       "divide",
+   /* 8#370 */ "gcircumflex",     "ugrave",          "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "ubreve",          "scircumflex",     "dotaccent",
+};
+
+/* ISO 8859-4 (Latin4) */
+
+static const char iso8859_4_header[] =
+   "%\n"
+   "% ISO 8859-4 (Latin4) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_4_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "Aogonek",         "kgreenlandic",    "Rcommaaccent",
+   /* 8#244 */ "currency",        "Itilde",          "Lcommaaccent",    "section",
+   /* 8#250 */ "dieresis",        "Scaron",          "Emacron",         "Gcommaaccent",
+   /* 8#254 */ "Tbar",            "uni00AD",         "Zcaron",          "macron",
+   /* 8#260 */ "degree",          "aogonek",         "ogonek",          "rcommaaccent",
+   /* 8#264 */ "acute",           "itilde",          "lcommaaccent",    "caron",
+   /* 8#270 */ "cedilla",         "scaron",          "emacron",         "gcommaaccent",
+   /* 8#274 */ "tbar",            "Eng",             "zcaron",          "eng",
+   /* 8#300 */ "Amacron",         "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Aring",           "AE",              "Iogonek",
+   /* 8#310 */ "Ccaron",          "Eacute",          "Eogonek",         "Edieresis",
+   /* 8#314 */ "Edotaccent",      "Iacute",          "Icircumflex",     "Imacron",
+   /* 8#320 */ "Dcroat",          "Ncommaaccent",    "Omacron",         "Kcommaaccent",
+   /* 8#324 */ "Ocircumflex",     "Otilde",          "Odieresis",       "multiply",
+   /* 8#330 */ "Oslash",          "Uogonek",         "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Utilde",          "Umacron",         "germandbls",
+   /* 8#340 */ "amacron",         "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "aring",           "ae",              "iogonek",
+   /* 8#350 */ "ccaron",          "eacute",          "eogonek",         "edieresis",
+   /* 8#354 */ "edotaccent",      "iacute",          "icircumflex",     "imacron",
+   /* 8#360 */ "dcroat",          "ncommaaccent",    "omacron",         "kcommaaccent",
+   /* 8#364 */ "ocircumflex",     "otilde",          "odieresis",       "divide",
+   /* 8#370 */ "oslash",          "uogonek",         "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "utilde",          "umacron",         "dotaccent",
+};
+
+/* ISO 8859-5 (Cyrillic) */
+
+static const char iso8859_5_header[] =
+   "%\n"
+   "% ISO 8859-5 (Cyrillic) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_5_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "afii10023",       "afii10051",       "afii10052",
+   /* 8#244 */ "afii10053",       "afii10054",       "afii10055",       "afii10056",
+   /* 8#250 */ "afii10057",       "afii10058",       "afii10059",       "afii10060",
+   /* 8#254 */ "afii10061",       "uni00AD",         "afii10062",       "afii10145",
+   /* 8#260 */ "afii10017",       "afii10018",       "afii10019",       "afii10020",
+   /* 8#264 */ "afii10021",       "afii10022",       "afii10024",       "afii10025",
+   /* 8#270 */ "afii10026",       "afii10027",       "afii10028",       "afii10029",
+   /* 8#274 */ "afii10030",       "afii10031",       "afii10032",       "afii10033",
+   /* 8#300 */ "afii10034",       "afii10035",       "afii10036",       "afii10037",
+   /* 8#304 */ "afii10038",       "afii10039",       "afii10040",       "afii10041",
+   /* 8#310 */ "afii10042",       "afii10043",       "afii10044",       "afii10045",
+   /* 8#314 */ "afii10046",       "afii10047",       "afii10048",       "afii10049",
+   /* 8#320 */ "afii10065",       "afii10066",       "afii10067",       "afii10068",
+   /* 8#324 */ "afii10069",       "afii10070",       "afii10072",       "afii10073",
+   /* 8#330 */ "afii10074",       "afii10075",       "afii10076",       "afii10077",
+   /* 8#334 */ "afii10078",       "afii10079",       "afii10080",       "afii10081",
+   /* 8#340 */ "afii10082",       "afii10083",       "afii10084",       "afii10085",
+   /* 8#344 */ "afii10086",       "afii10087",       "afii10088",       "afii10089",
+   /* 8#350 */ "afii10090",       "afii10091",       "afii10092",       "afii10093",
+   /* 8#354 */ "afii10094",       "afii10095",       "afii10096",       "afii10097",
+   /* 8#360 */ "afii61352",       "afii10071",       "afii10099",       "afii10100",
+   /* 8#364 */ "afii10101",       "afii10102",       "afii10103",       "afii10104",
+   /* 8#370 */ "afii10105",       "afii10106",       "afii10107",       "afii10108",
+   /* 8#374 */ "afii10109",       "section",         "afii10110",       "afii10193",
+};
+
+/*   %\n%%%   % ISO 8859-6 (Arabic) */
+
+static const char iso8859_6_header[] =
+   "%%%   %\n"
+   "%%%   % ISO 8859-6 (Arabic) character mappings\n"
+   "%%%   % \n"
+   "%%%   % This PostScript encoding vector is currently undefined because the\n"
+   "%%%   % information needed to create it was not found.\n"
+   "%%%   % \n"
+   "%%%   /alt_mappings [\n"
+   "%%%   ] readonly def\n"
+   "\n";
+
+/* ISO 8859-7 (Greek) */
+
+static const char iso8859_7_header[] =
+   "%\n"
+   "% ISO 8859-7 (Greek) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_7_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "afii64937",       "afii57929",       "sterling",
+   /* 8#244 */ "currency",        "yen",             "brokenbar",       "section",
+   /* 8#250 */ "dieresis",        "copyright",       "ordfeminine",     "guillemotleft",
+   /* 8#254 */ "logicalnot",      "uni00AD",         "registered",      "afii00208",
+   /* 8#260 */ "degree",          "plusminus",       "twosuperior",     "threesuperior",
+   /* 8#264 */ "tonos",           "dieresistonos",   "Alphatonos",      "periodcentered",
+   /* 8#270 */ "Epsilontonos",    "Etatonos",        "Iotatonos",       "guillemotright",
+   /* 8#274 */ "Omicrontonos",    "onehalf",         "Upsilontonos",    "Omegatonos",
+   /* 8#300 */ "iotadieresistonos", "Alpha",           "Beta",            "Gamma",
+   /* 8#304 */ "uni0394",         "Epsilon",         "Zeta",            "Eta",
+   /* 8#310 */ "Theta",           "Iota",            "Kappa",           "Lambda",
+   /* 8#314 */ "Mu",              "Nu",              "Xi",              "Omicron",
+   /* 8#320 */ "Pi",              "Rho",             "Ograve",          "Sigma",
+   /* 8#324 */ "Tau",             "Upsilon",         "Phi",             "Chi",
+   /* 8#330 */ "Psi",             "uni03A9",         "Iotadieresis",    "Upsilondieresis",
+   /* 8#334 */ "alphatonos",      "epsilontonos",    "etatonos",        "iotatonos",
+   /* 8#340 */ "upsilondieresistonos", "alpha",           "beta",            "gamma",
+   /* 8#344 */ "delta",           "epsilon",         "zeta",            "eta",
+   /* 8#350 */ "theta",           "iota",            "kappa",           "lambda",
+   /* 8#354 */ "uni03BC",         "nu",              "xi",              "omicron",
+   /* 8#360 */ "pi",              "rho",             "sigma1",          "sigma",
+   /* 8#364 */ "tau",             "upsilon",         "phi",             "chi",
+   /* 8#370 */ "psi",             "omega",           "iotadieresis",    "upsilondieresis",
+   /* 8#374 */ "omicrontonos",    "upsilontonos",    "omegatonos",      "ydieresis",
+};
+
+/*   %\n%%%   % ISO 8859-8 (Hebrew) */
+
+static const char iso8859_8_header[] =
+   "%%%   %\n"
+   "%%%   % ISO 8859-8 (Hebrew) character mappings\n"
+   "%%%   % \n"
+   "%%%   % This PostScript encoding vector is currently undefined because the\n"
+   "%%%   % information needed to create it was not found.\n"
+   "%%%   % \n"
+   "%%%   /alt_mappings [\n"
+   "%%%   ] readonly def\n";
+
+/* ISO 8859-9 (Latin5) */
+
+static const char iso8859_9_header[] =
+   "%\n"
+   "% ISO 8859-9 (Latin5) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_9_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "exclamdown",      "cent",            "sterling",
+   /* 8#244 */ "currency",        "yen",             "brokenbar",       "section",
+   /* 8#250 */ "dieresis",        "copyright",       "ordfeminine",     "guillemotleft",
+   /* 8#254 */ "logicalnot",      "uni00AD",         "registered",      "macron",
+   /* 8#260 */ "degree",          "plusminus",       "twosuperior",     "threesuperior",
+   /* 8#264 */ "acute",           "mu",              "paragraph",       "periodcentered",
+   /* 8#270 */ "cedilla",         "onesuperior",     "ordmasculine",    "guillemotright",
+   /* 8#274 */ "onequarter",      "onehalf",         "threequarters",   "questiondown",
+   /* 8#300 */ "Agrave",          "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Aring",           "AE",              "Ccedilla",
+   /* 8#310 */ "Egrave",          "Eacute",          "Ecircumflex",     "Edieresis",
+   /* 8#314 */ "Igrave",          "Iacute",          "Icircumflex",     "Idieresis",
+   /* 8#320 */ "Gbreve",          "Ntilde",          "Ograve",          "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Otilde",          "Odieresis",       "multiply",
+   /* 8#330 */ "Oslash",          "Ugrave",          "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Idotaccent",      "Scedilla",        "germandbls",
+   /* 8#340 */ "agrave",          "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "aring",           "ae",              "ccedilla",
+   /* 8#350 */ "egrave",          "eacute",          "ecircumflex",     "edieresis",
+   /* 8#354 */ "igrave",          "iacute",          "icircumflex",     "idieresis",
+   /* 8#360 */ "gbreve",          "ntilde",          "ograve",          "oacute",
+   /* 8#364 */ "ocircumflex",     "otilde",          "odieresis",       "divide",
+   /* 8#370 */ "oslash",          "ugrave",          "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "dotlessi",        "scedilla",        "ydieresis",
+};
+
+/* ISO 8859-10 (Latin6) */
+
+static const char iso8859_10_header[] =
+   "%\n"
+   "% ISO 8859-10 (Latin6) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_10_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "Aogonek",         "Emacron",         "Gcommaaccent",
+   /* 8#244 */ "Imacron",         "Itilde",          "Kcommaaccent",    "section",
+   /* 8#250 */ "Lcommaaccent",    "Dcroat",          "Scaron",          "Tbar",
+   /* 8#254 */ "Zcaron",          "uni00AD",         "Umacron",         "Eng",
+   /* 8#260 */ "degree",          "aogonek",         "emacron",         "gcommaaccent",
+   /* 8#264 */ "imacron",         "itilde",          "kcommaaccent",    "periodcentered",
+   /* 8#270 */ "lcommaaccent",    "dcroat",          "scaron",          "tbar",
+   /* 8#274 */ "zcaron",          "macron",          "umacron",         "eng",
+   /* 8#300 */ "Amacron",         "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Aring",           "AE",              "Iogonek",
+   /* 8#310 */ "Ccaron",          "Eacute",          "Eogonek",         "Edieresis",
+   /* 8#314 */ "Emacron",         "Iacute",          "Icircumflex",     "Idieresis",
+   /* 8#320 */ "Eth",             "Ncommaaccent",    "Omacron",         "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Otilde",          "Odieresis",       "Utilde",
+   /* 8#330 */ "Oslash",          "Uogonek",         "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Yacute",          "Thorn",           "germandbls",
+   /* 8#340 */ "amacron",         "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "aring",           "ae",              "iogonek",
+   /* 8#350 */ "ccaron",          "eacute",          "eogonek",         "edieresis",
+   /* 8#354 */ "emacron",         "iacute",          "icircumflex",     "idieresis",
+   /* 8#360 */ "eth",             "ncommaaccent",    "omacron",         "oacute",
+   /* 8#364 */ "ocircumflex",     "otilde",          "odieresis",       "utilde",
+   /* 8#370 */ "oslash",          "uogonek",         "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "yacute",          "thorn",           "kgreenlandic",
+};
+
+/* ISO 8859-11 (Thai) */
+
+static const char iso8859_11_header[] =
+   "%\n"
+   "% ISO 8859-11 (Thai) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_11_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "uni0E01",         "uni0E02",         "uni0E03",
+   /* 8#244 */ "uni0E04",         "uni0E05",         "uni0E06",         "uni0E07",
+   /* 8#250 */ "uni0E08",         "uni0E09",         "uni0E0A",         "uni0E0B",
+   /* 8#254 */ "uni0E0C",         "uni0E0D",         "uni0E0E",         "uni0E0F",
+   /* 8#260 */ "uni0E10",         "uni0E11",         "uni0E12",         "uni0E13",
+   /* 8#264 */ "uni0E14",         "uni0E15",         "uni0E16",         "uni0E17",
+   /* 8#270 */ "uni0E18",         "uni0E19",         "uni0E1A",         "uni0E1B",
+   /* 8#274 */ "uni0E1C",         "uni0E1D",         "uni0E1E",         "uni0E1F",
+   /* 8#300 */ "uni0E20",         "uni0E21",         "uni0E22",         "uni0E23",
+   /* 8#304 */ "uni0E24",         "uni0E25",         "uni0E26",         "uni0E27",
+   /* 8#310 */ "uni0E28",         "uni0E29",         "uni0E2A",         "uni0E2B",
+   /* 8#314 */ "uni0E2C",         "uni0E2D",         "uni0E2E",         "uni0E2F",
+   /* 8#320 */ "uni0E30",         "uni0E31",         "uni0E32",         "uni0E33",
+   /* 8#324 */ "uni0E34",         "uni0E35",         "uni0E36",         "uni0E37",
+   /* 8#330 */ "uni0E38",         "uni0E39",         "uni0E3A",         ".notdef",
+   /* 8#334 */ "space",           ".notdef",         ".notdef",         "uni0E3F",
+   /* 8#340 */ "uni0E40",         "uni0E41",         "uni0E42",         "uni0E43",
+   /* 8#344 */ "uni0E44",         "uni0E45",         "uni0E46",         "uni0E47",
+   /* 8#350 */ "uni0E48",         "uni0E49",         "uni0E4A",         "uni0E4B",
+   /* 8#354 */ "uni0E4C",         "uni0E4D",         "uni0E4E",         "uni0E4F",
+   /* 8#360 */ "uni0E50",         "uni0E51",         "uni0E52",         "uni0E53",
+   /* 8#364 */ "uni0E54",         "uni0E55",         "uni0E56",         "uni0E57",
+   /* 8#370 */ "uni0E58",         "uni0E59",         "uni0E5A",         ".notdef",
+   /* 8#374 */ ".notdef",         ".notdef",         ".notdef",         ".notdef",
+};
+
+/* ISO 8859-13 (Latin7) */
+
+static const char iso8859_13_header[] =
+   "%\n"
+   "% ISO 8859-13 (Latin7) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_13_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "quotedblright",   "cent",            "sterling",
+   /* 8#244 */ "currency",        "quotedblbase",    "brokenbar",       "section",
+   /* 8#250 */ "Oslash",          "copyright",       "rcommaaccent",    "guillemotleft",
+   /* 8#254 */ "logicalnot",      "uni00AD",         "registered",      "AE",
+   /* 8#260 */ "degree",          "plusminus",       "twosuperior",     "threesuperior",
+   /* 8#264 */ "quotedblleft",    "mu",              "paragraph",       "periodcentered",
+   /* 8#270 */ "oslash",          "onesuperior",     ".notdef",         "guillemotright",
+   /* 8#274 */ "onequarter",      "onehalf",         "threequarters",   "ae",
+   /* 8#300 */ "Aogonek",         "Iogonek",         "Amacron",         "Cacute",
+   /* 8#304 */ "Adieresis",       "Aring",           "Eogonek",         "Emacron",
+   /* 8#310 */ "Ccaron",          "Eacute",          "Zacute",          "Edotaccent",
+   /* 8#314 */ "Gcommaaccent",    "Kcommaaccent",    "Imacron",         "Lcommaaccent",
+   /* 8#320 */ "Scaron",          "Nacute",          "Ncommaaccent",    "Oacute",
+   /* 8#324 */ "Omacron",         "Otilde",          "Odieresis",       "multiply",
+   /* 8#330 */ "Uogonek",         "Lslash",          "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Zdotaccent",      "Zcaron",          "germandbls",
+   /* 8#340 */ "aogonek",         "Iogonek",         "amacron",         "cacute",
+   /* 8#344 */ "adieresis",       "aring",           "eogonek",         "emacron",
+   /* 8#350 */ "ccaron",          "eacute",          "zacute",          "edotaccent",
+   /* 8#354 */ "gcommaaccent",    "kcommaaccent",    "imacron",         "lcommaaccent",
+   /* 8#360 */ "scaron",          "nacute",          "ncommaaccent",    "oacute",
+   /* 8#364 */ "omacron",         "otilde",          "odieresis",       "divide",
+   /* 8#370 */ "uogonek",         "lslash",          "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "zdotaccent",      "zcaron",          "quoteright",
+};
+
+/* ISO 8859-14 (Latin8) */
+
+static const char iso8859_14_header[] =
+   "%\n"
+   "% ISO 8859-14 (Latin8) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_14_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "uni1E02",         "uni1E03",         "sterling",
+   /* 8#244 */ "Cdotaccent",      "cdotaccent",      "uni1E0A",         "section",
+   /* 8#250 */ "Wgrave",          "copyright",       "Wacute",          "uni1E0B",
+   /* 8#254 */ "Ygrave",          "uni00AD",         "registered",      "Ydieresis",
+   /* 8#260 */ "uni1E1E",         "uni1E1F",         "Gdotaccent",      "gdotaccent",
+   /* 8#264 */ "uni1E40",         "uni1E41",         "paragraph",       "uni1E56",
+   /* 8#270 */ "wgrave",          "uni1E57",         "wacute",          "uni1E60",
+   /* 8#274 */ "ygrave",          "Wdieresis",       "wdieresis",       "uni1E61",
+   /* 8#300 */ "Agrave",          "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Aring",           "AE",              "Ccedilla",
+   /* 8#310 */ "Egrave",          "Eacute",          "Ecircumflex",     "Edieresis",
+   /* 8#314 */ "Igrave",          "Iacute",          "Icircumflex",     "Idieresis",
+   /* 8#320 */ "Wcircumflex",     "Ntilde",          "Ograve",          "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Otilde",          "Odieresis",       "uni1E6A",
+   /* 8#330 */ "Oslash",          "Ugrave",          "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Yacute",          "Ycircumflex",     "germandbls",
+   /* 8#340 */ "agrave",          "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "aring",           "ae",              "ccedilla",
+   /* 8#350 */ "egrave",          "eacute",          "ecircumflex",     "edieresis",
+   /* 8#354 */ "igrave",          "iacute",          "icircumflex",     "idieresis",
+   /* 8#360 */ "wcircumflex",     "ntilde",          "ograve",          "oacute",
+   /* 8#364 */ "ocircumflex",     "otilde",          "odieresis",       "uni1E6B",
+   /* 8#370 */ "oslash",          "ugrave",          "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "yacute",          "ycircumflex",     "ydieresis",
+};
+
+/* ISO 8859-15 (Latin9 aka Latin0) */
+
+static const char iso8859_15_header[] =
+   "%\n"
+   "% ISO 8859-15 (Latin9 aka Latin0) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const iso8859_15_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ "uni00A0",         "exclamdown",      "cent",            "sterling",
+   /* 8#244 */ "Euro",            "yen",             "Scaron",          "section",
+   /* 8#250 */ "scaron",          "copyright",       "ordfeminine",     "guillemotleft",
+   /* 8#254 */ "logicalnot",      "uni00AD",         "registered",      "macron",
+   /* 8#260 */ "degree",          "plusminus",       "twosuperior",     "threesuperior",
+   /* 8#264 */ "Zcaron",          "mu",              "paragraph",       "periodcentered",
+   /* 8#270 */ "zcaron",          "onesuperior",     "ordmasculine",    "guillemotright",
+   /* 8#274 */ "OE",              "oe",              "Ydieresis",       "questiondown",
+   /* 8#300 */ "Agrave",          "Aacute",          "Acircumflex",     "Atilde",
+   /* 8#304 */ "Adieresis",       "Aring",           "AE",              "Ccedilla",
+   /* 8#310 */ "Egrave",          "Eacute",          "Ecircumflex",     "Edieresis",
+   /* 8#314 */ "Igrave",          "Iacute",          "Icircumflex",     "Idieresis",
+   /* 8#320 */ "Eth",             "Ntilde",          "Ograve",          "Oacute",
+   /* 8#324 */ "Ocircumflex",     "Otilde",          "Odieresis",       "multiply",
+   /* 8#330 */ "Oslash",          "Ugrave",          "Uacute",          "Ucircumflex",
+   /* 8#334 */ "Udieresis",       "Yacute",          "Thorn",           "germandbls",
+   /* 8#340 */ "agrave",          "aacute",          "acircumflex",     "atilde",
+   /* 8#344 */ "adieresis",       "aring",           "ae",              "ccedilla",
+   /* 8#350 */ "egrave",          "eacute",          "ecircumflex",     "edieresis",
+   /* 8#354 */ "igrave",          "iacute",          "icircumflex",     "idieresis",
+   /* 8#360 */ "eth",             "ntilde",          "ograve",          "oacute",
+   /* 8#364 */ "ocircumflex",     "otilde",          "odieresis",       "divide",
+   /* 8#370 */ "oslash",          "ugrave",          "uacute",          "ucircumflex",
+   /* 8#374 */ "udieresis",       "yacute",          "thorn",           "ydieresis",
+};
+
+/*   %\n%%%   % ISO 8859-16 (Latin10) */
+
+static const char iso8859_16_header[] =
+   "%%%   %\n"
+   "%%%   % ISO 8859-16 (Latin10) character mappings\n"
+   "%%%   % \n"
+   "%%%   % This PostScript encoding vector is currently undefined because the\n"
+   "%%%   % information needed to create it was not found.\n"
+   "%%%   % \n"
+   "%%%   /alt_mappings [\n"
+   "%%%   ] readonly def\n";
+
+/* KOI8-R (Russian) */
+
+static const char koi8_r_header[] =
+   "%\n"
+   "% KOI8-R (Russian) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector was derived from the information at the following\n"
+   "% website (circa Jan 2005), which covers several character mappings:\n"
+   "%    \n"
+   "%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n"
+   "% \n";
+
+static const char *const koi8_r_glyphs[128] = {
+   /* 8#200 */ "SF100000",        "SF110000",        "SF010000",        "SF030000",
+   /* 8#204 */ "SF020000",        "SF040000",        "SF080000",        "SF090000",
+   /* 8#210 */ "SF060000",        "SF070000",        "SF050000",        "upblock",
+   /* 8#214 */ "dnblock",         "block",           "lfblock",         "rtblock",
+   /* 8#220 */ "ltshade",         "shade",           "dkshade",         "integraltp",
+   /* 8#224 */ "filledbox",       "uni2219",         "radical",         "approxequal",
+   /* 8#230 */ "lessequal",       "greaterequal",    "uni00A0",         "integralbt",
+   /* 8#234 */ "degree",          "twosuperior",     "periodcentered",  "divide",
+   /* 8#240 */ "SF430000",        "SF240000",        "SF510000",        "afii10071",
+   /* 8#244 */ "SF520000",        "SF390000",        "SF220000",        "SF210000",
+   /* 8#250 */ "SF250000",        "SF500000",        "SF490000",        "SF380000",
+   /* 8#254 */ "SF280000",        "SF270000",        "SF260000",        "SF360000",
+   /* 8#260 */ "SF370000",        "SF420000",        "SF190000",        "afii10023",
+   /* 8#264 */ "SF200000",        "SF230000",        "SF470000",        "SF480000",
+   /* 8#270 */ "SF410000",        "SF450000",        "SF460000",        "SF400000",
+   /* 8#274 */ "SF540000",        "SF530000",        "SF440000",        "copyright",
+   /* 8#300 */ "afii10096",       "afii10065",       "afii10066",       "afii10088",
+   /* 8#304 */ "afii10069",       "afii10070",       "afii10086",       "afii10068",
+   /* 8#310 */ "afii10087",       "afii10074",       "afii10075",       "afii10076",
+   /* 8#314 */ "afii10077",       "afii10078",       "afii10079",       "afii10080",
+   /* 8#320 */ "afii10081",       "afii10097",       "afii10082",       "afii10083",
+   /* 8#324 */ "afii10084",       "afii10085",       "afii10072",       "afii10067",
+   /* 8#330 */ "afii10094",       "afii10093",       "afii10073",       "afii10090",
+   /* 8#334 */ "afii10095",       "afii10091",       "afii10089",       "afii10092",
+   /* 8#340 */ "afii10048",       "afii10017",       "afii10018",       "afii10040",
+   /* 8#344 */ "afii10021",       "afii10022",       "afii10038",       "afii10020",
+   /* 8#350 */ "afii10039",       "afii10026",       "afii10027",       "afii10028",
+   /* 8#354 */ "afii10029",       "afii10030",       "afii10031",       "afii10032",
+   /* 8#360 */ "afii10033",       "afii10049",       "afii10034",       "afii10035",
+   /* 8#364 */ "afii10036",       "afii10037",       "afii10024",       "afii10019",
+   /* 8#370 */ "afii10046",       "afii10045",       "afii10025",       "afii10042",
+   /* 8#374 */ "afii10047",       "afii10043",       "afii10041",       "afii10044",
+};
+
+/* KOI8-U (Ukrainian) */
+
+static const char koi8_u_header[] =
+   "%\n"
+   "% KOI8-U (Ukrainian) character mappings\n"
+   "% \n"
+   "% This PostScript encoding vector came from the Ukrainian language patch\n"
+   "% provided by Volodymyr M. Lisivka <lvm at mystery.lviv.net>.\n"
+   "% \n";
+
+static const char *const koi8_u_glyphs[128] = {
+   /* 8#200 */ "SF100000",        "SF110000",        "SF010000",        "SF030000",
+   /* 8#204 */ "SF020000",        "SF040000",        "SF080000",        "SF090000",
+   /* 8#210 */ "SF060000",        "SF070000",        "SF050000",        "upblock",
+   /* 8#214 */ "dnblock",         "block",           "lfblock",         "rtblock",
+   /* 8#220 */ "ltshade",         "shade",           "dkshade",         "integraltp",
+   /* 8#224 */ "filledbox",       "periodcentered",  "radical",         "approxequal",
+   /* 8#230 */ "lessequal",       "greaterequal",    "space",           "integralbt",
+   /* 8#234 */ "degree",          "twosuperior",     "periodcentered",  "divide",
+   /* 8#240 */ "SF430000",        "SF240000",        "SF510000",        "afii10071",
+   /* 8#244 */ "afii10101",       "SF390000",        "afii10103",       "afii10104",
+   /* 8#250 */ "SF250000",        "SF500000",        "SF490000",        "SF380000",
+   /* 8#254 */ "SF280000",        "afii10098",       "SF260000",        "SF360000",
+   /* 8#260 */ "SF370000",        "SF420000",        "SF190000",        "afii10023",
+   /* 8#264 */ "afii10053",       "SF230000",        "afii10055",       "afii10056",
+   /* 8#270 */ "SF410000",        "SF450000",        "SF460000",        "SF400000",
+   /* 8#274 */ "SF540000",        "afii10050",       "SF440000",        "copyright",
+   /* 8#300 */ "afii10096",       "afii10065",       "afii10066",       "afii10088",
+   /* 8#304 */ "afii10069",       "afii10070",       "afii10086",       "afii10068",
+   /* 8#310 */ "afii10087",       "afii10074",       "afii10075",       "afii10076",
+   /* 8#314 */ "afii10077",       "afii10078",       "afii10079",       "afii10080",
+   /* 8#320 */ "afii10081",       "afii10097",       "afii10082",       "afii10083",
+   /* 8#324 */ "afii10084",       "afii10085",       "afii10072",       "afii10067",
+   /* 8#330 */ "afii10094",       "afii10093",       "afii10073",       "afii10090",
+   /* 8#334 */ "afii10095",       "afii10091",       "afii10089",       "afii10092",
+   /* 8#340 */ "afii10048",       "afii10017",       "afii10018",       "afii10040",
+   /* 8#344 */ "afii10021",       "afii10022",       "afii10038",       "afii10020",
+   /* 8#350 */ "afii10039",       "afii10026",       "afii10027",       "afii10028",
+   /* 8#354 */ "afii10029",       "afii10030",       "afii10031",       "afii10032",
+   /* 8#360 */ "afii10033",       "afii10049",       "afii10034",       "afii10035",
+   /* 8#364 */ "afii10036",       "afii10037",       "afii10024",       "afii10019",
+   /* 8#370 */ "afii10046",       "afii10045",       "afii10025",       "afii10042",
+   /* 8#374 */ "afii10047",       "afii10043",       "afii10041",       "afii10044",
+};
+
+/* Roman8 */
+
+static const char roman8_header[] =
+   "%\n"
+   "% Roman8 character mappings\n"
+   "%\n";
+
+static const char *const roman8_glyphs[128] = {
+   /* 8#200 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#204 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#210 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#214 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#220 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#224 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#230 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#234 */ NULL,              NULL,              NULL,              NULL,
+   /* 8#240 */ NULL,              "Agrave",          "Acircumflex",     "Egrave",
+   /* 8#244 */ "Ecircumflex",     "Edieresis",       "Icircumflex",     "Idieresis",
+   /* 8#250 */ "acute",           "grave",           "circumflex",      "dieresis",
+   /* 8#254 */ "tilde",           "Ugrave",          "Ucircumflex",     "sterling",
+   /* 8#260 */ "macron",          "Yacute",          "yacute",          "degree",
+   /* 8#264 */ "Ccedilla",        "ccedilla",        "Ntilde",          "ntilde",
+   /* 8#270 */ "exclamdown",      "questiondown",    "currency",        "sterling",
+   /* 8#274 */ "yen",             "section",         "florin",          "cent",
+   /* 8#300 */ "acircumflex",     "ecircumflex",     "ocircumflex",     "ucircumflex",
+   /* 8#304 */ "aacute",          "eacute",          "oacute",          "uacute",
+   /* 8#310 */ "agrave",          "egrave",          "ograve",          "ugrave",
+   /* 8#314 */ "adieresis",       "edieresis",       "odieresis",       "udieresis",
+   /* 8#320 */ "Aring",           "icircumflex",     "Oslash",          "AE",
+   /* 8#324 */ "aring",           "iacute",          "oslash",          "ae",
+   /* 8#330 */ "Adieresis",       "igrave",          "Odieresis",       "Udieresis",
+   /* 8#334 */ "Eacute",          "idieresis",       "germandbls",      "Ocircumflex",
+   /* 8#340 */ "Aacute",          "Atilde",          "atilde",          "Eth",
+   /* 8#344 */ "eth",             "Iacute",          "Igrave",          "Oacute",
+   /* 8#350 */ "Ograve",          "Otilde",          "otilde",          "Scaron",
+   /* 8#354 */ "scaron",          "Uacute",          "Ydieresis",       "ydieresis",
+   /* 8#360 */ "thorn",           "Thorn",           "dotaccent",       "mu",
+   /* 8#364 */ "paragraph",       "threequarters",   "hyphen",          "onequarter",
+   /* 8#370 */ "onehalf",         "ordfeminine",     "ordmasculine",    "guillemotleft",
+   /* 8#374 */ "bullet",          "guillemotright",  "plusminus",       ".notdef",
+};
+
+/* table of encoding vectors, by encoding (cf. pcallang.h) */
+
+static const struct {
+   int encoding;
+   const char *header;          /* leading PostScript comments */
+   const char *const *glyphs;   /* glyph names for 8#200-8#377 (NULL: none) */
+} encvecs[] = {
+   { ENC_LATIN_1,   iso8859_1_header, iso8859_1_glyphs },
+   { ENC_LATIN_2,   iso8859_2_header, iso8859_2_glyphs },
+   { ENC_LATIN_3,   iso8859_3_header, iso8859_3_glyphs },
+   { ENC_LATIN_4,   iso8859_4_header, iso8859_4_glyphs },
+   { ENC_CYRILLIC,  iso8859_5_header, iso8859_5_glyphs },
+   { ENC_ARABIC,    iso8859_6_header, NULL },
+   { ENC_GREEK,     iso8859_7_header, iso8859_7_glyphs },
+   { ENC_HEBREW,    iso8859_8_header, NULL },
+   { ENC_LATIN_5,   iso8859_9_header, iso8859_9_glyphs },
+   { ENC_LATIN_6,   iso8859_10_header, iso8859_10_glyphs },
+   { ENC_THAI,      iso8859_11_header, iso8859_11_glyphs },
+   { ENC_LATIN_7,   iso8859_13_header, iso8859_13_glyphs },
+   { ENC_LATIN_8,   iso8859_14_header, iso8859_14_glyphs },
+   { ENC_LATIN_9,   iso8859_15_header, iso8859_15_glyphs },
+   { ENC_LATIN_10,  iso8859_16_header, NULL },
+   { ENC_KOI8_R,    koi8_r_header, koi8_r_glyphs },
+   { ENC_KOI8_U,    koi8_u_header, koi8_u_glyphs },
+   { ENC_ROMAN8,    roman8_header, roman8_glyphs },
+};
+
 /* ---------------------------------------------------------------------------
 
    External Routine References & Function Prototypes
@@ -148,831 +913,43 @@
 
 /* ---------------------------------------------------------------------------
 
-   encvec_iso8859_1
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_1 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-1 (Latin1) character mappings\n");
-   printf("%%\n");
-   printf("/alt_mappings [\n");
-   printf("                        8#221 /grave          8#222 /acute           8#223 /circumflex\n");
-   printf("   8#224 /tilde         8#225 /macron         8#226 /breve           8#227 /dotaccent\n");
-   printf("   8#230 /dieresis      8#231 /.notdef        8#232 /ring            8#233 /cedilla\n");
-   printf("   8#234 /.notdef       8#235 /hungarumlaut   8#236 /ogonek          8#237 /caron\n");
-   printf("   8#240 /space         8#241 /exclamdown     8#242 /cent            8#243 /sterling\n");
-   printf("   8#244 /currency      8#245 /yen            8#246 /brokenbar       8#247 /section\n");
-   printf("   8#250 /dieresis      8#251 /copyright      8#252 /ordfeminine     8#253 /guillemotleft\n");
-   printf("   8#254 /logicalnot    8#255 /hyphen         8#256 /registered      8#257 /macron\n");
-   printf("   8#260 /degree        8#261 /plusminus      8#262 /twosuperior     8#263 /threesuperior\n");
-   printf("   8#264 /acute         8#265 /mu             8#266 /paragraph       8#267 /periodcentered\n");
-   printf("   8#270 /cedilla       8#271 /onesuperior    8#272 /ordmasculine    8#273 /guillemotright\n");
-   printf("   8#274 /onequarter    8#275 /onehalf        8#276 /threequarters   8#277 /questiondown\n");
-   printf("   8#300 /Agrave        8#301 /Aacute         8#302 /Acircumflex     8#303 /Atilde\n");
-   printf("   8#304 /Adieresis     8#305 /Aring          8#306 /AE              8#307 /Ccedilla\n");
-   printf("   8#310 /Egrave        8#311 /Eacute         8#312 /Ecircumflex     8#313 /Edieresis\n");
-   printf("   8#314 /Igrave        8#315 /Iacute         8#316 /Icircumflex     8#317 /Idieresis\n");
-   printf("   8#320 /Eth           8#321 /Ntilde         8#322 /Ograve          8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex   8#325 /Otilde         8#326 /Odieresis       8#327 /multiply\n");
-   printf("   8#330 /Oslash        8#331 /Ugrave         8#332 /Uacute          8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis     8#335 /Yacute         8#336 /Thorn           8#337 /germandbls\n");
-   printf("   8#340 /agrave        8#341 /aacute         8#342 /acircumflex     8#343 /atilde\n");
-   printf("   8#344 /adieresis     8#345 /aring          8#346 /ae              8#347 /ccedilla\n");
-   printf("   8#350 /egrave        8#351 /eacute         8#352 /ecircumflex     8#353 /edieresis\n");
-   printf("   8#354 /igrave        8#355 /iacute         8#356 /icircumflex     8#357 /idieresis\n");
-   printf("   8#360 /eth           8#361 /ntilde         8#362 /ograve          8#363 /oacute\n");
-   printf("   8#364 /ocircumflex   8#365 /otilde         8#366 /odieresis       8#367 /divide\n");
-   printf("   8#370 /oslash        8#371 /ugrave         8#372 /uacute          8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis     8#375 /yacute         8#376 /thorn           8#377 /ydieresis\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_2
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_2 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-2 (Latin2) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0       8#241 /Aogonek         8#242 /breve         8#243 /Lslash\n");
-   printf("   8#244 /currency      8#245 /Lcaron          8#246 /Sacute        8#247 /section\n");
-   printf("   8#250 /dieresis      8#251 /Scaron          8#252 /Scedilla      8#253 /Tcaron\n");
-   printf("   8#254 /Zacute        8#255 /uni00AD         8#256 /Zcaron        8#257 /Zdotaccent\n");
-   printf("   8#260 /degree        8#261 /aogonek         8#262 /ogonek        8#263 /lslash\n");
-   printf("   8#264 /acute         8#265 /lcaron          8#266 /sacute        8#267 /caron\n");
-   printf("   8#270 /cedilla       8#271 /scaron          8#272 /scedilla      8#273 /tcaron\n");
-   printf("   8#274 /zacute        8#275 /hungarumlaut    8#276 /zcaron        8#277 /zdotaccent\n");
-   printf("   8#300 /Racute        8#301 /Aacute          8#302 /Acircumflex   8#303 /Abreve\n");
-   printf("   8#304 /Adieresis     8#305 /Lacute          8#306 /Cacute        8#307 /Ccedilla\n");
-   printf("   8#310 /Ccaron        8#311 /Eacute          8#312 /Eogonek       8#313 /Edieresis\n");
-   printf("   8#314 /Ecaron        8#315 /Iacute          8#316 /Icircumflex   8#317 /Dcaron\n");
-   printf("   8#320 /Dcroat        8#321 /Nacute          8#322 /Ncaron        8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex   8#325 /Ohungarumlaut   8#326 /Odieresis     8#327 /multiply\n");
-   printf("   8#330 /Rcaron        8#331 /Uring           8#332 /Uacute        8#333 /Uhungarumlaut\n");
-   printf("   8#334 /Udieresis     8#335 /Yacute          8#336 /uni0162       8#337 /germandbls\n");
-   printf("   8#340 /racute        8#341 /aacute          8#342 /acircumflex   8#343 /abreve\n");
-   printf("   8#344 /adieresis     8#345 /lacute          8#346 /cacute        8#347 /ccedilla\n");
-   printf("   8#350 /ccaron        8#351 /eacute          8#352 /eogonek       8#353 /edieresis\n");
-   printf("   8#354 /ecaron        8#355 /iacute          8#356 /icircumflex   8#357 /dcaron\n");
-   printf("   8#360 /dcroat        8#361 /nacute          8#362 /ncaron        8#363 /oacute\n");
-   printf("   8#364 /ocircumflex   8#365 /ohungarumlaut   8#366 /odieresis     8#367 /divide\n");
-   printf("   8#370 /rcaron        8#371 /uring           8#372 /uacute        8#373 /uhungarumlaut\n");
-   printf("   8#374 /udieresis     8#375 /yacute          8#376 /uni0163       8#377 /dotaccent\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_3
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_3 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-3 (Latin3) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0       8#241 /Hbar         8#242 /breve           8#243 /sterling\n");
-   printf("   8#244 /currency      8#245 /yen          8#246 /Hcircumflex     8#247 /section\n");
-   printf("   8#250 /dieresis      8#251 /Idotaccent   8#252 /Scedilla        8#253 /Gbreve\n");
-   printf("   8#254 /Jcircumflex   8#255 /uni00AD      8#256 /registered      8#257 /Zdotaccent\n");
-   printf("   8#260 /degree        8#261 /hbar         8#262 /twosuperior     8#263 /threesuperior\n");
-   printf("   8#264 /acute         8#265 /mu           8#266 /hcircumflex     8#267 /periodcentered\n");
-   printf("   8#270 /cedilla       8#271 /dotlessi     8#272 /scedilla        8#273 /gbreve\n");
-   printf("   8#274 /jcircumflex   8#275 /onehalf      8#276 /threequarters   8#277 /zdotaccent\n");
-   printf("   8#300 /Agrave        8#301 /Aacute       8#302 /Acircumflex     8#303 /Atilde\n");
-   printf("   8#304 /Adieresis     8#305 /Cdotaccent   8#306 /Ccircumflex     8#307 /Ccedilla\n");
-   printf("   8#310 /Egrave        8#311 /Eacute       8#312 /Ecircumflex     8#313 /Edieresis\n");
-   printf("   8#314 /Igrave        8#315 /Iacute       8#316 /Icircumflex     8#317 /Idieresis\n");
-   printf("   8#320 /Eth           8#321 /Ntilde       8#322 /Ograve          8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex   8#325 /Gdotaccent   8#326 /Odieresis       8#327 /multiply\n");
-   printf("   8#330 /Gcircumflex   8#331 /Ugrave       8#332 /Uacute          8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis     8#335 /Ubreve       8#336 /Scircumflex     8#337 /germandbls\n");
-   printf("   8#340 /agrave        8#341 /aacute       8#342 /acircumflex     8#343 /atilde\n");
-   printf("   8#344 /adieresis     8#345 /cdotaccent   8#346 /ccircumflex     8#347 /ccedilla\n");
-   printf("   8#350 /egrave        8#351 /eacute       8#352 /ecircumflex     8#353 /edieresis\n");
-   printf("   8#354 /igrave        8#355 /iacute       8#356 /icircumflex     8#357 /idieresis\n");
-   printf("   8#360 /eth           8#361 /ntilde       8#362 /ograve          8#363 /oacute\n");
-   printf("   8#364 /ocircumflex   8#365 /gdotaccent   8#366 /odieresis       8#367 /divide\n");
-   printf("   8#370 /gcircumflex   8#371 /ugrave       8#372 /uacute          8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis     8#375 /ubreve       8#376 /scircumflex     8#377 /dotaccent\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_4
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_4 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-4 (Latin4) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0       8#241 /Aogonek        8#242 /kgreenlandic   8#243 /Rcommaaccent\n");
-   printf("   8#244 /currency      8#245 /Itilde         8#246 /Lcommaaccent   8#247 /section\n");
-   printf("   8#250 /dieresis      8#251 /Scaron         8#252 /Emacron        8#253 /Gcommaaccent\n");
-   printf("   8#254 /Tbar          8#255 /uni00AD        8#256 /Zcaron         8#257 /macron\n");
-   printf("   8#260 /degree        8#261 /aogonek        8#262 /ogonek         8#263 /rcommaaccent\n");
-   printf("   8#264 /acute         8#265 /itilde         8#266 /lcommaaccent   8#267 /caron\n");
-   printf("   8#270 /cedilla       8#271 /scaron         8#272 /emacron        8#273 /gcommaaccent\n");
-   printf("   8#274 /tbar          8#275 /Eng            8#276 /zcaron         8#277 /eng\n");
-   printf("   8#300 /Amacron       8#301 /Aacute         8#302 /Acircumflex    8#303 /Atilde\n");
-   printf("   8#304 /Adieresis     8#305 /Aring          8#306 /AE             8#307 /Iogonek\n");
-   printf("   8#310 /Ccaron        8#311 /Eacute         8#312 /Eogonek        8#313 /Edieresis\n");
-   printf("   8#314 /Edotaccent    8#315 /Iacute         8#316 /Icircumflex    8#317 /Imacron\n");
-   printf("   8#320 /Dcroat        8#321 /Ncommaaccent   8#322 /Omacron        8#323 /Kcommaaccent\n");
-   printf("   8#324 /Ocircumflex   8#325 /Otilde         8#326 /Odieresis      8#327 /multiply\n");
-   printf("   8#330 /Oslash        8#331 /Uogonek        8#332 /Uacute         8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis     8#335 /Utilde         8#336 /Umacron        8#337 /germandbls\n");
-   printf("   8#340 /amacron       8#341 /aacute         8#342 /acircumflex    8#343 /atilde\n");
-   printf("   8#344 /adieresis     8#345 /aring          8#346 /ae             8#347 /iogonek\n");
-   printf("   8#350 /ccaron        8#351 /eacute         8#352 /eogonek        8#353 /edieresis\n");
-   printf("   8#354 /edotaccent    8#355 /iacute         8#356 /icircumflex    8#357 /imacron\n");
-   printf("   8#360 /dcroat        8#361 /ncommaaccent   8#362 /omacron        8#363 /kcommaaccent\n");
-   printf("   8#364 /ocircumflex   8#365 /otilde         8#366 /odieresis      8#367 /divide\n");
-   printf("   8#370 /oslash        8#371 /uogonek        8#372 /uacute         8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis     8#375 /utilde         8#376 /umacron        8#377 /dotaccent\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_5
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_5 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-5 (Cyrillic) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0     8#241 /afii10023   8#242 /afii10051   8#243 /afii10052\n");
-   printf("   8#244 /afii10053   8#245 /afii10054   8#246 /afii10055   8#247 /afii10056\n");
-   printf("   8#250 /afii10057   8#251 /afii10058   8#252 /afii10059   8#253 /afii10060\n");
-   printf("   8#254 /afii10061   8#255 /uni00AD     8#256 /afii10062   8#257 /afii10145\n");
-   printf("   8#260 /afii10017   8#261 /afii10018   8#262 /afii10019   8#263 /afii10020\n");
-   printf("   8#264 /afii10021   8#265 /afii10022   8#266 /afii10024   8#267 /afii10025\n");
-   printf("   8#270 /afii10026   8#271 /afii10027   8#272 /afii10028   8#273 /afii10029\n");
-   printf("   8#274 /afii10030   8#275 /afii10031   8#276 /afii10032   8#277 /afii10033\n");
-   printf("   8#300 /afii10034   8#301 /afii10035   8#302 /afii10036   8#303 /afii10037\n");
-   printf("   8#304 /afii10038   8#305 /afii10039   8#306 /afii10040   8#307 /afii10041\n");
-   printf("   8#310 /afii10042   8#311 /afii10043   8#312 /afii10044   8#313 /afii10045\n");
-   printf("   8#314 /afii10046   8#315 /afii10047   8#316 /afii10048   8#317 /afii10049\n");
-   printf("   8#320 /afii10065   8#321 /afii10066   8#322 /afii10067   8#323 /afii10068\n");
-   printf("   8#324 /afii10069   8#325 /afii10070   8#326 /afii10072   8#327 /afii10073\n");
-   printf("   8#330 /afii10074   8#331 /afii10075   8#332 /afii10076   8#333 /afii10077\n");
-   printf("   8#334 /afii10078   8#335 /afii10079   8#336 /afii10080   8#337 /afii10081\n");
-   printf("   8#340 /afii10082   8#341 /afii10083   8#342 /afii10084   8#343 /afii10085\n");
-   printf("   8#344 /afii10086   8#345 /afii10087   8#346 /afii10088   8#347 /afii10089\n");
-   printf("   8#350 /afii10090   8#351 /afii10091   8#352 /afii10092   8#353 /afii10093\n");
-   printf("   8#354 /afii10094   8#355 /afii10095   8#356 /afii10096   8#357 /afii10097\n");
-   printf("   8#360 /afii61352   8#361 /afii10071   8#362 /afii10099   8#363 /afii10100\n");
-   printf("   8#364 /afii10101   8#365 /afii10102   8#366 /afii10103   8#367 /afii10104\n");
-   printf("   8#370 /afii10105   8#371 /afii10106   8#372 /afii10107   8#373 /afii10108\n");
-   printf("   8#374 /afii10109   8#375 /section     8#376 /afii10110   8#377 /afii10193\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_6
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_6 (void)
-{
-   printf("%%%%%%   %%\n");
-   printf("%%%%%%   %% ISO 8859-6 (Arabic) character mappings\n");
-   printf("%%%%%%   %% \n");
-   printf("%%%%%%   %% This PostScript encoding vector is currently undefined because the\n");
-   printf("%%%%%%   %% information needed to create it was not found.\n");
-   printf("%%%%%%   %% \n");
-   printf("%%%%%%   /alt_mappings [\n");
-   printf("%%%%%%   ] readonly def\n");
-   printf("\n");
-   
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_7
+   print_encvec
 
    Notes:
 
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_7 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-7 (Greek) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0                8#241 /afii64937       8#242 /afii57929      8#243 /sterling\n");
-   printf("   8#244 /currency               8#245 /yen             8#246 /brokenbar      8#247 /section\n");
-   printf("   8#250 /dieresis               8#251 /copyright       8#252 /ordfeminine    8#253 /guillemotleft\n");
-   printf("   8#254 /logicalnot             8#255 /uni00AD         8#256 /registered     8#257 /afii00208\n");
-   printf("   8#260 /degree                 8#261 /plusminus       8#262 /twosuperior    8#263 /threesuperior\n");
-   printf("   8#264 /tonos                  8#265 /dieresistonos   8#266 /Alphatonos     8#267 /periodcentered\n");
-   printf("   8#270 /Epsilontonos           8#271 /Etatonos        8#272 /Iotatonos      8#273 /guillemotright\n");
-   printf("   8#274 /Omicrontonos           8#275 /onehalf         8#276 /Upsilontonos   8#277 /Omegatonos\n");
-   printf("   8#300 /iotadieresistonos      8#301 /Alpha           8#302 /Beta           8#303 /Gamma\n");
-   printf("   8#304 /uni0394                8#305 /Epsilon         8#306 /Zeta           8#307 /Eta\n");
-   printf("   8#310 /Theta                  8#311 /Iota            8#312 /Kappa          8#313 /Lambda\n");
-   printf("   8#314 /Mu                     8#315 /Nu              8#316 /Xi             8#317 /Omicron\n");
-   printf("   8#320 /Pi                     8#321 /Rho             8#322 /Ograve         8#323 /Sigma\n");
-   printf("   8#324 /Tau                    8#325 /Upsilon         8#326 /Phi            8#327 /Chi\n");
-   printf("   8#330 /Psi                    8#331 /uni03A9         8#332 /Iotadieresis   8#333 /Upsilondieresis\n");
-   printf("   8#334 /alphatonos             8#335 /epsilontonos    8#336 /etatonos       8#337 /iotatonos\n");
-   printf("   8#340 /upsilondieresistonos   8#341 /alpha           8#342 /beta           8#343 /gamma\n");
-   printf("   8#344 /delta                  8#345 /epsilon         8#346 /zeta           8#347 /eta\n");
-   printf("   8#350 /theta                  8#351 /iota            8#352 /kappa          8#353 /lambda\n");
-   printf("   8#354 /uni03BC                8#355 /nu              8#356 /xi             8#357 /omicron\n");
-   printf("   8#360 /pi                     8#361 /rho             8#362 /sigma1         8#363 /sigma\n");
-   printf("   8#364 /tau                    8#365 /upsilon         8#366 /phi            8#367 /chi\n");
-   printf("   8#370 /psi                    8#371 /omega           8#372 /iotadieresis   8#373 /upsilondieresis\n");
-   printf("   8#374 /omicrontonos           8#375 /upsilontonos    8#376 /omegatonos     8#377 /ydieresis\n");
-   printf("] readonly def\n");
-
-   return;
-}
+      This routine outputs the PostScript encoding vector for the specified
+      encoding (one of the 'ENC_xxx' values), used to support any languages
+      which use that encoding.
 
-/* ---------------------------------------------------------------------------
+      Only the characters flagged in 'used' (indexed by character code) are
+      included in the vector, since 'remap_font' need not remap characters
+      which are never printed.
 
-   encvec_iso8859_8
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
+      It returns FALSE if the encoding is unknown.
 
 */
-void encvec_iso8859_8 (void)
+int print_encvec (int encoding, const char *used)
 {
-   printf("%%%%%%   %%\n");
-   printf("%%%%%%   %% ISO 8859-8 (Hebrew) character mappings\n");
-   printf("%%%%%%   %% \n");
-   printf("%%%%%%   %% This PostScript encoding vector is currently undefined because the\n");
-   printf("%%%%%%   %% information needed to create it was not found.\n");
-   printf("%%%%%%   %% \n");
-   printf("%%%%%%   /alt_mappings [\n");
-   printf("%%%%%%   ] readonly def\n");
-
-   return;
-}
+   unsigned int i;
+   int c, n;
+   const char *const *glyphs;
 
-/* ---------------------------------------------------------------------------
+   for (i = 0; i < NUM_ENCVECS && encvecs[i].encoding != encoding; i++)
+      ;
+   if (i == NUM_ENCVECS) return FALSE;
 
-   encvec_iso8859_9
+   out_str(encvecs[i].header);
 
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_9 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-9 (Latin5) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0       8#241 /exclamdown    8#242 /cent            8#243 /sterling\n");
-   printf("   8#244 /currency      8#245 /yen           8#246 /brokenbar       8#247 /section\n");
-   printf("   8#250 /dieresis      8#251 /copyright     8#252 /ordfeminine     8#253 /guillemotleft\n");
-   printf("   8#254 /logicalnot    8#255 /uni00AD       8#256 /registered      8#257 /macron\n");
-   printf("   8#260 /degree        8#261 /plusminus     8#262 /twosuperior     8#263 /threesuperior\n");
-   printf("   8#264 /acute         8#265 /mu            8#266 /paragraph       8#267 /periodcentered\n");
-   printf("   8#270 /cedilla       8#271 /onesuperior   8#272 /ordmasculine    8#273 /guillemotright\n");
-   printf("   8#274 /onequarter    8#275 /onehalf       8#276 /threequarters   8#277 /questiondown\n");
-   printf("   8#300 /Agrave        8#301 /Aacute        8#302 /Acircumflex     8#303 /Atilde\n");
-   printf("   8#304 /Adieresis     8#305 /Aring         8#306 /AE              8#307 /Ccedilla\n");
-   printf("   8#310 /Egrave        8#311 /Eacute        8#312 /Ecircumflex     8#313 /Edieresis\n");
-   printf("   8#314 /Igrave        8#315 /Iacute        8#316 /Icircumflex     8#317 /Idieresis\n");
-   printf("   8#320 /Gbreve        8#321 /Ntilde        8#322 /Ograve          8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex   8#325 /Otilde        8#326 /Odieresis       8#327 /multiply\n");
-   printf("   8#330 /Oslash        8#331 /Ugrave        8#332 /Uacute          8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis     8#335 /Idotaccent    8#336 /Scedilla        8#337 /germandbls\n");
-   printf("   8#340 /agrave        8#341 /aacute        8#342 /acircumflex     8#343 /atilde\n");
-   printf("   8#344 /adieresis     8#345 /aring         8#346 /ae              8#347 /ccedilla\n");
-   printf("   8#350 /egrave        8#351 /eacute        8#352 /ecircumflex     8#353 /edieresis\n");
-   printf("   8#354 /igrave        8#355 /iacute        8#356 /icircumflex     8#357 /idieresis\n");
-   printf("   8#360 /gbreve        8#361 /ntilde        8#362 /ograve          8#363 /oacute\n");
-   printf("   8#364 /ocircumflex   8#365 /otilde        8#366 /odieresis       8#367 /divide\n");
-   printf("   8#370 /oslash        8#371 /ugrave        8#372 /uacute          8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis     8#375 /dotlessi      8#376 /scedilla        8#377 /ydieresis\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
+   /* encodings lacking a vector consist only of (commented-out) header */
+   if ((glyphs = encvecs[i].glyphs) == NULL) return TRUE;
 
-   encvec_iso8859_10
-
-   Notes:
+   OUT_LIT("/alt_mappings [");
+   for (c = 0200, n = 0; c <= 0377; c++) {
+      if (!used[c] || glyphs[c - 0200] == NULL) continue;
+      out_printf("%s8#%03o /%s", n++ % 4 == 0 ? "\n   " : "   ", c,
+                 glyphs[c - 0200]);
+   }
+   OUT_LIT("\n] readonly def\n");
 
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_10 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-10 (Latin6) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0        8#241 /Aogonek        8#242 /Emacron        8#243 /Gcommaaccent\n");
-   printf("   8#244 /Imacron        8#245 /Itilde         8#246 /Kcommaaccent   8#247 /section\n");
-   printf("   8#250 /Lcommaaccent   8#251 /Dcroat         8#252 /Scaron         8#253 /Tbar\n");
-   printf("   8#254 /Zcaron         8#255 /uni00AD        8#256 /Umacron        8#257 /Eng\n");
-   printf("   8#260 /degree         8#261 /aogonek        8#262 /emacron        8#263 /gcommaaccent\n");
-   printf("   8#264 /imacron        8#265 /itilde         8#266 /kcommaaccent   8#267 /periodcentered\n");
-   printf("   8#270 /lcommaaccent   8#271 /dcroat         8#272 /scaron         8#273 /tbar\n");
-   printf("   8#274 /zcaron         8#275 /macron         8#276 /umacron        8#277 /eng\n");
-   printf("   8#300 /Amacron        8#301 /Aacute         8#302 /Acircumflex    8#303 /Atilde\n");
-   printf("   8#304 /Adieresis      8#305 /Aring          8#306 /AE             8#307 /Iogonek\n");
-   printf("   8#310 /Ccaron         8#311 /Eacute         8#312 /Eogonek        8#313 /Edieresis\n");
-   printf("   8#314 /Emacron        8#315 /Iacute         8#316 /Icircumflex    8#317 /Idieresis\n");
-   printf("   8#320 /Eth            8#321 /Ncommaaccent   8#322 /Omacron        8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex    8#325 /Otilde         8#326 /Odieresis      8#327 /Utilde\n");
-   printf("   8#330 /Oslash         8#331 /Uogonek        8#332 /Uacute         8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis      8#335 /Yacute         8#336 /Thorn          8#337 /germandbls\n");
-   printf("   8#340 /amacron        8#341 /aacute         8#342 /acircumflex    8#343 /atilde\n");
-   printf("   8#344 /adieresis      8#345 /aring          8#346 /ae             8#347 /iogonek\n");
-   printf("   8#350 /ccaron         8#351 /eacute         8#352 /eogonek        8#353 /edieresis\n");
-   printf("   8#354 /emacron        8#355 /iacute         8#356 /icircumflex    8#357 /idieresis\n");
-   printf("   8#360 /eth            8#361 /ncommaaccent   8#362 /omacron        8#363 /oacute\n");
-   printf("   8#364 /ocircumflex    8#365 /otilde         8#366 /odieresis      8#367 /utilde\n");
-   printf("   8#370 /oslash         8#371 /uogonek        8#372 /uacute         8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis      8#375 /yacute         8#376 /thorn          8#377 /kgreenlandic\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_11
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_11 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-11 (Thai) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0   8#241 /uni0E01   8#242 /uni0E02   8#243 /uni0E03\n");
-   printf("   8#244 /uni0E04   8#245 /uni0E05   8#246 /uni0E06   8#247 /uni0E07\n");
-   printf("   8#250 /uni0E08   8#251 /uni0E09   8#252 /uni0E0A   8#253 /uni0E0B\n");
-   printf("   8#254 /uni0E0C   8#255 /uni0E0D   8#256 /uni0E0E   8#257 /uni0E0F\n");
-   printf("   8#260 /uni0E10   8#261 /uni0E11   8#262 /uni0E12   8#263 /uni0E13\n");
-   printf("   8#264 /uni0E14   8#265 /uni0E15   8#266 /uni0E16   8#267 /uni0E17\n");
-   printf("   8#270 /uni0E18   8#271 /uni0E19   8#272 /uni0E1A   8#273 /uni0E1B\n");
-   printf("   8#274 /uni0E1C   8#275 /uni0E1D   8#276 /uni0E1E   8#277 /uni0E1F\n");
-   printf("   8#300 /uni0E20   8#301 /uni0E21   8#302 /uni0E22   8#303 /uni0E23\n");
-   printf("   8#304 /uni0E24   8#305 /uni0E25   8#306 /uni0E26   8#307 /uni0E27\n");
-   printf("   8#310 /uni0E28   8#311 /uni0E29   8#312 /uni0E2A   8#313 /uni0E2B\n");
-   printf("   8#314 /uni0E2C   8#315 /uni0E2D   8#316 /uni0E2E   8#317 /uni0E2F\n");
-   printf("   8#320 /uni0E30   8#321 /uni0E31   8#322 /uni0E32   8#323 /uni0E33\n");
-   printf("   8#324 /uni0E34   8#325 /uni0E35   8#326 /uni0E36   8#327 /uni0E37\n");
-   printf("   8#330 /uni0E38   8#331 /uni0E39   8#332 /uni0E3A   8#333 /.notdef\n");
-   printf("   8#334 /space     8#335 /.notdef   8#336 /.notdef   8#337 /uni0E3F\n");
-   printf("   8#340 /uni0E40   8#341 /uni0E41   8#342 /uni0E42   8#343 /uni0E43\n");
-   printf("   8#344 /uni0E44   8#345 /uni0E45   8#346 /uni0E46   8#347 /uni0E47\n");
-   printf("   8#350 /uni0E48   8#351 /uni0E49   8#352 /uni0E4A   8#353 /uni0E4B\n");
-   printf("   8#354 /uni0E4C   8#355 /uni0E4D   8#356 /uni0E4E   8#357 /uni0E4F\n");
-   printf("   8#360 /uni0E50   8#361 /uni0E51   8#362 /uni0E52   8#363 /uni0E53\n");
-   printf("   8#364 /uni0E54   8#365 /uni0E55   8#366 /uni0E56   8#367 /uni0E57\n");
-   printf("   8#370 /uni0E58   8#371 /uni0E59   8#372 /uni0E5A   8#373 /.notdef\n");
-   printf("   8#374 /.notdef   8#375 /.notdef   8#376 /.notdef   8#377 /.notdef\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_13
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_13 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-13 (Latin7) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0        8#241 /quotedblright   8#242 /cent            8#243 /sterling\n");
-   printf("   8#244 /currency       8#245 /quotedblbase    8#246 /brokenbar       8#247 /section\n");
-   printf("   8#250 /Oslash         8#251 /copyright       8#252 /rcommaaccent    8#253 /guillemotleft\n");
-   printf("   8#254 /logicalnot     8#255 /uni00AD         8#256 /registered      8#257 /AE\n");
-   printf("   8#260 /degree         8#261 /plusminus       8#262 /twosuperior     8#263 /threesuperior\n");
-   printf("   8#264 /quotedblleft   8#265 /mu              8#266 /paragraph       8#267 /periodcentered\n");
-   printf("   8#270 /oslash         8#271 /onesuperior     8#272 /.notdef         8#273 /guillemotright\n");
-   printf("   8#274 /onequarter     8#275 /onehalf         8#276 /threequarters   8#277 /ae\n");
-   printf("   8#300 /Aogonek        8#301 /Iogonek         8#302 /Amacron         8#303 /Cacute\n");
-   printf("   8#304 /Adieresis      8#305 /Aring           8#306 /Eogonek         8#307 /Emacron\n");
-   printf("   8#310 /Ccaron         8#311 /Eacute          8#312 /Zacute          8#313 /Edotaccent\n");
-   printf("   8#314 /Gcommaaccent   8#315 /Kcommaaccent    8#316 /Imacron         8#317 /Lcommaaccent\n");
-   printf("   8#320 /Scaron         8#321 /Nacute          8#322 /Ncommaaccent    8#323 /Oacute\n");
-   printf("   8#324 /Omacron        8#325 /Otilde          8#326 /Odieresis       8#327 /multiply\n");
-   printf("   8#330 /Uogonek        8#331 /Lslash          8#332 /Uacute          8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis      8#335 /Zdotaccent      8#336 /Zcaron          8#337 /germandbls\n");
-   printf("   8#340 /aogonek        8#341 /Iogonek         8#342 /amacron         8#343 /cacute\n");
-   printf("   8#344 /adieresis      8#345 /aring           8#346 /eogonek         8#347 /emacron\n");
-   printf("   8#350 /ccaron         8#351 /eacute          8#352 /zacute          8#353 /edotaccent\n");
-   printf("   8#354 /gcommaaccent   8#355 /kcommaaccent    8#356 /imacron         8#357 /lcommaaccent\n");
-   printf("   8#360 /scaron         8#361 /nacute          8#362 /ncommaaccent    8#363 /oacute\n");
-   printf("   8#364 /omacron        8#365 /otilde          8#366 /odieresis       8#367 /divide\n");
-   printf("   8#370 /uogonek        8#371 /lslash          8#372 /uacute          8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis      8#375 /zdotaccent      8#376 /zcaron          8#377 /quoteright\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_14
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_14 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-14 (Latin8) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0       8#241 /uni1E02      8#242 /uni1E03       8#243 /sterling\n");
-   printf("   8#244 /Cdotaccent    8#245 /cdotaccent   8#246 /uni1E0A       8#247 /section\n");
-   printf("   8#250 /Wgrave        8#251 /copyright    8#252 /Wacute        8#253 /uni1E0B\n");
-   printf("   8#254 /Ygrave        8#255 /uni00AD      8#256 /registered    8#257 /Ydieresis\n");
-   printf("   8#260 /uni1E1E       8#261 /uni1E1F      8#262 /Gdotaccent    8#263 /gdotaccent\n");
-   printf("   8#264 /uni1E40       8#265 /uni1E41      8#266 /paragraph     8#267 /uni1E56\n");
-   printf("   8#270 /wgrave        8#271 /uni1E57      8#272 /wacute        8#273 /uni1E60\n");
-   printf("   8#274 /ygrave        8#275 /Wdieresis    8#276 /wdieresis     8#277 /uni1E61\n");
-   printf("   8#300 /Agrave        8#301 /Aacute       8#302 /Acircumflex   8#303 /Atilde\n");
-   printf("   8#304 /Adieresis     8#305 /Aring        8#306 /AE            8#307 /Ccedilla\n");
-   printf("   8#310 /Egrave        8#311 /Eacute       8#312 /Ecircumflex   8#313 /Edieresis\n");
-   printf("   8#314 /Igrave        8#315 /Iacute       8#316 /Icircumflex   8#317 /Idieresis\n");
-   printf("   8#320 /Wcircumflex   8#321 /Ntilde       8#322 /Ograve        8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex   8#325 /Otilde       8#326 /Odieresis     8#327 /uni1E6A\n");
-   printf("   8#330 /Oslash        8#331 /Ugrave       8#332 /Uacute        8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis     8#335 /Yacute       8#336 /Ycircumflex   8#337 /germandbls\n");
-   printf("   8#340 /agrave        8#341 /aacute       8#342 /acircumflex   8#343 /atilde\n");
-   printf("   8#344 /adieresis     8#345 /aring        8#346 /ae            8#347 /ccedilla\n");
-   printf("   8#350 /egrave        8#351 /eacute       8#352 /ecircumflex   8#353 /edieresis\n");
-   printf("   8#354 /igrave        8#355 /iacute       8#356 /icircumflex   8#357 /idieresis\n");
-   printf("   8#360 /wcircumflex   8#361 /ntilde       8#362 /ograve        8#363 /oacute\n");
-   printf("   8#364 /ocircumflex   8#365 /otilde       8#366 /odieresis     8#367 /uni1E6B\n");
-   printf("   8#370 /oslash        8#371 /ugrave       8#372 /uacute        8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis     8#375 /yacute       8#376 /ycircumflex   8#377 /ydieresis\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_15
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_15 (void)
-{
-   printf("%%\n");
-   printf("%% ISO 8859-15 (Latin9 aka Latin0) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#240 /uni00A0       8#241 /exclamdown    8#242 /cent          8#243 /sterling\n");
-   printf("   8#244 /Euro          8#245 /yen           8#246 /Scaron        8#247 /section\n");
-   printf("   8#250 /scaron        8#251 /copyright     8#252 /ordfeminine   8#253 /guillemotleft\n");
-   printf("   8#254 /logicalnot    8#255 /uni00AD       8#256 /registered    8#257 /macron\n");
-   printf("   8#260 /degree        8#261 /plusminus     8#262 /twosuperior   8#263 /threesuperior\n");
-   printf("   8#264 /Zcaron        8#265 /mu            8#266 /paragraph     8#267 /periodcentered\n");
-   printf("   8#270 /zcaron        8#271 /onesuperior   8#272 /ordmasculine  8#273 /guillemotright\n");
-   printf("   8#274 /OE            8#275 /oe            8#276 /Ydieresis     8#277 /questiondown\n");
-   printf("   8#300 /Agrave        8#301 /Aacute        8#302 /Acircumflex   8#303 /Atilde\n");
-   printf("   8#304 /Adieresis     8#305 /Aring         8#306 /AE            8#307 /Ccedilla\n");
-   printf("   8#310 /Egrave        8#311 /Eacute        8#312 /Ecircumflex   8#313 /Edieresis\n");
-   printf("   8#314 /Igrave        8#315 /Iacute        8#316 /Icircumflex   8#317 /Idieresis\n");
-   printf("   8#320 /Eth           8#321 /Ntilde        8#322 /Ograve        8#323 /Oacute\n");
-   printf("   8#324 /Ocircumflex   8#325 /Otilde        8#326 /Odieresis     8#327 /multiply\n");
-   printf("   8#330 /Oslash        8#331 /Ugrave        8#332 /Uacute        8#333 /Ucircumflex\n");
-   printf("   8#334 /Udieresis     8#335 /Yacute        8#336 /Thorn         8#337 /germandbls\n");
-   printf("   8#340 /agrave        8#341 /aacute        8#342 /acircumflex   8#343 /atilde\n");
-   printf("   8#344 /adieresis     8#345 /aring         8#346 /ae            8#347 /ccedilla\n");
-   printf("   8#350 /egrave        8#351 /eacute        8#352 /ecircumflex   8#353 /edieresis\n");
-   printf("   8#354 /igrave        8#355 /iacute        8#356 /icircumflex   8#357 /idieresis\n");
-   printf("   8#360 /eth           8#361 /ntilde        8#362 /ograve        8#363 /oacute\n");
-   printf("   8#364 /ocircumflex   8#365 /otilde        8#366 /odieresis     8#367 /divide\n");
-   printf("   8#370 /oslash        8#371 /ugrave        8#372 /uacute        8#373 /ucircumflex\n");
-   printf("   8#374 /udieresis     8#375 /yacute        8#376 /thorn         8#377 /ydieresis\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_16
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_iso8859_16 (void)
-{
-   printf("%%%%%%   %%\n");
-   printf("%%%%%%   %% ISO 8859-16 (Latin10) character mappings\n");
-   printf("%%%%%%   %% \n");
-   printf("%%%%%%   %% This PostScript encoding vector is currently undefined because the\n");
-   printf("%%%%%%   %% information needed to create it was not found.\n");
-   printf("%%%%%%   %% \n");
-   printf("%%%%%%   /alt_mappings [\n");
-   printf("%%%%%%   ] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_koi8_r
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_koi8_r (void)
-{
-   printf("%%\n");
-   printf("%% KOI8-R (Russian) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector was derived from the information at the following\n");
-   printf("%% website (circa Jan 2005), which covers several character mappings:\n");
-   printf("%%    \n");
-   printf("%%    http://bibliofile.mc.duke.edu/gww/fonts/postscript-utilities/encoding-vectors.html\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#200 /SF100000    8#201 /SF110000       8#202 /SF010000         8#203 /SF030000\n");
-   printf("   8#204 /SF020000    8#205 /SF040000       8#206 /SF080000         8#207 /SF090000\n");
-   printf("   8#210 /SF060000    8#211 /SF070000       8#212 /SF050000         8#213 /upblock\n");
-   printf("   8#214 /dnblock     8#215 /block          8#216 /lfblock          8#217 /rtblock\n");
-   printf("   8#220 /ltshade     8#221 /shade          8#222 /dkshade          8#223 /integraltp\n");
-   printf("   8#224 /filledbox   8#225 /uni2219        8#226 /radical          8#227 /approxequal\n");
-   printf("   8#230 /lessequal   8#231 /greaterequal   8#232 /uni00A0          8#233 /integralbt\n");
-   printf("   8#234 /degree      8#235 /twosuperior    8#236 /periodcentered   8#237 /divide\n");
-   printf("   8#240 /SF430000    8#241 /SF240000       8#242 /SF510000         8#243 /afii10071\n");
-   printf("   8#244 /SF520000    8#245 /SF390000       8#246 /SF220000         8#247 /SF210000\n");
-   printf("   8#250 /SF250000    8#251 /SF500000       8#252 /SF490000         8#253 /SF380000\n");
-   printf("   8#254 /SF280000    8#255 /SF270000       8#256 /SF260000         8#257 /SF360000\n");
-   printf("   8#260 /SF370000    8#261 /SF420000       8#262 /SF190000         8#263 /afii10023\n");
-   printf("   8#264 /SF200000    8#265 /SF230000       8#266 /SF470000         8#267 /SF480000\n");
-   printf("   8#270 /SF410000    8#271 /SF450000       8#272 /SF460000         8#273 /SF400000\n");
-   printf("   8#274 /SF540000    8#275 /SF530000       8#276 /SF440000         8#277 /copyright\n");
-   printf("   8#300 /afii10096   8#301 /afii10065      8#302 /afii10066        8#303 /afii10088\n");
-   printf("   8#304 /afii10069   8#305 /afii10070      8#306 /afii10086        8#307 /afii10068\n");
-   printf("   8#310 /afii10087   8#311 /afii10074      8#312 /afii10075        8#313 /afii10076\n");
-   printf("   8#314 /afii10077   8#315 /afii10078      8#316 /afii10079        8#317 /afii10080\n");
-   printf("   8#320 /afii10081   8#321 /afii10097      8#322 /afii10082        8#323 /afii10083\n");
-   printf("   8#324 /afii10084   8#325 /afii10085      8#326 /afii10072        8#327 /afii10067\n");
-   printf("   8#330 /afii10094   8#331 /afii10093      8#332 /afii10073        8#333 /afii10090\n");
-   printf("   8#334 /afii10095   8#335 /afii10091      8#336 /afii10089        8#337 /afii10092\n");
-   printf("   8#340 /afii10048   8#341 /afii10017      8#342 /afii10018        8#343 /afii10040\n");
-   printf("   8#344 /afii10021   8#345 /afii10022      8#346 /afii10038        8#347 /afii10020\n");
-   printf("   8#350 /afii10039   8#351 /afii10026      8#352 /afii10027        8#353 /afii10028\n");
-   printf("   8#354 /afii10029   8#355 /afii10030      8#356 /afii10031        8#357 /afii10032\n");
-   printf("   8#360 /afii10033   8#361 /afii10049      8#362 /afii10034        8#363 /afii10035\n");
-   printf("   8#364 /afii10036   8#365 /afii10037      8#366 /afii10024        8#367 /afii10019\n");
-   printf("   8#370 /afii10046   8#371 /afii10045      8#372 /afii10025        8#373 /afii10042\n");
-   printf("   8#374 /afii10047   8#375 /afii10043      8#376 /afii10041        8#377 /afii10044\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_iso8859_koi8_u
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_koi8_u (void)
-{
-   printf("%%\n");
-   printf("%% KOI8-U (Ukrainian) character mappings\n");
-   printf("%% \n");
-   printf("%% This PostScript encoding vector came from the Ukrainian language patch\n");
-   printf("%% provided by Volodymyr M. Lisivka <lvm at mystery.lviv.net>.\n");
-   printf("%% \n");
-   printf("/alt_mappings [\n");
-   printf("   8#200 /SF100000    8#201 /SF110000         8#202 /SF010000         8#203 /SF030000\n");
-   printf("   8#204 /SF020000    8#205 /SF040000         8#206 /SF080000         8#207 /SF090000\n");
-   printf("   8#210 /SF060000    8#211 /SF070000         8#212 /SF050000         8#213 /upblock\n");
-   printf("   8#214 /dnblock     8#215 /block            8#216 /lfblock          8#217 /rtblock\n");
-   printf("   8#220 /ltshade     8#221 /shade            8#222 /dkshade          8#223 /integraltp\n");
-   printf("   8#224 /filledbox   8#225 /periodcentered   8#226 /radical          8#227 /approxequal\n");
-   printf("   8#230 /lessequal   8#231 /greaterequal     8#232 /space            8#233 /integralbt\n");
-   printf("   8#234 /degree      8#235 /twosuperior      8#236 /periodcentered   8#237 /divide\n");
-   printf("   8#240 /SF430000    8#241 /SF240000         8#242 /SF510000         8#243 /afii10071\n");
-   printf("   8#244 /afii10101   8#245 /SF390000         8#246 /afii10103        8#247 /afii10104\n");
-   printf("   8#250 /SF250000    8#251 /SF500000         8#252 /SF490000         8#253 /SF380000\n");
-   printf("   8#254 /SF280000    8#255 /afii10098        8#256 /SF260000         8#257 /SF360000\n");
-   printf("   8#260 /SF370000    8#261 /SF420000         8#262 /SF190000         8#263 /afii10023\n");
-   printf("   8#264 /afii10053   8#265 /SF230000         8#266 /afii10055        8#267 /afii10056\n");
-   printf("   8#270 /SF410000    8#271 /SF450000         8#272 /SF460000         8#273 /SF400000\n");
-   printf("   8#274 /SF540000    8#275 /afii10050        8#276 /SF440000         8#277 /copyright\n");
-   printf("   8#300 /afii10096   8#301 /afii10065        8#302 /afii10066        8#303 /afii10088\n");
-   printf("   8#304 /afii10069   8#305 /afii10070        8#306 /afii10086        8#307 /afii10068\n");
-   printf("   8#310 /afii10087   8#311 /afii10074        8#312 /afii10075        8#313 /afii10076\n");
-   printf("   8#314 /afii10077   8#315 /afii10078        8#316 /afii10079        8#317 /afii10080\n");
-   printf("   8#320 /afii10081   8#321 /afii10097        8#322 /afii10082        8#323 /afii10083\n");
-   printf("   8#324 /afii10084   8#325 /afii10085        8#326 /afii10072        8#327 /afii10067\n");
-   printf("   8#330 /afii10094   8#331 /afii10093        8#332 /afii10073        8#333 /afii10090\n");
-   printf("   8#334 /afii10095   8#335 /afii10091        8#336 /afii10089        8#337 /afii10092\n");
-   printf("   8#340 /afii10048   8#341 /afii10017        8#342 /afii10018        8#343 /afii10040\n");
-   printf("   8#344 /afii10021   8#345 /afii10022        8#346 /afii10038        8#347 /afii10020\n");
-   printf("   8#350 /afii10039   8#351 /afii10026        8#352 /afii10027        8#353 /afii10028\n");
-   printf("   8#354 /afii10029   8#355 /afii10030        8#356 /afii10031        8#357 /afii10032\n");
-   printf("   8#360 /afii10033   8#361 /afii10049        8#362 /afii10034        8#363 /afii10035\n");
-   printf("   8#364 /afii10036   8#365 /afii10037        8#366 /afii10024        8#367 /afii10019\n");
-   printf("   8#370 /afii10046   8#371 /afii10045        8#372 /afii10025        8#373 /afii10042\n");
-   printf("   8#374 /afii10047   8#375 /afii10043        8#376 /afii10041        8#377 /afii10044\n");
-   printf("] readonly def\n");
-
-   return;
-}
-
-/* ---------------------------------------------------------------------------
-
-   encvec_roman8
-
-   Notes:
-
-      This routine outputs a particular PostScript encoding vector, used to
-      support any languages which use that encoding.
-
-*/
-void encvec_roman8 (void)
-{
-   printf("%%\n");
-   printf("%% Roman8 character mappings\n");
-   printf("%%\n");
-   printf("/alt_mappings [\n");
-   printf("                        8#241 /Agrave           8#242 /Acircumflex    8#243 /Egrave\n");
-   printf("   8#244 /Ecircumflex   8#245 /Edieresis        8#246 /Icircumflex    8#247 /Idieresis\n");
-   printf("   8#250 /acute         8#251 /grave            8#252 /circumflex     8#253 /dieresis\n");
-   printf("   8#254 /tilde         8#255 /Ugrave           8#256 /Ucircumflex    8#257 /sterling\n");
-   printf("   8#260 /macron        8#261 /Yacute           8#262 /yacute         8#263 /degree\n");
-   printf("   8#264 /Ccedilla      8#265 /ccedilla         8#266 /Ntilde         8#267 /ntilde\n");
-   printf("   8#270 /exclamdown    8#271 /questiondown     8#272 /currency       8#273 /sterling\n");
-   printf("   8#274 /yen           8#275 /section          8#276 /florin         8#277 /cent\n");
-   printf("   8#300 /acircumflex   8#301 /ecircumflex      8#302 /ocircumflex    8#303 /ucircumflex\n");
-   printf("   8#304 /aacute        8#305 /eacute           8#306 /oacute         8#307 /uacute\n");
-   printf("   8#310 /agrave        8#311 /egrave           8#312 /ograve         8#313 /ugrave\n");
-   printf("   8#314 /adieresis     8#315 /edieresis        8#316 /odieresis      8#317 /udieresis\n");
-   printf("   8#320 /Aring         8#321 /icircumflex      8#322 /Oslash         8#323 /AE\n");
-   printf("   8#324 /aring         8#325 /iacute           8#326 /oslash         8#327 /ae\n");
-   printf("   8#330 /Adieresis     8#331 /igrave           8#332 /Odieresis      8#333 /Udieresis\n");
-   printf("   8#334 /Eacute        8#335 /idieresis        8#336 /germandbls     8#337 /Ocircumflex\n");
-   printf("   8#340 /Aacute        8#341 /Atilde           8#342 /atilde         8#343 /Eth\n");
-   printf("   8#344 /eth           8#345 /Iacute           8#346 /Igrave         8#347 /Oacute\n");
-   printf("   8#350 /Ograve        8#351 /Otilde           8#352 /otilde         8#353 /Scaron\n");
-   printf("   8#354 /scaron        8#355 /Uacute           8#356 /Ydieresis      8#357 /ydieresis\n");
-   printf("   8#360 /thorn         8#361 /Thorn            8#362 /dotaccent      8#363 /mu\n");
-   printf("   8#364 /paragraph     8#365 /threequarters    8#366 /hyphen         8#367 /onequarter\n");
-   printf("   8#370 /onehalf       8#371 /ordfeminine      8#372 /ordmasculine   8#373 /guillemotleft\n");
-   printf("   8#374 /bullet        8#375 /guillemotright   8#376 /plusminus      8#377 /.notdef\n");
-   printf("] readonly def\n");
-
-   return;
+   return TRUE;
 }
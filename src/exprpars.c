@@ -61,6 +61,7 @@
 #include <ctype.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "pcaldefs.h"
 #include "protos.h"
@@ -86,6 +87,22 @@ typedef struct {
    OPERAND (*pfcn) (OPERAND *);   /* dispatch function */
 } OPR;
 
+/* compiled expression (cf. compile_expr()); the code is in postfix order,
+   each element being an operator code ('OP_XXX') or an identifier
+   ('EC_IDENT(n)' for the n'th entry of 'ident') */
+typedef struct c_e {
+   struct c_e *next;   /* next entry in same hash bucket */
+   char *text;   /* source text of expression */
+   unsigned long hash;   /* ci_strhash() of text */
+   short *code;   /* postfix code (NULL if 'value' is constant) */
+   int ncode;
+   char **ident;   /* identifier names */
+   int *slot;   /* ... and their symbol table indices (cf. sym_slot()) */
+   int nident;
+   int value;   /* value as of generation 'gen' */
+   unsigned long gen;
+} COMPILED_EXPR;
+
 /* ---------------------------------------------------------------------------
 
    Constant Declarations
@@ -139,6 +156,12 @@ typedef struct {
 /* size of operand and operator stacks */
 #define MAX_OP   20
 
+/* compiled expression codes for identifiers follow the operator codes */
+#define NUM_OPS         4
+#define EC_IDENT(n)     ((n) + NUM_OPS)
+
+#define EXPR_HASH_INIT  32      /* initial size of compiled expression cache */
+
 /* ---------------------------------------------------------------------------
 
    Macro Definitions
@@ -196,6 +219,13 @@ TOKEN token_tbl[] = {
         { NULL, TK_UNKNOWN,     0 }             /* must be last entry */
 };
 
+/* cache of compiled expressions, hashed by source text; cached values are
+   valid as long as 'expr_gen' is unchanged (cf. invalidate_exprs()) */
+static COMPILED_EXPR **expr_tab = NULL;
+static int expr_tab_size = 0;
+static int expr_count = 0;
+static unsigned long expr_gen = 1;
+
 /* ---------------------------------------------------------------------------
 
    External Routine References & Function Prototypes
@@ -288,14 +318,14 @@ static TOKEN * lookup_token (char *p)
 
       This routine fetchs the next token from the input string.
 
-      It fills in its type and value and returns a pointer to the following
-      character.
+      It fills in its type and value (copying identifiers to 'tokbuf') and
+      returns a pointer to the following character.
 
 */
-static char *next_token (char *p, int *ptype, int *pvalue)
+static char *next_token (char *p, int *ptype, int *pvalue, char *tokbuf)
 {
    TOKEN *ptok;
-   char tokbuf[STRSIZ], *pb;
+   char *pb;
    
    while (*p && isspace((int)*p)) p++;   /* skip whitespace */
 
@@ -311,7 +341,7 @@ static char *next_token (char *p, int *ptype, int *pvalue)
       }
       *pb = '\0';
       
-      NT_RETURN(p, TK_IDENT, find_sym_name(tokbuf));
+      NT_RETURN(p, TK_IDENT, 0);
    }
 
    ptok = lookup_token(p);   /* other token */
@@ -320,31 +350,33 @@ static char *next_token (char *p, int *ptype, int *pvalue)
 
 /* ---------------------------------------------------------------------------
 
-   parse_expr
+   compile_expr
 
    Notes:
 
       This routine parses an expression consisting of identifiers and logical
-      operators.
+      operators, compiling it into postfix code in 'pce'; 'tokbuf' must be
+      large enough to hold any identifier in 'pbuf'.
 
-      It returns 'TRUE' if the expression is true (identifier defined =>
-      true), 'FALSE' if false, and 'EXPR_ERR' if there's a syntax error in the
-      expression.
+      It returns 'TRUE' if the expression was compiled, or the constant value
+      of the expression otherwise: 'FALSE' for a null expression and
+      'EXPR_ERR' if there's a syntax error in the expression.
 
 */
-int parse_expr (char *pbuf)
+static int compile_expr (char *pbuf, COMPILED_EXPR *pce, char *tokbuf)
 {
-   OPERAND opd_stack[MAX_OP];   /* operand stack - TRUE/FALSE values */
    OPERATOR opr_stack[MAX_OP];   /* operator stack - precedence | op */
-   int value, token, plevel, prec, result, npop, opr, opd, prev_token, op;
+   short code[MAX_OP * 4];   /* postfix code */
+   int value, token, plevel, prec, npop, opr, opd, prev_token, op, ncode;
+   int i, len;
    
    plevel = 0;   /* paren nesting level */
    opd = opr = -1;   /* indices of stack tops */
+   ncode = 0;
    prev_token = TK_STARTINPUT;   /* to detect null expressions */
    
-   if (DEBUG(DEBUG_PP)) fprintf(stderr, "evaluating expression '%s'\n", pbuf);
    do {
-      pbuf = next_token(pbuf, &token, &value);
+      pbuf = next_token(pbuf, &token, &value, tokbuf);
       
       /* check that the current token may follow the previous one */
       if (! IS_LEGAL(token, prev_token)) return EXPR_ERR;
@@ -352,7 +384,23 @@ int parse_expr (char *pbuf)
       switch(token) {
          
       case TK_IDENT:   /* identifier => 1 if def, 0 if not */
-         opd_stack[++opd] = value != PP_SYM_UNDEF;
+         if (++opd >= MAX_OP || ncode == sizeof(code)/sizeof(code[0])) return EXPR_ERR;
+
+         /* add to this expression's identifiers (once only) */
+         for (i = 0; i < pce->nident && ci_strcmp(pce->ident[i], tokbuf); i++)
+            ;
+         if (i == pce->nident) {
+            if (i % MAX_OP == 0) {
+               pce->ident = (char **) realloc(pce->ident, (i + MAX_OP) * sizeof(char *));
+               if (pce->ident == NULL) {
+                  fprintf(stderr, E_ALLOC_ERR, progname);
+                  exit(EXIT_FAILURE);
+               }
+            }
+            strcpy(pce->ident[i] = alloc(strlen(tokbuf) + 1), tokbuf);
+            pce->nident++;
+         }
+         code[ncode++] = EC_IDENT(i);
          break;
          
       case TK_LPAREN:   /* left paren - bump nesting level */
@@ -376,11 +424,10 @@ int parse_expr (char *pbuf)
           */
          prec = token == TK_ENDINPUT ? ENDINPUT_PREC : (plevel * PAREN_PREC) + opr_tbl[value].prec;
          
-         /* pop (and perform) any equal- or higher-precedence
-          * operators on operator stack: extract operator,
-          * check for operand stack underflow, execute
-          * operator, adjust operand stack height and place
-          * result of operator on top
+         /* pop (and emit) any equal- or higher-precedence operators on
+          * operator stack: extract operator, check for operand stack
+          * underflow, and adjust operand stack height to reflect the
+          * result of operator
           */
          
          for ( ;
@@ -388,14 +435,17 @@ int parse_expr (char *pbuf)
                opr--) {
             op = OPCODE(opr_stack[opr]);
             npop = opr_tbl[op].type == TK_UNARYOP ? 0 : 1;
-            if (opd < npop) return EXPR_ERR;
-            result = (*opr_tbl[op].pfcn)(opd_stack + opd);
-            opd_stack[opd -= npop] = result;
+            if (opd < npop || ncode == sizeof(code)/sizeof(code[0])) return EXPR_ERR;
+            code[ncode++] = op;
+            opd -= npop;
          }
 
          /* push operator (if any) onto stack */
          
-         if (token != TK_ENDINPUT) opr_stack[++opr] = MAKE_OPR(prec, value);
+         if (token != TK_ENDINPUT) {
+            if (++opr >= MAX_OP) return EXPR_ERR;
+            opr_stack[opr] = MAKE_OPR(prec, value);
+         }
 
          break;
          
@@ -410,11 +460,172 @@ int parse_expr (char *pbuf)
    
    /* done - check for dangling parens, and leftover operand/operators */
    
-   if (DEBUG(DEBUG_PP)) {
-      fprintf(stderr, "evaluated to %s\n", opd_stack[0] ? "TRUE" : "FALSE");
+   if (plevel != 0 || opd != 0 || opr != -1) return EXPR_ERR;
+
+   len = ncode * sizeof(short);
+   memcpy(pce->code = (short *) alloc(len), code, len);
+   pce->ncode = ncode;
+   if (pce->nident) pce->slot = (int *) alloc(pce->nident * sizeof(int));
+   for (i = 0; i < pce->nident; i++) pce->slot[i] = sym_slot(pce->ident[i]);
+
+   return TRUE;
+}
+
+/* ---------------------------------------------------------------------------
+
+   find_expr
+
+   Notes:
+
+      This routine returns the cached compiled expression for 'pbuf',
+      compiling and caching it first if necessary.
+
+*/
+static COMPILED_EXPR *find_expr (char *pbuf)
+{
+   COMPILED_EXPR *pce, **pnew;
+   char *tokbuf;
+   unsigned long h;
+   int i, n;
+
+   h = ci_strhash(pbuf);
+   if (expr_tab) {
+      for (pce = expr_tab[h & (expr_tab_size - 1)]; pce; pce = pce->next) {
+         if (pce->hash == h && ci_strcmp(pce->text, pbuf) == 0) return pce;
+      }
+   }
+
+   /* not found - grow the table if it's getting full ... */
+   if (expr_count >= expr_tab_size) {
+      n = expr_tab_size ? 2 * expr_tab_size : EXPR_HASH_INIT;
+      if ((pnew = (COMPILED_EXPR **) calloc(n, sizeof(COMPILED_EXPR *))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+      for (i = 0; i < expr_tab_size; i++) {
+         while ((pce = expr_tab[i]) != NULL) {
+            expr_tab[i] = pce->next;
+            pce->next = pnew[pce->hash & (n - 1)];
+            pnew[pce->hash & (n - 1)] = pce;
+         }
+      }
+      if (expr_tab) free(expr_tab);
+      expr_tab = pnew;
+      expr_tab_size = n;
+   }
+
+   /* ... then compile the expression and add it */
+   pce = (COMPILED_EXPR *) alloc(sizeof(COMPILED_EXPR));
+   memset(pce, 0, sizeof(COMPILED_EXPR));
+   strcpy(pce->text = alloc(strlen(pbuf) + 1), pbuf);
+   pce->hash = h;
+   tokbuf = alloc(strlen(pbuf) + 1);   /* no identifier is longer */
+   pce->value = compile_expr(pbuf, pce, tokbuf);
+   free(tokbuf);
+
+   pce->next = expr_tab[h & (expr_tab_size - 1)];
+   expr_tab[h & (expr_tab_size - 1)] = pce;
+   expr_count++;
+
+   return pce;
+}
+
+/* ---------------------------------------------------------------------------
+
+   invalidate_exprs
+
+   Notes:
+
+      This routine invalidates the cached values of all compiled expressions.
+      It must be called whenever a symbol is defined or undefined.
+
+*/
+void invalidate_exprs (void)
+{
+   expr_gen++;
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   clear_exprs
+
+   Notes:
+
+      This routine clears and deallocates the compiled expression cache.
+
+*/
+void clear_exprs (void)
+{
+   COMPILED_EXPR *pce;
+   int i, j;
+
+   for (i = 0; i < expr_tab_size; i++) {
+      while ((pce = expr_tab[i]) != NULL) {
+         expr_tab[i] = pce->next;
+         for (j = 0; j < pce->nident; j++) free(pce->ident[j]);
+         if (pce->ident) free(pce->ident);
+         if (pce->slot) free(pce->slot);
+         if (pce->code) free(pce->code);
+         free(pce->text);
+         free(pce);
+      }
+   }
+
+   if (expr_tab) free(expr_tab);
+   expr_tab = NULL;
+   expr_tab_size = expr_count = 0;
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   parse_expr
+
+   Notes:
+
+      This routine evaluates an expression consisting of identifiers and
+      logical operators.
+
+      It returns 'TRUE' if the expression is true (identifier defined =>
+      true), 'FALSE' if false, and 'EXPR_ERR' if there's a syntax error in the
+      expression.
+
+      Expressions are compiled once (cf. compile_expr()), with their
+      identifiers resolved to symbol table slots, and their values are
+      cached until the set of defined symbols changes.
+
+*/
+int parse_expr (char *pbuf)
+{
+   OPERAND opd_stack[MAX_OP];   /* operand stack - TRUE/FALSE values */
+   COMPILED_EXPR *pce;
+   int i, opd, op, npop, result;
+   
+   if (DEBUG(DEBUG_PP)) fprintf(stderr, "evaluating expression '%s'\n", pbuf);
+
+   pce = find_expr(pbuf);
+
+   if (pce->code && pce->gen != expr_gen) {
+      for (opd = -1, i = 0; i < pce->ncode; i++) {
+         if ((op = pce->code[i]) >= NUM_OPS) {
+            opd_stack[++opd] = sym_defined(pce->slot[op - NUM_OPS]);
+         }
+         else {
+            npop = opr_tbl[op].type == TK_UNARYOP ? 0 : 1;
+            result = (*opr_tbl[op].pfcn)(opd_stack + opd);
+            opd_stack[opd -= npop] = result;
+         }
+      }
+
+      pce->value = opd_stack[0];
+      pce->gen = expr_gen;
+   }
+
+   if (DEBUG(DEBUG_PP) && pce->code) {
+      fprintf(stderr, "evaluated to %s\n", pce->value ? "TRUE" : "FALSE");
    }
 
-   return plevel != 0 || opd != 0 || opr != -1 ? 
-      EXPR_ERR :   /* leftover junk - return error */
-      opd_stack[0];   /* all OK - return final value */
+   return pce->value;
 }
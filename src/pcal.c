@@ -389,7 +389,7 @@ static int oflag = FALSE;   /* -o flag specified */
  */
 
 year_info *head = NULL;   /* head of internal data structure */
-int curr_year;   /* current default year for date file entries */
+THREAD_LOCAL int curr_year;   /* current default year for date file entries */
 int init_month;   /* starting month */
 int init_year;   /* starting year */
 int nmonths;   /* number of months */
@@ -399,8 +399,10 @@ double xsval_pgm;   /* X scaling value calculated by program */
 double ysval_pgm;   /* Y scaling value calculated by program*/
 int xtval_pgm;   /* X translation value calculated by program */
 int ytval_pgm;   /* Y translation value calculated by program */
-char *words[MAXWORD];   /* maximum number of words per date file line */
-char lbuf[LINSIZ];   /* date file source line buffer */
+char **words = NULL;   /* words of date file line (cf. loadwords()) */
+int max_words = 0;
+char *lbuf = NULL;   /* date file source line buffer (cf. grow_buf()) */
+int lbuf_size = 0;
 char progname[STRSIZ];   /* program name (for error messages) */
 char progpath[STRSIZ];   /* directory where executable lives */
 char version[20];   /* program version (for info messages) */
@@ -466,6 +468,8 @@ int one_column = 0;   /* -q */
 
 int blank_boxes = BLANK_BOXES;   /* -B */
 
+int compress_ps = COMPRESS_PS;   /* -Q */
+
 int ncopy = NCOPY;   /* -# */
 
 int small_cal_pos = SMALL_CAL_POS;   /* -k, -K, -S */
@@ -507,6 +511,7 @@ KWD_F pp_info[] = {
    { "ifndef",	PP_IFNDEF,	do_ifndef },
    { "if",	PP_IFDEF,	do_ifdef },   /* "ifdef" synonym */
    { "include",	PP_INCLUDE,	NULL },   /* do_include */
+   { "once",	PP_ONCE,	NULL },
    { "undef",	PP_UNDEF,	do_undef },
    { NULL,	PP_OTHER,	NULL }   /* must be last */
 };
@@ -707,6 +712,8 @@ FLAG_USAGE flag_tbl[] = {
 
 	{ F_BLANK_BOXES, FALSE,		 P_ENV		| P_OPT | P_CMD2 },
 
+	{ F_COMPRESS,	FALSE,		 P_ENV		| P_OPT | P_CMD2 },
+
 	{ F_NUM_PAGES,	TRUE,		 P_ENV		| P_OPT | P_CMD2 },
 
 	{ F_SC_NONE,	FALSE,		 P_ENV | P_CMD1 | P_OPT		 },
@@ -736,6 +743,7 @@ FLAG_USAGE flag_tbl[] = {
 /* subflags for debug info flag F_DEBUG */
 
 DEBUG_INFO debug_info[] = {
+   { D_ALLOC,		DEBUG_ALLOC },
    { D_DATES,		DEBUG_DATES },
    { D_FILE_PATHS,	DEBUG_PATHS },
    { D_MOON,		DEBUG_MOON },
@@ -919,6 +927,13 @@ FLAG_MSG flag_msg[] = {
 #endif
 	{ END_GROUP },
 
+#if COMPRESS_PS == FALSE
+	{ F_COMPRESS,	NULL,		"compress PostScript output (requires Level 2)",	NULL },
+#else
+	{ F_COMPRESS,	NULL,		"generate uncompressed PostScript output",		NULL },
+#endif
+	{ END_GROUP },
+
 	{ F_NUM_PAGES,	W_N,		"print <n> copies of each output page",			Ncopy },
 	{ END_GROUP },
 
@@ -1502,6 +1517,7 @@ int get_args (char **argv, int  curr_pass, char *where, int  get_numargs)
          draw_moons    = DRAW_MOONS;
          do_whole_year = DO_WHOLE_YEAR;
          blank_boxes   = BLANK_BOXES;
+         compress_ps   = COMPRESS_PS;
          output_type   = OUTPUT_TYPE;
          small_cal_pos = SMALL_CAL_POS;
 
@@ -1535,7 +1551,7 @@ int get_args (char **argv, int  curr_pass, char *where, int  get_numargs)
          }
          
          /* split new command line into words; parse it */
-         (void) loadwords(words, lbuf);
+         (void) loadwords(&words, &max_words, lbuf);
          (void) get_args(words, curr_pass, NULL, FALSE);
          
          /* -G and -O without arguments change some day colors (for
@@ -1823,6 +1839,10 @@ int get_args (char **argv, int  curr_pass, char *where, int  get_numargs)
          blank_boxes = !(BLANK_BOXES);
          break;
          
+      case F_COMPRESS:   /* compress PostScript output */
+         compress_ps = !(COMPRESS_PS);
+         break;
+         
       case F_NUM_PAGES:   /* print multiple copies of each page */
          ncopy = parg ? atoi(parg) : NCOPY;
          break;
@@ -2118,6 +2138,7 @@ char *gen_lang_sym (int lang)
      
            d) main() calls read_datefile() to read and parse the date file; it
               in turn calls get_args() once per "opt" line in the date file
+              (also when the result is loaded from the PCAL_CACHE file)
      
            e) to parse the command line one final time, allowing the user to
               override any flags other than those listed in c) above
@@ -2143,6 +2164,8 @@ int main (int argc GCC_UNUSED, char **argv)
    *strchr(p, ' ') = '\0';   /* terminate after version */
    strcpy(version, p);
    
+   grow_buf(&lbuf, &lbuf_size, LINSIZ);   /* line buffer */
+
    init_misc();   /* handle initialization warts */
    
    /* extract root program name and program path - note that some systems
@@ -2179,9 +2202,10 @@ int main (int argc GCC_UNUSED, char **argv)
    /* parse environment variable PCAL_OPTS as a command line */
    
    if ((p = getenv(PCAL_OPTS)) != NULL) {
+      grow_buf(&lbuf, &lbuf_size, (int) strlen(p) + 6);
       strcpy(lbuf, "pcal ");   /* dummy program name */
       strcat(lbuf, p);
-      (void) loadwords(words, lbuf);   /* split string into words */
+      (void) loadwords(&words, &max_words, lbuf);   /* split string into words */
       if (! get_args(words, P_ENV, PCAL_OPTS, FALSE)) {
          display_usage(stderr, FALSE);
          exit(EXIT_FAILURE);
@@ -2294,8 +2318,8 @@ int main (int argc GCC_UNUSED, char **argv)
    if (!oflag && output_type == OUTPUT_PS) strcpy(outfile, PS_OUTFILE);
    if (!oflag && output_type == OUTPUT_HTML) strcpy(outfile, HTML_OUTFILE);
    
-   /* reopen stdout as alternate file if one was specified */
-   if (*outfile && freopen(outfile, "w", stdout) == (FILE *) NULL) {
+   /* direct the output to the alternate file if one was specified */
+   if (!out_open(outfile)) {
       fprintf(stderr, E_FOPEN_ERR, progname, outfile);
       exit(EXIT_FAILURE);
    }
@@ -275,53 +275,74 @@ typedef struct {
 } paper_info_str_typ;
 
 /*
- * The internal data structure consists of a series of linked lists as 
- * pictured below (for clarity, only one instance of each node is shown):
+ * The internal data structure consists of a linked list of years, each
+ * pointing to a compact array of text entries per month, as pictured below
+ * (for clarity, only one instance of each node is shown):
  *
  *
  * head
  *  |
  *  |        year_info
  *  |    -----------------           month_info
- *   -->| year            |       -----------------            day_info
- *      | month_info*[0]  |----->| holidays        |       ----------------
- *      |   ...           |      | day_info*[0]    |----->| is_holiday     |
- *      | month_info*[11] |--->  |   ...           |      | text_string*   |--->
- *      | next year_info* |--    | day_info*[30]   |--->  | next day_info* |-- 
- *       -----------------   |   | day_info*[NOTE] |--->   ----------------   |
- *                           |   |   ...           |                          |
- *                           |    -----------------                           |
- *             ...        <--                                     ...      <--
+ *   -->| year            |       -----------------         day_info[]
+ *      | month_info*[0]  |----->| holidays        |       --------------
+ *      |   ...           |      | day_info*       |----->| day 0 text   |
+ *      | month_info*[11] |--->  | first[0]        |      |   ...        |
+ *      | next year_info* |--    |   ...           |      | day 1 text   |
+ *       -----------------   |   | first[NOTE+1]   |      |   ...        |
+ *                           |    -----------------        --------------
+ *             ...        <--
  *
  * 
  * Each year_info node consists of the year, 12 pointers (Jan .. Dec) to
  * month_info nodes, and a pointer to the next year_info node in the chain.
  * (The year_info chain is maintained in ascending order by year.)
  *
- * Each month_info node consists of a bitmap of the holidays for that month, 
- * a pointer to the day_info chain for all 31 possible days of the month, and
- * N additional pointers to the day_info chains for the "Notes" pseudo-days. 
- * (A day_info chain is a linked list of all the text entries for a given
- * day, in the order in which they were encountered in the date file.)
+ * Each month_info node consists of a bitmap of the holidays for that month
+ * and an array of day_info entries for all 31 possible days of the month
+ * plus N "Notes" pseudo-days.  Once sorted (cf. find_month_info()), the
+ * entries for day subscript d are event[first[d]] .. event[first[d+1]-1],
+ * in the order in which they were encountered in the date file; use the
+ * FIRST_DAY_INFO() and END_DAY_INFO() macros to walk them.
  *
- * Each day_info node consists of a flag indicating whether the associated
- * text string is holiday or non-holiday text (any given day may have both),
- * a pointer to the text string itself, and a pointer to the next day_info 
- * node in the chain.
+ * Each day_info entry consists of a pointer to the (shared) text string, a
+ * flag indicating whether it is holiday or non-holiday text (any given day
+ * may have both), and its day subscript.
+ *
+ * While the date file is read, new entries are simply appended to the
+ * array (and deleted ones flagged); each month_info node also keeps a hash
+ * table of its entries, keyed on the day and the case-folded text, so that
+ * duplicate detection and deletion are independent of the number of
+ * entries (cf. enter_day_info()), plus per-day entry counts.
  *
  */
 
 typedef struct d_i {
-   int is_holiday;
    char *text;
-   struct d_i *next;
+   unsigned long hash;   /* ci_strhash() of text */
+   int hnext;   /* next entry in same hash bucket (-1 if none) */
+   unsigned char day;   /* day subscript (0 .. LAST_NOTE_DAY-1) */
+   unsigned char is_holiday;
+   unsigned char deleted;   /* removed by delete_day_info() */
 } day_info;
 
 typedef struct m_i {
    unsigned long holidays;
-   day_info *day[LAST_NOTE_DAY];   /* including extra days for notes */
+   day_info *event;   /* entries (sorted by day unless 'unsorted') */
+   int nevents;   /* entries in use (including deleted ones) */
+   int max_events;   /* entries allocated */
+   int unsorted;   /* entries added or deleted since last sort? */
+   int first[LAST_NOTE_DAY + 1];   /* index of first entry for each day */
+   int ntext[LAST_NOTE_DAY];   /* live entries for each day */
+   int nholidays[LAST_NOTE_DAY];   /* live holiday entries for each day */
+   int *hash_tab;   /* entries hashed by day and text (-1 if empty) */
+   int hash_size;   /* number of buckets (a power of 2) */
 } month_info;
 
+/* walk the entries for day subscript _d of sorted month _pm */
+#define FIRST_DAY_INFO(_pm, _d)   ((_pm)->event + (_pm)->first[_d])
+#define END_DAY_INFO(_pm, _d)     ((_pm)->event + (_pm)->first[(_d) + 1])
+
 typedef struct y_i {
    int year;
    month_info *month[12];
@@ -337,6 +358,37 @@ typedef struct {
    int yy;
 } date_str;
 
+/*
+ * Global typedef declaration for a compiled date specification (cf.
+ * parse_date(), eval_date()).  An event line's date specification is parsed
+ * once into one or more of these nodes, which are then evaluated for each
+ * applicable year.  Relative dates and redefined predefined events refer to
+ * the node of their base date by index (nodes live in a growable pool).
+ */
+typedef struct {
+   int kind;   /* RULE_xxx code */
+   int mm, dd, yy;   /* explicit month, day, and year (0 if none) */
+   int ord, val;   /* ordinal code and value */
+   int wkd;   /* weekday or wildcard */
+   int mon;   /* month, ALL_MONTHS, or ENTIRE_YEAR */
+   int prep;   /* preposition code for relative dates */
+   int (*pfcn)(date_str *);   /* predefined event dispatch function */
+   int base;   /* index of base date rule (or NO_RULE) */
+} event_rule;
+
+/*
+ * Global typedef declaration for a span event ("<date> thru <date> text"):
+ * the entry is stored once with the serial day numbers of its first and
+ * last days and is resolved for each day by the output routines (cf.
+ * enter_span_info(), find_span_info()).
+ */
+typedef struct {
+   long first, last;   /* serial day numbers (inclusive) */
+   char *text;   /* shared text (cf. intern_text()) */
+   int is_holiday;
+   int deleted;   /* removed by "delete" (cf. enter_span_info()) */
+} span_info;
+
 /*
  * Global typedef declarations for keyword descriptors (cf. pcallang.h)
  */
@@ -477,6 +529,8 @@ typedef char *DATE_MSG;   /* date file syntax message */
 
 #define ALL	"all"		/* command-line or date file keywords */
 #define HOLIDAY	"holiday"
+#define THRU	"thru"		/* date file span separators */
+#define THROUGH	"through"
 
 /* names of colors used in printing dates (cf. flag_msg[] below) */
 
@@ -527,6 +581,8 @@ typedef char *DATE_MSG;   /* date file syntax message */
 
 #define PCAL_OPTS	"PCAL_OPTS"	/* command-line flags */
 #define PCAL_DIR	"PCAL_DIR"	/* calendar file directory */
+#define PCAL_CACHE	"PCAL_CACHE"	/* parsed date file cache */
+#define PCAL_THREADS	"PCAL_THREADS"	/* threads expanding event dates */
 #define PATH_ENV_VAR	"PATH"		/* cf. find_executable() (pcalutil.c) */
 
 /*
@@ -543,6 +599,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define DEBUG_OPTS	(1 << 4)
 #define DEBUG_PP	(1 << 5)
 #define DEBUG_TEXT	(1 << 6)
+#define DEBUG_ALLOC	(1 << 7)
 
 /* preprocessor token codes - cf. get_token(), pcallang.h */
 #define PP_DEFINE	 0
@@ -553,6 +610,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define PP_IFNDEF	 5
 #define PP_INCLUDE	 6
 #define PP_UNDEF	 7
+#define PP_ONCE		 8
 #define PP_OTHER	-1	/* not pp token */
 
 /* ordinal number codes - cf. get_ordinal(), pcallang.h */
@@ -606,6 +664,14 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define PR_ON		  7
 #define PR_OTHER	 -1	/* not a preposition */
 
+/* compiled date specification codes - cf. parse_date(), eval_date() */
+#define RULE_DATE	  0	/* single date, optionally with year */
+#define RULE_ALL_MONTHS	  1	/* same day in every month */
+#define RULE_ORDINAL	  2	/* <ordinal> <weekday> in <month> */
+#define RULE_RELATIVE	  3	/* <weekday> <prep> <date> */
+#define RULE_PREDEF	  4	/* predefined event */
+#define NO_RULE		 -1	/* null rule index */
+
 /*
  * Miscellaneous other constants:
  */
@@ -622,14 +688,31 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define MAX_FILE_NESTING 10	/* maximum nesting level for file inclusion */
 #define MAX_IF_NESTING	20	/* maximum nesting level for if{n}def */
 
-#define MAX_PP_SYMS	100	/* number of definable preprocessor symbols */
+#define PP_HASH_INIT	64	/* initial size of preprocessor symbol table */
 #define PP_SYM_UNDEF     -1	/* flag for undefined symbol */
 
 #define EXPR_ERR	-1	/* expression parsing error */
 
+/* date file cache (cf. read_cache()); change CACHE_VERSION whenever the
+   layout of the file or the data structure changes */
+#define CACHE_MAGIC	"pcal date file cache\n"
+#define CACHE_VERSION	2
+#define FNV_BASIS	2166136261UL	/* initial FNV-1a hash (cf. hash_bytes()) */
+
 #define MIN_YR		1753	/* significant years (calendar limits) */
 #define MAX_YR		9999
 
+/* relative dates within MIN_YR..MAX_YR are found with per-year jump tables
+   (cf. wild_search()), the JUMP_TABLES most recently used of which are
+   kept; the day-by-day search for those outside that range gives up after
+   MAX_SEARCH_DAYS days (about ten years) and reports no match (cf.
+   eval_rel()) */
+#define JUMP_TABLES	32
+#define MAX_SEARCH_DAYS	3660
+
+#define WORD_BITS	((int) (8 * sizeof(unsigned long)))
+#define DAY_WORDS	((366 + WORD_BITS - 1) / WORD_BITS)	/* size of day-of-year bitmaps */
+
 #define ALL_YEARS	-1	/* wildcard for years */
 #define TM_YEAR	1900		/* offset for tm_year field of struct tm  */
 				/* (cf. <time.h>); may need to be changed */
@@ -713,12 +796,18 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define HOLIDAY_TEXT	1
 #define NOTE_TEXT	2
 
-#define MAX_DATES	366	/* maximum "wildcard" dates */
+#define DATES_INIT	400	/* initial size of candidate date list */
+#define PREDEF_MAX_DATES	8	/* max. dates added by a predefined event */
+
+#define MAX_THREADS	16	/* max. threads expanding event dates */
+#define MIN_PAR_DATES	64	/* fewer (event, year) pairs are expanded
+				   without starting threads */
+#define PAR_BATCH	16	/* (event, year) pairs claimed at a time */
 
-#define MAXWORD		300	/* maximum words in date file line */
+#define WORDS_INIT	64	/* initial size of date file word list */
 #define STRSIZ		200	/* size of misc. strings */
 #define VALSIZ		12	/* size of numeric value strings */
-#define LINSIZ		512	/* size of source line buffer */
+#define LINSIZ		512	/* initial size of line buffers (cf. grow_buf()) */
 
 #define MAXARGS		3	/* numeric command-line args */
 
@@ -744,6 +833,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #else
 #define PS_RELEASE   "PS-Adobe-1.0"
 #endif
+#define PS_RELEASE_L2   "PS-Adobe-3.0"   /* -Q (for "%%LanguageLevel") */
 
 #define PCAL_WEBSITE   "http://pcal.sourceforge.net"
 
@@ -870,6 +960,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 
 #define DO_WHOLE_YEAR	FALSE		/* -w default */
 #define BLANK_BOXES	FALSE		/* -B default */
+#define COMPRESS_PS	FALSE		/* -Q default */
 
 #define OUTPUT_PS	0		/* output PostScript */
 #define OUTPUT_CAL	1		/* -c: output Un*x calendar(1) input */
@@ -985,6 +1076,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define F_EMPTY_CAL	'e'		/* print empty calendar */
 #define F_DATE_FILE	'f'		/* select alternate date file */
 #define F_OUT_FILE	'o'		/* select alternate output file */
+#define F_COMPRESS	'Q'		/* compress PostScript output */
 
 #define F_LANDSCAPE	'l'		/* landscape mode */
 #define F_PORTRAIT	'p'		/* portrait mode */
@@ -1056,6 +1148,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define D_TEXT		'T'		/* debug dates/text as written */
 #define D_OPT		'O'		/* debug option flags */
 #define D_PREPROCESSOR	'P'		/* debug "preprocessor" operation */
+#define D_ALLOC		'A'		/* debug memory arena usage */
 
 
 
@@ -1124,12 +1217,12 @@ typedef char *DATE_MSG;   /* date file syntax message */
 /* program error messages */
 #define	E_ALLOC_ERR	"%s: calloc() failed - out of memory\n"
 #define	E_FOPEN_ERR	"%s: can't open file %s\n"
+#define	E_WRITE_ERR	"%s: error writing output\n"
 #define	E_ILL_LINE	"%s: %s in file %s, line %d\n"
 #define	E_ILL_MONTH	"%s: month %d not in range %d .. %d\n"
 #define	E_ILL_OPT	"%s: unrecognized flag %s"
 #define E_ILL_OPT2	" (%s\"%s\")"
 #define	E_ILL_YEAR	"%s: year %d not in range %d .. %d\n"
-#define	E_SYMFULL	"%s: symbol table full - can't define %s\n"
 #define	E_UNT_IFDEF	"%s: unterminated if{n}def..{else..}endif in file %s\n"
 #define E_FLAG_IGNORED	"%s: -%c flag ignored (%s\"%s\")\n"
 #define	E_ILL_PAPERSIZE	"%s: unrecognized paper size '%s'\n"
@@ -1139,8 +1232,11 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define E_ELIF_ERR	"unmatched \"elif\""
 #define E_END_ERR	"unmatched \"endif\""
 #define E_GARBAGE	"extraneous data on \"%s\" line"
+#define E_ONCE_ERR	"\"once\" outside an included file"
 #define E_INV_DATE	"invalid date"
 #define E_NO_MATCH	"no match for wildcard"
+#define E_INV_SPAN	"span endpoint matches more than one date"
+#define E_SPAN_ORDER	"span ends before it starts"
 #define E_INV_LINE	"unrecognized line"
 #define E_FILE_NESTING	"maximum file nesting level exceeded"
 #define E_IF_NESTING	"maximum \"if{n}def\" nesting level exceeded"
@@ -1179,6 +1275,34 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define GCC_UNUSED
 #endif
 
+/* 
+   Define a 'convenience' macro to declare the variables which hold the
+   state of a date evaluation (cf. eval_date()) as thread-local, so that
+   several threads can expand event dates at once (cf. expand_events() in
+   readfile.c).  This requires POSIX threads, which are enabled by the
+   'USE_PTHREADS' flag (cf. Makefile); otherwise, events are expanded one at
+   a time.
+ */
+#ifdef USE_PTHREADS
+#define THREAD_LOCAL  __thread
+#else
+#define THREAD_LOCAL
+#endif
+
+/* 
+   Define 'convenience' macros to count the set bits of an unsigned long and
+   to find the lowest set bit (which must exist) of an unsigned long.  These
+   use the GNU C compiler's built-in functions where available and fall back
+   to portable routines (cf. pcalutil.c) elsewhere.
+ */
+#if defined (BUILD_ENV_UNIX) || defined (BUILD_ENV_DJGPP)
+#define BIT_COUNT(w)   __builtin_popcountl(w)
+#define LOW_BIT(w)     __builtin_ctzl(w)
+#else
+#define BIT_COUNT(w)   bit_count(w)
+#define LOW_BIT(w)     low_bit(w)
+#endif
+
 /* write character _c to file _fp; print as octal escape if _fc(_c) is FALSE */
 #define PUTCHAR(_fc, _c, _fp) \
    fprintf((_fp), (_c) == ' ' || _fc((_c) & CHAR_MSK) ? "%c" : "\\%03o" , (_c) & CHAR_MSK)
@@ -1186,9 +1310,27 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define PUTSTR(_fc, _s, _fp) \
    do { char *_p; for (_p = (_s); *_p; _p++) PUTCHAR(_fc, *_p, _fp); } while (0)
 
+/* as above, but write to the calendar output (cf. out_mem()) */
+#define OUT_PUTCHAR(_fc, _c) \
+   do { int _ch = (_c) & CHAR_MSK; \
+      if (_ch == ' ' || _fc(_ch)) out_char(_ch); \
+      else out_printf("\\%03o", _ch); } while (0)
+
+#define OUT_PUTSTR(_fc, _s) \
+   do { char *_p; for (_p = (_s); *_p; _p++) OUT_PUTCHAR(_fc, *_p); } while (0)
+
+/* append string literal (or constant character array) _s to the calendar
+   output */
+#define OUT_LIT(_s)   out_mem((_s), sizeof(_s) - 1)
+
 #define IS_LEAP(y)   ((y) % 4 == 0 && ((y) % 100 != 0 || (y) % 400 == 0))
 #define LENGTH_OF(m, y) (month_len[(m)-1] + ((m) == FEB && IS_LEAP(y)))
 #define YEAR_LEN(y)   (IS_LEAP(y) ? 366 : 365)
+
+/* days in the Gregorian leap year cycles (cf. serial_to_date()) */
+#define DAYS_IN_4_YRS     1461L
+#define DAYS_IN_100_YRS   36524L
+#define DAYS_IN_400_YRS   146097L
 #define DAY_OF_YEAR(m, d, y) ((month_off[(m)-1] + ((m) > FEB && IS_LEAP(y))) + d)
 #define OFFSET_OF(m, y) ((month_off[(m)-1] + ((m) > FEB && IS_LEAP(y))) % 7)
 #define FIRST_OF(m, y)   calc_weekday(m, 1, y)
@@ -1218,8 +1360,13 @@ typedef char *DATE_MSG;   /* date file syntax message */
 #define MAKE_DATE(dt, m, d, y) \
    do { (dt).mm = m; (dt).dd = d; (dt).yy = y; } while (0)
 
+/* (events still awaiting expansion are entered first, so that messages
+   appear in order of the date file lines - cf. expand_events()) */
 #define ERR(errmsg) \
-   fprintf(stderr, E_ILL_LINE, progname, errmsg, filename, line);
+   do { \
+      expand_events(); \
+      fprintf(stderr, E_ILL_LINE, progname, errmsg, filename, line); \
+   } while (0)
 
 #define DEBUG(f)   ((debug_flags & f) != 0)
 
@@ -1240,7 +1387,7 @@ typedef char *DATE_MSG;   /* date file syntax message */
 */
 
 extern year_info *head;
-extern int curr_year;
+extern THREAD_LOCAL int curr_year;
 extern int init_month;
 extern int init_year;
 extern int nmonths;
@@ -1250,8 +1397,10 @@ extern double xsval_pgm;
 extern double ysval_pgm;
 extern int xtval_pgm;
 extern int ytval_pgm;
-extern char *words[];
-extern char lbuf[];
+extern char **words;
+extern int max_words;
+extern char *lbuf;
+extern int lbuf_size;
 extern char progname[];
 extern char progpath[];
 extern char version[];
@@ -1308,6 +1457,8 @@ extern int one_column;
 
 extern int blank_boxes;
 
+extern int compress_ps;
+
 extern int ncopy;
 
 extern int small_cal_pos;
@@ -153,6 +153,7 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <string.h>
+#include <stdarg.h>
 #include <time.h>
 
 #include "pcaldefs.h"
@@ -164,6 +165,10 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 /* X_OK is a #define'd constant used by access() to determine whether or not
@@ -188,12 +193,68 @@
 
 */
 
+/* chunk of the memory arena (cf. arena_alloc()) */
+typedef struct a_c {
+   struct a_c *next;   /* next chunk in chain */
+   size_t size;   /* usable bytes following this header */
+   size_t used;   /* bytes handed out so far */
+} arena_chunk;
+
+/* input buffer for a date file being read by get_pcal_line(): the whole
+   file if it could be mapped into memory, otherwise a window onto it which
+   is refilled by large block reads */
+typedef struct {
+   FILE *fp;   /* file being read (NULL if slot is free) */
+   char *buf;   /* buffered data ... */
+   size_t pos, len;   /* ... next unread byte and end of data */
+   size_t size;   /* size of 'buf' (if not mapped) */
+   int eof;   /* all of file is in 'buf'? */
+   int mapped;   /* 'buf' is mapped rather than allocated? */
+} line_reader;
+
+/* destination for the calendar output (cf. out_mem()) */
+typedef struct {
+   char *buf;   /* buffered output ... */
+   size_t len;   /* ... its length ... */
+   size_t size;   /* ... and the size of 'buf' */
+   int fd;   /* output file descriptor, or OUT_MEMORY */
+   size_t mark;   /* start of output to be compressed ... */
+   int mark_fd;   /* ... and real 'fd' meanwhile (cf. out_compress_begin()) */
+} out_sink;
+
 /* ---------------------------------------------------------------------------
 
    Constant Declarations
 
 */
 
+#define READ_BLOCK_SIZE	65536	/* size of block reads by get_pcal_line() */
+
+/* characters which prevent get_pcal_line() from copying a line verbatim:
+   comments, escapes, non-blank whitespace, HTML escapes and font tags (cf.
+   cvt_escape()), and nulls */
+#define LINE_SPECIAL(c)	(line_special[(unsigned char) (c)])
+
+#define ARENA_CHUNK_SIZE   65536   /* default size of an arena chunk */
+#define ARENA_ALIGN        sizeof(double)   /* alignment of arena blocks */
+
+#define OUT_BUF_SIZE   262144   /* initial size of the output buffer */
+#define OUT_MEMORY     -1   /* out_sink.fd when collecting output in memory */
+
+/* LZW encoding as expected by the PostScript LZWDecode filter (with its
+   default EarlyChange of 1) */
+#define LZW_CLEAR      256   /* clear-table code */
+#define LZW_EOD        257   /* end-of-data code */
+#define LZW_FIRST      258   /* first code assigned to a string */
+#define LZW_MIN_BITS   9   /* initial code width */
+#define LZW_MAX_BITS   12   /* maximum code width */
+#define LZW_HASH_SIZE  5021   /* string table hash size (prime > 4096) */
+
+#define A85_LINE_LEN   75   /* maximum length of ASCII85 output lines */
+
+/* PostScript to decompress and execute the text which follows it */
+#define PS_DECOMPRESS  "currentfile /ASCII85Decode filter /LZWDecode filter cvx exec\n"
+
 /* ---------------------------------------------------------------------------
 
    Macro Definitions
@@ -231,6 +292,26 @@
 
 static char currfont[10], prevfont[10];
 
+/* buffers for the date files currently being read (cf. get_pcal_line()) */
+static line_reader readers[MAX_FILE_NESTING + 1];
+
+/* lookup table for LINE_SPECIAL() (filled in by open_reader()) */
+static char line_special[256];
+
+/* scratch buffers for get_pcal_line() and join_text() */
+static char *line_tmp = NULL, *text_tmp = NULL;
+static int line_tmp_size = 0, text_tmp_size = 0;
+
+/* The memory arena: the chunk currently being carved up heads 'arena';
+   chunks released by arena_free() wait on 'arena_spare' for reuse.  The
+   counters are reported by the "-ZA" debug flag. */
+static arena_chunk *arena = NULL, *arena_spare = NULL;
+static long arena_nallocs = 0, arena_nbytes = 0, arena_nchunks = 0, arena_peak = 0;
+
+/* the calendar output: unbuffered standard output until out_open() is
+   called */
+static out_sink out = { NULL, 0, 0, 1, 0, OUT_MEMORY };
+
 /* ---------------------------------------------------------------------------
 
    External Routine References & Function Prototypes
@@ -262,6 +343,123 @@ char *alloc (int size)
    return p;
 }
 
+/* ---------------------------------------------------------------------------
+
+   grow_buf
+
+   Notes:
+
+      This routine makes sure that the buffer '*pbuf' (currently of size
+      '*psize', and possibly NULL) can hold at least 'size' bytes, enlarging
+      it by doubling if necessary.  The contents are preserved.  It returns
+      the (possibly moved) buffer and will terminate if unsuccessful.
+
+*/
+char *grow_buf (char **pbuf, int *psize, int size)
+{
+   int n;
+
+   if (size > *psize) {
+      for (n = *psize ? *psize : LINSIZ; n < size; n *= 2)
+         ;
+      if ((*pbuf = (char *) realloc(*pbuf, n)) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+      *psize = n;
+   }
+
+   return *pbuf;
+}
+
+/* ---------------------------------------------------------------------------
+
+   arena_alloc
+
+   Notes:
+
+      This routine allocates zeroed memory from the arena, a chain of large
+      chunks used for the event tree (nodes and text) built while reading the
+      date file.  Arena memory is never freed individually; 'arena_free()'
+      releases all of it at once.  It will terminate if unsuccessful.
+
+*/
+char *arena_alloc (int size)
+{
+   arena_chunk *pc, **ppc;
+   size_t need;
+   char *p;
+   
+   need = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+   if (need == 0) need = ARENA_ALIGN;
+
+   if (arena == NULL || arena->size - arena->used < need) {
+      /* look for a spare chunk large enough, else allocate a new one */
+      for (ppc = &arena_spare; *ppc && (*ppc)->size < need; ppc = &(*ppc)->next)
+         ;
+      if ((pc = *ppc) != NULL) *ppc = pc->next;
+      else {
+         size_t csize = need > ARENA_CHUNK_SIZE ? need : ARENA_CHUNK_SIZE;
+         if ((pc = (arena_chunk *) malloc(sizeof(arena_chunk) + csize)) == NULL) {
+            fprintf(stderr, E_ALLOC_ERR, progname);
+            exit(EXIT_FAILURE);
+         }
+         pc->size = csize;
+         arena_nchunks++;
+      }
+      pc->used = 0;
+
+      /* an oversized request goes behind the current chunk so that the
+         latter's remaining space isn't wasted */
+      if (arena && need > ARENA_CHUNK_SIZE / 4) {
+         pc->next = arena->next;
+         arena->next = pc;
+      }
+      else {
+         pc->next = arena;
+         arena = pc;
+      }
+   }
+   else pc = arena;
+
+   p = (char *) (pc + 1) + pc->used;
+   pc->used += need;
+   memset(p, 0, need);
+
+   arena_nallocs++;
+   if ((arena_nbytes += need) > arena_peak) arena_peak = arena_nbytes;
+
+   return p;
+}
+
+/* ---------------------------------------------------------------------------
+
+   arena_free
+
+   Notes:
+
+      This routine releases everything allocated by 'arena_alloc()'.  The
+      chunks are kept for reuse by a subsequent parse of the date file.
+
+*/
+void arena_free (void)
+{
+   arena_chunk *pc;
+
+   if (DEBUG(DEBUG_ALLOC)) {
+      fprintf(stderr, "Arena: %ld allocations, %ld bytes (peak %ld) in %ld chunks\n",
+              arena_nallocs, arena_nbytes, arena_peak, arena_nchunks);
+   }
+
+   while ((pc = arena) != NULL) {   /* move chunks to spare list */
+      arena = pc->next;
+      pc->next = arena_spare;
+      arena_spare = pc;
+   }
+
+   arena_nallocs = arena_nbytes = 0;
+}
+
 /* ---------------------------------------------------------------------------
 
    ci_strcmp
@@ -301,6 +499,28 @@ int ci_strncmp (register char *s1, register char *s2, int n)
    return n < 0 ? 0 : c1 - c2;
 }
 
+/* ---------------------------------------------------------------------------
+
+   ci_strhash
+
+   Notes:
+
+      This routine returns a hash value for the specified string which
+      ignores case: any two strings which 'ci_strcmp()' reports as equal
+      yield the same value.
+
+*/
+unsigned long ci_strhash (register char *s)
+{
+   register unsigned long h = 5381;
+   register char c;
+   
+   for ( ; (c = tolower(*s)) != '\0'; s++) {
+      h = (h << 5) + h + (unsigned char) c;
+   }
+   return h;
+}
+
 /* ---------------------------------------------------------------------------
 
    define_font
@@ -435,6 +655,78 @@ char *set_fontstyle (char *p, char *esc)
  * Date calculation routines (see also macros in pcaldefs.h)
  */
 
+/* ---------------------------------------------------------------------------
+
+   day_serial
+
+   Notes:
+
+      This routine returns the serial day number of the specified date: the
+      number of days from 12/31/0000 (proleptic Gregorian), so that 1/1/0001
+      is day 1.  Day numbers make date offsets simple arithmetic, and the
+      weekday of day 'n' is n % 7.
+
+      The day need not be valid for the month (e.g., 2/30 is the day after
+      2/29 or 3/1); the year must be positive.
+
+*/
+long day_serial (date_str *pd)
+{
+   long y = pd->yy - 1;
+
+   return 365 * y + y / 4 - y / 100 + y / 400 + DAY_OF_YEAR(pd->mm, pd->dd, pd->yy);
+}
+
+/* ---------------------------------------------------------------------------
+
+   serial_to_date
+
+   Notes:
+
+      This routine converts a (positive) serial day number (cf.
+      'day_serial()') to a date, by splitting it into 400-year, 100-year,
+      4-year, and single-year cycles.
+
+*/
+void serial_to_date (long n, date_str *pd)
+{
+   long n400, n100, n4, n1;
+
+   n--;   /* days since 1/1/0001 */
+   n400 = n / DAYS_IN_400_YRS;
+   n -= n400 * DAYS_IN_400_YRS;
+   if ((n100 = n / DAYS_IN_100_YRS) > 3) n100 = 3;   /* last day of cycle */
+   n -= n100 * DAYS_IN_100_YRS;
+   n4 = n / DAYS_IN_4_YRS;
+   n -= n4 * DAYS_IN_4_YRS;
+   if ((n1 = n / 365) > 3) n1 = 3;   /* last day of leap year */
+   n -= n1 * 365;
+
+   doy_to_date((int) n + 1, (int) (400 * n400 + 100 * n100 + 4 * n4 + n1 + 1), pd);
+}
+
+/* ---------------------------------------------------------------------------
+
+   doy_to_date
+
+   Notes:
+
+      This routine converts a day of year 'doy' of year 'yy' to a date.
+
+      'doy' / 31 is at most one month away from the actual month.
+
+*/
+void doy_to_date (int doy, int yy, date_str *pd)
+{
+   int mm = doy / 31 + 1;
+
+   if (mm > DEC) mm = DEC;
+   if (mm < DEC && DAY_OF_YEAR(mm + 1, 1, yy) <= doy) mm++;
+   else if (DAY_OF_YEAR(mm, 1, yy) > doy) mm--;
+
+   MAKE_DATE(*pd, mm, doy - DAY_OF_YEAR(mm, 0, yy), yy);
+}
+
 /* ---------------------------------------------------------------------------
 
    normalize
@@ -446,10 +738,22 @@ char *set_fontstyle (char *p, char *esc)
 
       The first parameter is a pointer to the date.
 
+      Offsets of any size are converted directly via the serial day number
+      (cf. 'day_serial()'); the month-by-month adjustment is only used for
+      dates which would cross into year 0 or earlier.
+
 */
 void normalize (date_str *pd)
 {
    int len;
+   long n;
+
+   if (pd->dd >= 1 && pd->dd <= LENGTH_OF(pd->mm, pd->yy)) return;
+
+   if (pd->yy > 0 && (n = day_serial(pd)) > 0) {
+      serial_to_date(n, pd);
+      return;
+   }
 
    /* adjust if day is in previous or following month */
    
@@ -488,6 +792,12 @@ int calc_day (int ord, int wkd, int mm)
       pfcn = pdatefcn[wkd - WILD_FIRST];
       last = LENGTH_OF(mm, curr_year);
       
+      /* use the wildcard bitmaps (cf. readfile.c) if the year is in range */
+      first = DAY_OF_YEAR(mm, 1, curr_year);
+      if ((day = nth_wild_day(wkd, curr_year, first, first + last - 1, ord)) >= 0) {
+         return day ? day - first + 1 : 0;
+      }
+
       if (ord < 0) {   /* search backwards */
          for (day = last; 
               day >= 1 && !((*pfcn)(mm, day, curr_year) && ++ord == 0);
@@ -530,12 +840,18 @@ int calc_day (int ord, int wkd, int mm)
 */
 int calc_year_day (int ord, int wkd, date_str *pdate)
 {
-   int incr, (*pfcn) (int, int, int);
+   int day, incr, (*pfcn) (int, int, int);
    date_str date;
    
    if (IS_WILD(wkd)) {   /* "day", "weekday", "workday", or "holiday" */
       pfcn = pdatefcn[wkd - WILD_FIRST];
       
+      /* use the wildcard bitmaps (cf. readfile.c) if the year is in range */
+      if ((day = nth_wild_day(wkd, curr_year, 1, YEAR_LEN(curr_year), ord)) >= 0) {
+         if (day) doy_to_date(day, curr_year, pdate);
+         return day != 0;
+      }
+
       if (ord < 0) {   /* nth occurrence backwards */
          MAKE_DATE(date, DEC, 31, curr_year);
          ord = -ord;
@@ -680,6 +996,45 @@ int century (void)
    return this_century;
 }
 
+/* ---------------------------------------------------------------------------
+
+   bit_count
+
+   Notes:
+
+      This routine returns the number of bits set in 'w'.  (It is the
+      portable version of the 'BIT_COUNT()' macro; cf. pcaldefs.h.)
+
+*/
+int bit_count (unsigned long w)
+{
+   int n;
+   
+   for (n = 0; w; n++) w &= w - 1;   /* clear lowest set bit */
+
+   return n;
+}
+
+/* ---------------------------------------------------------------------------
+
+   low_bit
+
+   Notes:
+
+      This routine returns the position of the lowest bit set in 'w' (which
+      must be non-zero).  (It is the portable version of the 'LOW_BIT()'
+      macro; cf. pcaldefs.h.)
+
+*/
+int low_bit (unsigned long w)
+{
+   int n;
+   
+   for (n = 0; (w & 1) == 0; n++) w >>= 1;
+
+   return n;
+}
+
 /*
  * Token parsing/remerging routines:
  */
@@ -690,20 +1045,34 @@ int century (void)
 
    Notes:
 
-      This routine tokenizes the buffer 'buf' into array 'words' and returns the word count.
+      This routine tokenizes the buffer 'buf' into array '*pwords' and returns the word count.
 
       It differs from the old 'loadwords()' in that it handles quoted (" or ')
       strings and removes escaped quotes.
 
+      The array (currently of '*pmax' entries, and possibly NULL) is enlarged
+      as necessary.
+
 */
-int loadwords (char **words, char *buf)
+int loadwords (char ***pwords, int *pmax, char *buf)
 {
    register char *ptok;
-   char *delim, **ap, *p1, *p2, c;
+   char *delim, **ap, *p1, *p2, c, **words = *pwords;
    int nwords;
    
    for (ptok = buf, ap = words; TRUE; ap++) {
 
+      /* make room for up to two more words and the terminating null */
+      if ((nwords = ap - words) + 3 > *pmax) {
+         *pmax = *pmax ? 2 * *pmax : WORDS_INIT;
+         if ((words = (char **) realloc(words, *pmax * sizeof(char *))) == NULL) {
+            fprintf(stderr, E_ALLOC_ERR, progname);
+            exit(EXIT_FAILURE);
+         }
+         *pwords = words;
+         ap = words + nwords;
+      }
+
       ptok += strspn(ptok, WHITESPACE); /* find next token */
 
       if (! *ptok) {   /* end of buf? */
@@ -784,6 +1153,51 @@ void copy_text (char *pbuf, char **ptext)
    return;
 }
 
+/* ---------------------------------------------------------------------------
+
+   join_text
+
+   Notes:
+
+      This routine returns the remaining text as a single string, as
+      'copy_text()' (q.v.) would produce it.
+
+      Where the words were split from one unbroken run of the line buffer -
+      separated by single blanks, and with no quotes, escapes, or symbol
+      substitutions - the text is taken from the line buffer itself: the
+      separators are restored in place and the words are merged into one,
+      so later calls for the same words cost nothing.  Otherwise, the text is
+      copied to a scratch buffer, which remains valid until the next call.
+
+      The parameter is a pointer to first text word in "words".
+
+*/
+char *join_text (char **ptext)
+{
+   char **ap;
+   int len, contig = *ptext != NULL && **ptext != '\0';
+
+   for (ap = ptext, len = 1; *ap; ap++) {
+      len += strlen(*ap) + 1;
+      if (contig) {
+         int n = strcspn(*ap, " ");
+         contig = (*ap)[n] == '\0' && (ap[1] == NULL || ap[1] == *ap + n + 1);
+      }
+   }
+
+   if (! contig) {   /* copy it */
+      copy_text(grow_buf(&text_tmp, &text_tmp_size, len), ptext);
+      return text_tmp;
+   }
+
+   for (ap = ptext; ap[1]; ap++) {
+      (*ap)[strlen(*ap)] = ' ';   /* restore separator */
+   }
+   ptext[1] = NULL;
+
+   return *ptext;
+}
+
 /* ---------------------------------------------------------------------------
 
    split_date
@@ -1038,6 +1452,146 @@ void cvt_escape (char *obuf, char *ibuf)
  */
 
 
+/* ---------------------------------------------------------------------------
+
+   open_reader
+
+   Notes:
+
+      This routine returns the input buffer for file 'fp', setting one up if
+      the file hasn't been read from yet.
+
+      Regular files are mapped into memory where possible; anything else
+      (pipes, standard input, systems without mmap()) is read in blocks of
+      'READ_BLOCK_SIZE' bytes.
+
+*/
+static line_reader *open_reader (FILE *fp)
+{
+   line_reader *pr, *pfree = NULL;
+   int i;
+
+   for (i = 0; i < MAX_FILE_NESTING + 1; i++) {
+      if (readers[i].fp == fp) return &readers[i];
+      if (!readers[i].fp && !pfree) pfree = &readers[i];
+   }
+
+   if (!pfree) {
+      fprintf(stderr, E_ALLOC_ERR, progname);
+      exit(EXIT_FAILURE);
+   }
+
+   if (!line_special['#']) {
+      for (i = 0; i < 256; i++) line_special[i] = (isspace(i) && i != ' ') || i == '\0';
+      line_special[COMMENT_CHAR] = line_special['\\'] = TRUE;
+      line_special['&'] = line_special['<'] = TRUE;
+   }
+
+   pr = pfree;
+   memset(pr, 0, sizeof(line_reader));
+   pr->fp = fp;
+
+#ifdef BUILD_ENV_UNIX
+   {
+      struct stat st;
+      void *p;
+
+      if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+          ftell(fp) == 0 &&
+          (p = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0)) != MAP_FAILED) {
+         pr->buf = (char *) p;
+         pr->len = (size_t) st.st_size;
+         pr->eof = pr->mapped = TRUE;
+         return pr;
+      }
+   }
+#endif
+
+   pr->buf = alloc(pr->size = READ_BLOCK_SIZE);
+
+   return pr;
+}
+
+/* ---------------------------------------------------------------------------
+
+   close_reader
+
+   Notes:
+
+      This routine releases the input buffer 'pr'.
+
+*/
+static void close_reader (line_reader *pr)
+{
+#ifdef BUILD_ENV_UNIX
+   if (pr->mapped) munmap(pr->buf, pr->len);
+   else
+#endif
+   free(pr->buf);
+
+   pr->fp = NULL;
+   pr->buf = NULL;
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   fill_reader
+
+   Notes:
+
+      This routine reads the next block of the file into the input buffer
+      'pr', first moving any unread data to the start of the buffer (and
+      enlarging it if it is full).
+
+      It returns FALSE if there's no more data to read.
+
+*/
+static int fill_reader (line_reader *pr)
+{
+   size_t n;
+
+   if (pr->eof) return FALSE;
+
+   if (pr->pos > 0) {
+      memmove(pr->buf, pr->buf + pr->pos, pr->len - pr->pos);
+      pr->len -= pr->pos;
+      pr->pos = 0;
+   }
+
+   if (pr->len == pr->size) {
+      pr->size *= 2;
+      if ((pr->buf = (char *) realloc(pr->buf, pr->size)) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   n = fread(pr->buf + pr->len, 1, pr->size - pr->len, pr->fp);
+   if (n == 0) pr->eof = TRUE;
+   pr->len += n;
+
+   return n > 0;
+}
+
+/* ---------------------------------------------------------------------------
+
+   reader_getc
+
+   Notes:
+
+      This routine returns the next character from the input buffer 'pr' or
+      'EOF' at the end of the file (cf. getc()).
+
+*/
+static int reader_getc (line_reader *pr)
+{
+   if (pr->pos == pr->len && !fill_reader(pr)) return EOF;
+
+   return (unsigned char) pr->buf[pr->pos++];
+}
+
 /* ---------------------------------------------------------------------------
 
    get_pcal_line
@@ -1050,20 +1604,70 @@ void cvt_escape (char *obuf, char *ibuf)
       comments.  It also handles escaped newlines and calls 'cvt_escape()' to
       translate other escape sequences.
 
+      The file is read through an in-memory buffer (cf. open_reader()).
+      Lines containing no comments, escapes, or special whitespace - most of
+      them, in practice - are located with memchr() and copied straight into
+      'buf'; others are processed a character at a time.
+
 */
-int get_pcal_line (FILE *fp, char *buf, int *pline)
+int get_pcal_line (FILE *fp, char **pbuf, int *psize, int *pline)
 {
    register char *cp;
    register int c, c2;
    int in_comment;   /* comments: from '#' to end-of-line */
-   char tmpbuf[LINSIZ];   /* temporary buffer to accumulate line */
+   char *tmpbuf;   /* temporary buffer to accumulate line */
+   line_reader *pr;
+   char *pstart, *pend, *pnl;
+   int crlf;
+
+   pr = open_reader(fp);
 
-   cp = tmpbuf;
-   *buf = '\0';   /* in case of premature EOF */
+   cp = tmpbuf = grow_buf(&line_tmp, &line_tmp_size, LINSIZ);
+   grow_buf(pbuf, psize, LINSIZ);
+   **pbuf = '\0';   /* in case of premature EOF */
    
+   /* fast path: copy lines without special characters verbatim */
+
+   for (;;) {
+      pstart = pr->buf + pr->pos;
+      if ((pnl = memchr(pstart, '\n', pr->len - pr->pos)) == NULL) {
+         if (fill_reader(pr)) continue;   /* get rest of line */
+         if (pr->pos == pr->len) {   /* no more input lines */
+            close_reader(pr);
+            return FALSE;
+         }
+         pnl = pr->buf + pr->len;   /* last line has no newline */
+      }
+
+      for (pend = pstart; pend < pnl && !LINE_SPECIAL(*pend); pend++)
+         ;
+
+      /* a trailing CR (from CR/LF line endings) becomes a blank, as in
+         the slow path */
+      crlf = pend == pnl - 1 && *pend == '\r';
+      if (pend < pnl && !crlf) break;   /* needs full processing */
+
+      while (pstart < pnl && (*pstart == ' ' || (crlf && pstart == pnl - 1))) {
+         pstart++;   /* strip blanks */
+      }
+
+      pr->pos = pnl - pr->buf + (pnl < pr->buf + pr->len);
+      (*pline)++;   /* bump line number */
+
+      if (pstart < pnl) {
+         grow_buf(pbuf, psize, (int) (pnl - pstart) + 1);
+         memcpy(*pbuf, pstart, pnl - pstart);
+         (*pbuf)[pnl - pstart] = '\0';
+         if (crlf) (*pbuf)[pnl - pstart - 1] = ' ';
+         return TRUE;
+      }
+   }
+
+   /* slow path: process the line one character at a time */
+
    do {
       in_comment = FALSE;
-      while ((c = getc(fp)) != '\n' && c != EOF) {
+      while ((c = reader_getc(pr)) != '\n' && c != EOF) {
          if (c == COMMENT_CHAR) in_comment = TRUE;
          
          if (isspace(c)) c = ' ';   /* whitespace => blank */
@@ -1075,22 +1679,26 @@ int get_pcal_line (FILE *fp, char *buf, int *pline)
             handled by cvt_escape() or loadwords() (q.v.)
          */
          if (c == '\\') {
-            if ((c2 = getc(fp)) == EOF) return FALSE;
+            if ((c2 = reader_getc(pr)) == EOF) {
+               close_reader(pr);
+               return FALSE;
+            }
 
             if (c2 == '\n') {
                c = ' ';
                (*pline)++;
             }
             else if (c2 == COMMENT_CHAR) c = '#';
-            else ungetc(c2, fp);
+            else pr->pos--;   /* cf. ungetc() */
          }
          
-         /* 
-            Crudely prevent buffer overflow to prevent exploit by malicious
-            calendar input file.
-         */
-         if ((cp - tmpbuf) < (LINSIZ - 1)) *cp++ = c;
-         else return FALSE;
+         /* enlarge buffer if necessary (leaving room for the null) */
+         if ((cp - tmpbuf) + 1 >= line_tmp_size) {
+            int n = cp - tmpbuf;
+            tmpbuf = grow_buf(&line_tmp, &line_tmp_size, n + 2);
+            cp = tmpbuf + n;
+         }
+         *cp++ = c;
       }
 
       if (c == EOF) {
@@ -1108,7 +1716,10 @@ int get_pcal_line (FILE *fp, char *buf, int *pline)
             buffer (before deciding to return 'FALSE') fixes this bug.
 
          */
-         if ((cp - tmpbuf) == 0) return FALSE;    /* no more input lines */
+         if ((cp - tmpbuf) == 0) {   /* no more input lines */
+            close_reader(pr);
+            return FALSE;
+         }
       }
 
       (*pline)++;   /* bump line number */
@@ -1116,10 +1727,547 @@ int get_pcal_line (FILE *fp, char *buf, int *pline)
    } while (cp == tmpbuf);   /* ignore empty lines */
 
    *cp = '\0';
-   cvt_escape(buf, tmpbuf);   /* convert escape sequences */
+
+   /* convert escape sequences (which may expand the line: \f[BIPR] and
+      <[BI]> become font shift sequences) */
+   grow_buf(pbuf, psize, 3 * (int) (cp - tmpbuf) + 8);
+   cvt_escape(*pbuf, tmpbuf);
+   return TRUE;
+}
+
+/*
+ * Output routines:
+ */
+
+
+/* ---------------------------------------------------------------------------
+
+   out_open
+
+   Notes:
+
+      This routine directs all subsequent output (cf. out_mem() and friends)
+      to the file 'path', or to the standard output if 'path' is empty.  The
+      output is collected in a single large buffer and written with as few
+      system calls as possible; it is flushed automatically at exit.
+
+      It returns FALSE if the file can't be opened.
+
+*/
+int out_open (char *path)
+{
+#ifdef BUILD_ENV_UNIX
+   int fd = STDOUT_FILENO;
+
+   if (*path && (fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0) return FALSE;
+   out_open_fd(fd);
+#else
+   if (*path && freopen(path, "w", stdout) == (FILE *) NULL) return FALSE;
+   out_open_fd(fileno(stdout));
+#endif
+
    return TRUE;
 }
 
+/* ---------------------------------------------------------------------------
+
+   out_open_fd
+
+   Notes:
+
+      This routine directs all subsequent output to the open file descriptor
+      'fd' (a file, pipe, or socket), flushing anything already buffered for
+      the previous destination first.
+
+*/
+void out_open_fd (int fd)
+{
+   static int registered = FALSE;
+
+   if (out.fd >= 0) out_flush();
+
+   if (!registered) {
+      atexit(out_flush);
+      registered = TRUE;
+   }
+
+   if (out.size == 0) out.buf = alloc(out.size = OUT_BUF_SIZE);
+   out.len = 0;
+   out.fd = fd;
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_write
+
+   Notes:
+
+      This routine writes 'n1' bytes at 'p1' followed by 'n2' bytes at 'p2'
+      to the output file, retrying after partial writes.  Where writev() is
+      available, both pieces go out in a single call.  It terminates if the
+      write fails.
+
+*/
+static void out_write (const char *p1, size_t n1, const char *p2, size_t n2)
+{
+#ifdef BUILD_ENV_UNIX
+   struct iovec iov[2];
+   ssize_t n;
+   int i = 0;
+
+   iov[0].iov_base = (char *) p1, iov[0].iov_len = n1;
+   iov[1].iov_base = (char *) p2, iov[1].iov_len = n2;
+
+   while (i < 2) {
+      if (iov[i].iov_len == 0) {
+         i++;
+         continue;
+      }
+      if ((n = writev(out.fd, iov + i, 2 - i)) < 0) {
+         if (errno == EINTR) continue;
+         out.fd = OUT_MEMORY;   /* don't try again at exit */
+         fprintf(stderr, E_WRITE_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+      for (; i < 2 && (size_t) n >= iov[i].iov_len; i++) n -= iov[i].iov_len;
+      if (i < 2) {
+         iov[i].iov_base = (char *) iov[i].iov_base + n;
+         iov[i].iov_len -= n;
+      }
+   }
+#else
+   if (fwrite(p1, 1, n1, stdout) != n1 || fwrite(p2, 1, n2, stdout) != n2 || fflush(stdout) != 0) {
+      out.fd = OUT_MEMORY;   /* don't try again at exit */
+      fprintf(stderr, E_WRITE_ERR, progname);
+      exit(EXIT_FAILURE);
+   }
+#endif
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_flush
+
+   Notes:
+
+      This routine writes out any buffered output (unless output is being
+      collected in memory).  It terminates if the write fails.
+
+*/
+void out_flush (void)
+{
+   if (out.fd < 0 || out.len == 0) return;
+
+   out_write(out.buf, out.len, NULL, 0);
+   out.len = 0;
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_mem
+
+   Notes:
+
+      This routine appends 'n' bytes at 'p' to the output.  Blocks too big
+      for the buffer are written directly, together with anything already
+      buffered.
+
+*/
+void out_mem (const char *p, size_t n)
+{
+   if (out.len + n > out.size) {
+      if (out.fd == OUT_MEMORY) {
+         while (out.len + n > out.size) out.size *= 2;
+         if ((out.buf = (char *) realloc(out.buf, out.size)) == NULL) {
+            fprintf(stderr, E_ALLOC_ERR, progname);
+            exit(EXIT_FAILURE);
+         }
+      }
+      else if (n >= out.size / 2) {
+         out_write(out.buf, out.len, p, n);
+         out.len = 0;
+         return;
+      }
+      else out_flush();
+   }
+
+   memcpy(out.buf + out.len, p, n);
+   out.len += n;
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_str
+
+   Notes:
+
+      This routine appends the string 's' to the output.
+
+*/
+void out_str (const char *s)
+{
+   out_mem(s, strlen(s));
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_char
+
+   Notes:
+
+      This routine appends the character 'c' to the output.
+
+*/
+void out_char (int c)
+{
+   char ch = (char) c;
+
+   if (out.len < out.size) out.buf[out.len++] = ch;
+   else out_mem(&ch, 1);
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_int
+
+   Notes:
+
+      This routine appends the decimal representation of 'n' to the output,
+      padded on the left with 'pad' characters (' ' or '0') to at least
+      'width' characters.
+
+*/
+void out_int (long n, int width, int pad)
+{
+   char buf[32], *p = buf + sizeof(buf);
+   unsigned long u = n < 0 ? 0UL - (unsigned long) n : (unsigned long) n;
+   int neg = n < 0;
+
+   if (width > (int) sizeof(buf) - 1) width = sizeof(buf) - 1;
+
+   do *--p = '0' + (int) (u % 10); while ((u /= 10) != 0);
+
+   if (pad == '0') {
+      while (buf + sizeof(buf) - p < width - neg) *--p = '0';
+      if (neg) *--p = '-';
+   }
+   else {
+      if (neg) *--p = '-';
+      while (buf + sizeof(buf) - p < width) *--p = ' ';
+   }
+
+   out_mem(p, buf + sizeof(buf) - p);
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_printf
+
+   Notes:
+
+      This routine appends its arguments to the output, formatted as by
+      printf().  The conversions pcal uses most ("%d", "%s", and "%c", with
+      simple widths) are handled here; anything else (notably floating
+      point) is handed off to sprintf() one conversion at a time.
+
+      Only pcal's own format strings are passed in, so the widths and
+      precisions requested are always modest.
+
+*/
+void out_printf (char *fmt, ...)
+{
+   va_list ap;
+   char *p, *s, flags[8], spec[32], buf[512];
+   int nflags, left, zero, width, prec, lng;
+   size_t n;
+
+   va_start(ap, fmt);
+
+   while (*fmt) {
+
+      /* copy literal text up to the next conversion */
+      for (p = fmt; *p && *p != '%'; p++)
+         ;
+      if (p > fmt) out_mem(fmt, p - fmt);
+      if (!*p) break;
+
+      /* parse the conversion: [flags][width|*][.prec|*][h|l]type */
+      p++;
+      for (nflags = 0; *p && strchr("-+ #0", *p) && nflags < (int) sizeof(flags) - 2; p++)
+         flags[nflags++] = *p;
+      flags[nflags] = '\0';
+      left = strchr(flags, '-') != NULL;
+      zero = strchr(flags, '0') != NULL && !left;
+      width = 0;
+      prec = -1;
+      if (*p == '*') {
+         if ((width = va_arg(ap, int)) < 0) {   /* as if "-" flag given */
+            width = -width;
+            left = TRUE, zero = FALSE;
+            flags[nflags++] = '-', flags[nflags] = '\0';
+         }
+         p++;
+      }
+      else while (isdigit((int)*p)) width = width * 10 + *p++ - '0';
+      if (*p == '.') {
+         if (*++p == '*') prec = va_arg(ap, int), p++;
+         else for (prec = 0; isdigit((int)*p); p++) prec = prec * 10 + *p - '0';
+      }
+      if ((lng = *p == 'l') || *p == 'h') p++;
+      if (!*p) break;
+
+      switch (*p) {
+      case '%':
+         out_char('%');
+         break;
+
+      case 's':
+         s = va_arg(ap, char *);
+         n = strlen(s);
+         if (prec >= 0 && n > (size_t) prec) n = prec;
+         if (!left) for (; width > (int) n; width--) out_char(' ');
+         out_mem(s, n);
+         for (; width > (int) n; width--) out_char(' ');
+         break;
+
+      case 'c':
+         if (!left) for (; width > 1; width--) out_char(' ');
+         out_char(va_arg(ap, int));
+         for (; width > 1; width--) out_char(' ');
+         break;
+
+      default:
+         if ((*p == 'd' || *p == 'i') && !left && prec < 0 && strspn(flags, "0") == (size_t) nflags) {
+            out_int(lng ? va_arg(ap, long) : (long) va_arg(ap, int), width, zero ? '0' : ' ');
+            break;
+         }
+
+         /* pass anything else through sprintf(), rebuilding the spec with
+            any '*' widths filled in */
+         if (width > 255) width = 255;
+         if (prec > 100) prec = 100;
+         n = sprintf(spec, "%%%s", flags);
+         if (width > 0) n += sprintf(spec + n, "%d", width);
+         if (prec >= 0) n += sprintf(spec + n, ".%d", prec);
+         sprintf(spec + n, "%s%c", lng ? "l" : "", *p);
+
+         if (strchr("eEfFgG", *p)) sprintf(buf, spec, va_arg(ap, double));
+         else if (strchr("diouxX", *p) && lng) sprintf(buf, spec, va_arg(ap, long));
+         else if (strchr("diouxX", *p)) sprintf(buf, spec, va_arg(ap, int));
+         else strcpy(buf, "");   /* unsupported conversion */
+         out_str(buf);
+         break;
+      }
+
+      fmt = p + 1;
+   }
+
+   va_end(ap);
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   lzw_encode
+
+   Notes:
+
+      This routine compresses the 'n' bytes at 'p' as expected by the
+      PostScript LZWDecode filter, returning an allocated buffer and storing
+      its length in '*plen'.
+
+      Strings are looked up in a hash table keyed on (prefix code, next
+      byte).  Since the decoder adds each string to its table one code later
+      than the encoder does, the code width grows as soon as the encoder's
+      next code reaches the next power of two (the decoder's "early change").
+      The table is cleared just before it fills.
+
+*/
+static unsigned char *lzw_encode (const unsigned char *p, size_t n, size_t *plen)
+{
+   static long key[LZW_HASH_SIZE];
+   static short code[LZW_HASH_SIZE];
+   unsigned char *buf, *q;
+   unsigned long bits = 0;
+   int nbits = 0, width = LZW_MIN_BITS, next = LZW_FIRST, w, h;
+   long k;
+   size_t i;
+
+   /* worst case: one maximum-width code per byte, plus clears and EOD */
+   q = buf = (unsigned char *) alloc(n + n / 2 + n / 1024 + 16);
+
+#define PUT_CODE(_c) \
+   do { bits = (bits << width) | (unsigned long) (_c); nbits += width; \
+        while (nbits >= 8) *q++ = (unsigned char) (bits >> (nbits -= 8)); } while (0)
+
+   memset(key, -1, sizeof(key));
+   PUT_CODE(LZW_CLEAR);
+
+   if (n > 0) {
+      for (w = p[0], i = 1; i < n; i++) {
+         k = ((long) w << 8) | p[i];
+         for (h = (int) (k % LZW_HASH_SIZE); key[h] != -1 && key[h] != k; )
+            if (++h == LZW_HASH_SIZE) h = 0;
+         if (key[h] == k) {   /* string + byte already in table */
+            w = code[h];
+            continue;
+         }
+
+         PUT_CODE(w);
+         key[h] = k;
+         code[h] = (short) next++;
+         w = p[i];
+
+         if (next == (1 << LZW_MAX_BITS) - 2) {   /* table full: start over */
+            PUT_CODE(LZW_CLEAR);
+            memset(key, -1, sizeof(key));
+            next = LZW_FIRST;
+            width = LZW_MIN_BITS;
+         }
+         else if (next == 1 << width) width++;
+      }
+
+      /* the decoder adds a string on reading the last code, too */
+      PUT_CODE(w);
+      if (++next == (1 << LZW_MAX_BITS) - 2) {
+         PUT_CODE(LZW_CLEAR);
+         width = LZW_MIN_BITS;
+      }
+      else if (next == 1 << width) width++;
+   }
+
+   PUT_CODE(LZW_EOD);
+   if (nbits > 0) *q++ = (unsigned char) (bits << (8 - nbits));
+
+#undef PUT_CODE
+
+   *plen = q - buf;
+   return buf;
+}
+
+/* ---------------------------------------------------------------------------
+
+   ascii85_encode
+
+   Notes:
+
+      This routine encodes the 'n' bytes at 'p' in the ASCII base-85 form
+      expected by the PostScript ASCII85Decode filter (including the
+      terminating "~>"), returning an allocated buffer and storing its length
+      in '*plen'.
+
+      Lines are broken after about A85_LINE_LEN characters, but never before
+      a '%', lest the output be mistaken for a DSC comment.
+
+*/
+static char *ascii85_encode (const unsigned char *p, size_t n, size_t *plen)
+{
+   char *buf, *q, *line, c[5];
+   unsigned long v;
+   size_t i, j, len;
+   int k, nc;
+
+   len = (n / 4 + 1) * 5;   /* most characters needed, excluding newlines */
+   line = q = buf = alloc(len + len / A85_LINE_LEN + 16);
+
+   for (i = 0; i < n; i += 4) {
+      len = n - i < 4 ? n - i : 4;
+      for (v = 0, j = 0; j < 4; j++) v = (v << 8) | (j < len ? p[i + j] : 0);
+
+      if (v == 0 && len == 4) c[0] = 'z', nc = 1;
+      else {
+         for (k = 4; k >= 0; k--, v /= 85) c[k] = (char) ('!' + v % 85);
+         nc = (int) len + 1;   /* partial final group: len + 1 characters */
+      }
+
+      for (k = 0; k < nc; k++) {
+         if (q - line >= A85_LINE_LEN && c[k] != '%') *q++ = '\n', line = q;
+         *q++ = c[k];
+      }
+   }
+
+   memcpy(q, "~>\n", 3);
+   q += 3;
+
+   *plen = q - buf;
+   return buf;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_compress_begin
+
+   Notes:
+
+      This routine starts collecting output in memory so that it may be
+      compressed by out_compress_end().  Such sections may not be nested.
+
+*/
+void out_compress_begin (void)
+{
+   out.mark_fd = out.fd;
+   out.mark = out.len;
+   out.fd = OUT_MEMORY;
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   out_compress_end
+
+   Notes:
+
+      This routine replaces the output collected since out_compress_begin()
+      was called with PostScript which decompresses (via the LZWDecode and
+      ASCII85Decode filters of PostScript Level 2) and executes it.
+
+      The output must therefore consist of complete PostScript tokens, and
+      must not read from 'currentfile' or restore a VM snapshot saved before
+      the section began.  It is compressed even if that doesn't make it
+      smaller, so that output written with -Q always uses the Level 2
+      filters it declares (cf. 'write_psfile()').
+
+*/
+void out_compress_end (void)
+{
+   unsigned char *lzw;
+   char *a85;
+   size_t n = out.len - out.mark, nlzw, na85;
+
+   lzw = lzw_encode((unsigned char *) out.buf + out.mark, n, &nlzw);
+   a85 = ascii85_encode(lzw, nlzw, &na85);
+   free(lzw);
+
+   out.fd = out.mark_fd;
+   out.mark_fd = OUT_MEMORY;
+
+   out.len = out.mark;
+   OUT_LIT(PS_DECOMPRESS);
+   out_mem(a85, na85);
+   free(a85);
+
+   /* write out anything collected while compressing */
+   if (out.fd >= 0 && out.len >= OUT_BUF_SIZE) out_flush();
+
+   return;
+}
+
 /*
  * Routines dealing with translation of file specifications
  */
@@ -105,24 +105,7 @@
    Prototypes for functions defined in encvec.c:
 
 */
-extern void encvec_iso8859_1 (void);
-extern void encvec_iso8859_2 (void);
-extern void encvec_iso8859_3 (void);
-extern void encvec_iso8859_4 (void);
-extern void encvec_iso8859_5 (void);
-extern void encvec_iso8859_6 (void);
-extern void encvec_iso8859_7 (void);
-extern void encvec_iso8859_8 (void);
-extern void encvec_iso8859_9 (void);
-extern void encvec_iso8859_10 (void);
-extern void encvec_iso8859_11 (void);
-extern void encvec_iso8859_13 (void);
-extern void encvec_iso8859_14 (void);
-extern void encvec_iso8859_15 (void);
-extern void encvec_iso8859_16 (void);
-extern void encvec_koi8_r (void);
-extern void encvec_koi8_u (void);
-extern void encvec_roman8 (void);
+extern int print_encvec (int, const char *);
 
 
 /*
@@ -130,6 +113,8 @@ extern void encvec_roman8 (void);
    Prototypes for functions defined in exprpars.c:
 
 */
+extern void clear_exprs (void);
+extern void invalidate_exprs (void);
 extern int parse_expr (char *pbuf);
 
 
@@ -169,25 +154,45 @@ extern void recalc_paper_parameters (int paper_size_idx);
 
 */
 extern char *alloc (int size);
+extern char *arena_alloc (int size);
+extern void arena_free (void);
+extern int bit_count (unsigned long w);
 extern int calc_day (int ord, int wkd, int mm);
 extern int calc_weekday (int mm, int dd, int yy);
 extern int calc_year_day (int ord, int wkd, date_str *pdate);
 extern int century (void);
 extern int ci_strcmp (register char *s1, register char *s2);
 extern int ci_strncmp (register char *s1, register char *s2, int n);
+extern unsigned long ci_strhash (register char *s);
 extern void copy_text (char *pbuf, char **ptext);
 extern void cvt_escape (char *obuf, char *ibuf);
 extern void define_font (char *orig_font, char *new_font, char *dflt_font);
+extern long day_serial (date_str *pd);
 extern void define_shading (char *orig_shading, char *new_shading, char *dflt_shading);
+extern void doy_to_date (int doy, int yy, date_str *pd);
 extern char *find_executable (char *prog);
-extern int get_pcal_line (FILE *fp, char *buf, int *pline);
+extern int get_pcal_line (FILE *fp, char **pbuf, int *psize, int *pline);
+extern char *grow_buf (char **pbuf, int *psize, int size);
 extern int is_valid (register int m, register int d, register int y);
-extern int loadwords (char **words, char *buf);
+extern char *join_text (char **ptext);
+extern int loadwords (char ***pwords, int *pmax, char *buf);
+extern int low_bit (unsigned long w);
 extern char *mk_filespec (char *filespec, char *path, char *name);
 extern char *mk_path (char *path, char *filespec);
 extern void normalize (date_str *pd);
 extern int note_box (int mm, int dd, int yy);
 extern int note_day (int mm, int n, int yy);
+extern void out_char (int c);
+extern void out_compress_begin (void);
+extern void out_compress_end (void);
+extern void out_flush (void);
+extern void out_int (long n, int width, int pad);
+extern void out_mem (const char *p, size_t n);
+extern int out_open (char *path);
+extern void out_open_fd (int fd);
+extern void out_printf (char *fmt, ...);
+extern void out_str (const char *s);
+extern void serial_to_date (long n, date_str *pd);
 extern char *set_fontstyle (char *p, char *esc);
 extern int split_date (char *pstr, int *pn1, int *pn2, int *pn3);
 
@@ -197,6 +202,8 @@ extern int split_date (char *pstr, int *pn1, int *pn2, int *pn3);
 
 */
 extern void cleanup (void);
+extern void clear_cache (void);
+extern void clear_includes (void);
 extern void clear_syms (void);
 extern int date_type (char *cp, int *pn, int *pv);
 extern int do_define (char *sym);
@@ -207,8 +214,14 @@ extern int do_include (char *path, char *name, int noerr);
 extern int do_undef (char *sym);
 extern int enter_day_info (int m, int d, int y, int text_type, char **pword);
 extern int delete_day_info (int m, int d, int y, int text_type, char **pword);
-extern int process_event_specification (char **pword, int *ptext_type, char ***pptext);
+extern int process_event_specification (int rule, date_str *dates, int text_type, char **ptext);
 extern int enter_note (int mm, char **pword, int n);
+extern int enter_span_info (int first, int last, int text_type, char **pword);
+extern void expand_events (void);
+extern day_info *find_day_info (month_info *pmonth, int d, char *text, unsigned long h, day_info ***pplink);
+extern void eval_date (int rule);
+extern void eval_ord (event_rule *pr);
+extern void eval_rel (event_rule *pr);
 extern int find_easter (date_str *pdate);
 
 #ifndef NO_ORTHODOX
@@ -218,9 +231,13 @@ extern int find_odox_stgeorge (date_str *pdate);
 extern int find_odox_marcus (date_str *pdate);
 #endif
 
+extern month_info *find_month_info (int month, int year);
+extern span_info *find_span_info (int mm, int dd, int yy, span_info *prev);
 extern int find_sym_name (char *sym);
 extern char *find_sym_val (char *sym);
 extern year_info *find_year (int year, int insert);
+extern void hash_day_info (month_info *pmonth);
+extern char *intern_text (char *text, unsigned long *pci_hash);
 extern int get_keywd (char *cp);
 extern int get_month (char *cp, int numeric_ok, int year_ok);
 extern int get_ordinal (char *cp, int *pval);
@@ -236,14 +253,23 @@ extern int is_lastq (int mm, int dd, int yy);
 extern int is_newmoon (int mm, int dd, int yy);
 extern int is_weekday (int mm, int dd, int yy);
 extern int is_workday (int mm, int dd, int yy);
+extern void mark_holiday (int mm, int dd, int yy, int is_holiday);
+extern int new_rule (int kind);
 extern int not_holiday (int mm, int dd, int yy);
 extern int not_weekday (int mm, int dd, int yy);
 extern int not_workday (int mm, int dd, int yy);
-extern int parse_as_non_preproc (char **pword, char *filename);
-extern int parse_date (char **pword, int *ptype, char ***pptext);
-extern int parse_ord (int ord, int val, char **pword);
-extern int parse_rel (int val, int wkd, char **pword, int *ptype, char ***pptext);
+extern int nth_wild_day (int wkd, int yy, int first, int last, int n);
+extern int parse_as_non_preproc (char **pword, char *filename, int line);
+extern int parse_date (char **pword, int *ptype, char ***pptext, int *prule);
+extern int parse_ord (int ord, int val, char **pword, int *prule);
+extern int parse_rel (int val, int wkd, char **pword, int *ptype, char ***pptext, int *prule);
 extern void read_datefile (FILE *fp, char *filename);
+extern void sort_day_info (month_info *pmonth);
+extern int sym_defined (int i);
+extern int sym_slot (char *sym);
+extern int wild_bitmap (int wkd, int yy, unsigned long *map);
+extern int wild_nearest (int wkd, date_str *pd, int incr);
+extern int wild_search (int wkd, date_str *pd, int n, int incr);
 
 
 /*
@@ -256,6 +282,7 @@ extern char *expand_fmt (char *buf, char *p);
 extern void find_daytext (int month, int year, int is_holiday);
 extern void find_noteboxes (int month, int year);
 extern void multiple_months_html (int first_month, int first_year, int ncols);
+extern char *next_day_text (month_info *pm, int month, int day, int year, day_info **ppd, span_info **pps, int *pis_holiday);
 extern void print_colors (int month, int year);
 extern void print_html (char *s);
 extern void print_dates (int month, int year);
@@ -180,6 +180,21 @@
 #include <string.h>
 #include <ctype.h>
 
+#if defined (BUILD_ENV_UNIX) || defined (BUILD_ENV_DJGPP)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CACHE_OK   1   /* date file cache supported (cf. read_cache()) */
+#endif
+
+#ifdef BUILD_ENV_UNIX
+#include <sys/mman.h>
+#endif
+
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
+
 #include "pcaldefs.h"
 #include "pcallang.h"
 #include "protos.h"
@@ -190,6 +205,116 @@
 
 */
 
+/* bitmaps of the days matching the wildcard predicates (cf. wild_bitmap());
+   bit n of each map represents day n+1 of the year.  The day-of-week maps
+   depend only on the year's type - the weekday of January 1 and whether it
+   is a leap year - and are shared by all years of that type; the holiday and
+   moon phase maps are kept per year. */
+typedef struct {
+   unsigned long all[DAY_WORDS];   /* every day of the year */
+   unsigned long dow[7][DAY_WORDS];   /* days falling on each weekday */
+} year_type_bitmaps;
+
+/* jump table of the days of a year matching a wildcard (cf.
+   get_jump_table()): the nth match forward or backward from any day is
+   found by indexing 'rank' and then 'day' */
+typedef struct {
+   int wkd, yy;   /* wildcard and year (yy == 0 if unused) */
+   unsigned long map[DAY_WORDS];   /* bitmap the tables were built from */
+   short count;   /* number of matches */
+   short rank[367];   /* matches on days 1..d of the year */
+   short day[367];   /* day of the year of the rth match */
+} jump_table;
+
+typedef struct {
+   unsigned long holiday[DAY_WORDS];   /* holidays (cf. mark_holiday()) */
+   unsigned long moon[4][DAY_WORDS];   /* moon quarters (MOON_NM..MOON_3Q) */
+   int moon_ok;   /* moon bitmaps filled in yet? */
+} day_bitmaps;
+
+/* interned event text (cf. intern_text()); the text itself immediately
+   follows the structure */
+typedef struct t_e {
+   struct t_e *next;   /* next entry in same hash bucket */
+   unsigned long hash;   /* hash of text (case-sensitive) */
+   unsigned long ci_hash;   /* ci_strhash() of text */
+   long cache_index;   /* position in cache file (cf. write_cache()) */
+} text_entry;
+
+/* preprocessor symbol (cf. find_sym_name()); 'next' chains entries by index
+   within a hash bucket.  A name keeps its slot once it has one, whether
+   defined or not, so that compiled expressions can refer to it by index
+   (cf. sym_slot()) */
+typedef struct {
+   char *name;   /* symbol name */
+   char *val;   /* symbol value (NULL if none) */
+   unsigned long hash;   /* ci_strhash() of name */
+   int next;   /* next symbol in bucket */
+   int defined;   /* currently defined? */
+} pp_symbol;
+
+/* lines of an included file read into memory (cf. find_include()): 'text'
+   holds each line as returned by get_pcal_line(), null-terminated, and
+   'lineno' the corresponding source line numbers.  'refs' counts the
+   read_lines() calls walking it, so that a copy replaced meanwhile (because
+   the file changed) is freed by the last of them instead */
+typedef struct {
+   char *text;
+   int *lineno;
+   int nlines;
+   int refs;
+} include_text;
+
+/* included file (cf. do_include()) */
+typedef struct i_f {
+   struct i_f *next;   /* next cached file */
+   char *path;   /* file specification as opened */
+   long mtime, size;   /* file modification time and size when read */
+   include_text *body;   /* current contents */
+   int *once_year;   /* years for which file has been read with "once" */
+   int nonce;
+} include_file;
+
+/* "opt" line recorded for the date file cache (cf. write_cache()) */
+typedef struct o_l {
+   struct o_l *next;
+   char *where;   /* file name (for error messages) */
+   char **words;   /* words of line, starting with "opt" */
+   int nwords;
+} opt_line;
+
+/* node of a keyword trie (cf. find_keyword()); nodes are kept in a single
+   array and linked by index, with 0 meaning "none".  'term' is the lowest
+   table index of the names ending at this node and 'sub' the lowest of the
+   names passing through it, or NO_KEYWORD if there are none */
+typedef struct {
+   char c;   /* (lower-case) character leading to this node */
+   int term, sub;
+   int child;   /* first child */
+   int next;   /* next sibling */
+} kw_node;
+
+/* event specification awaiting entry (cf. queue_event()); 'dates' holds
+   the matching dates for each year it covers, terminated by a null entry,
+   if they have been expanded in advance (cf. expand_events()) */
+typedef struct {
+   int rule, span;   /* compiled date(s) (cf. parse_date()) */
+   int text_type;
+   int del;   /* delete the event rather than entering it? */
+   int year;   /* current year when read (possibly ALL_YEARS) */
+   char *text;
+   char font;   /* font style when read (cf. store_text()) */
+   char *filename;   /* where it was read (for error messages) */
+   int line;
+   date_str **dates;
+} event_spec;
+
+/* cursor over the contents of a cache file (cf. read_cache()) */
+typedef struct {
+   char *p, *end;   /* next byte, end of data */
+   int ok;   /* FALSE once the data runs out */
+} cache_reader;
+
 /* ---------------------------------------------------------------------------
 
    Constant Declarations
@@ -201,6 +326,12 @@
 #define PARSE_INVDATE   1       /* nonexistent date */
 #define PARSE_INVLINE   2       /* syntax error */
 #define PARSE_NOMATCH   3       /* no match for wildcard */
+#define PARSE_INVSPAN   4       /* span endpoint matches several dates */
+#define PARSE_SPANORDER 5       /* span ends before it starts */
+
+/* serial day number meaning "none" (serial days start at 1 - cf.
+   day_serial()) */
+#define NO_DAY          0L
 
 /* codes for states in read_datefile() */
 #define PROCESSING      0       /* currently processing datefile lines */
@@ -209,6 +340,15 @@
 
 #define BLANK_TEXT      " "     /* substitute for null input text */
 
+/* ways of matching a word against a keyword trie (cf. find_keyword()) */
+#define KW_NAME_PREFIX  0       /* name is a prefix of the word */
+#define KW_WORD_PREFIX  1       /* first 'n' chars of word prefix the name */
+#define KW_EITHER       2       /* either is a prefix of the other */
+#define KW_EXACT        3       /* name and word are identical */
+#define KW_MIN_LEN      4       /* first 'n' chars identical (or exact) */
+
+#define NO_KEYWORD      0x7fff  /* no keyword matched */
+
 /* ---------------------------------------------------------------------------
 
    Macro Definitions
@@ -219,11 +359,27 @@
 #define ADD_DATE(_m, _d, _y)   do { \
 	if (DEBUG(DEBUG_DATES)) \
 		fprintf(stderr, "Adding candidate date: %4d-%02d-%02d\n", _y, _m, _d); \
+	pdate = reserve_dates((int) (pdate - candidate_dates), 1); \
 	pdate->mm = _m, pdate->dd = _d, pdate++->yy = _y; \
 	} while (0)
 
 #define TERM_DATES   pdate->mm = pdate->dd = pdate->yy = 0
 
+/* set/clear the bit for day-of-year _d in a day bitmap */
+#define SET_DAY_BIT(_map, _d)   ((_map)[((_d)-1) / WORD_BITS] |= 1UL << (((_d)-1) % WORD_BITS))
+#define CLR_DAY_BIT(_map, _d)   ((_map)[((_d)-1) / WORD_BITS] &= ~(1UL << (((_d)-1) % WORD_BITS)))
+
+/* hash bucket (cf. month_info) for text with hash value _h on day _d */
+#define DAY_HASH(_pm, _d, _h)   ((int) (((_h) + (unsigned long) (_d) * 0x9E3779B1UL) & ((_pm)->hash_size - 1)))
+#define DAY_HASH_INIT   16   /* initial number of buckets */
+
+/* months counted from 1/1/0, for comparison with the printed window */
+#define MONTH_INDEX(_m, _y)   ((_y) * 12 + (_m) - 1)
+
+/* wildcards whose matches depend on the holidays entered so far */
+#define USES_HOLIDAYS(_w)   ((_w) == ANY_WORKDAY || (_w) == ANY_HOLIDAY || \
+                             (_w) == ANY_NONWORKDAY || (_w) == ANY_NONHOLIDAY)
+
 
 #ifndef NO_ORTHODOX
 #define odox_add(offs) do { \
@@ -273,19 +429,124 @@
    added to the linked list.
 
 */
-static date_str candidate_dates[MAX_DATES+1];   /* array of date structures */
+static THREAD_LOCAL date_str *candidate_dates = NULL;   /* array of date structures */
+static THREAD_LOCAL jump_table *jump_tabs = NULL;   /* cf. get_jump_table() */
+static THREAD_LOCAL int max_dates = 0;                  /* allocated size of array */
+
+/* event specifications read but not yet entered (cf. queue_event()); this
+   is used only when several threads are available to expand them */
+static event_spec *pending = NULL;
+static int npending = 0, max_pending = 0;
+static int batching = FALSE;
+#ifdef USE_PTHREADS
+static int nthreads = 1;
+#endif
 
-static char *pp_sym[MAX_PP_SYMS];   /* preprocessor defined symbols */
-static char *pp_val[MAX_PP_SYMS];   /* preprocessor defined symbols' values */
-static int curr_year_reset = FALSE;
+/* preprocessor symbols and their values, hashed case-insensitively (cf.
+   find_sym_name()); symbol table indices remain valid as it grows, and
+   until it is cleared (cf. clear_syms()) */
+static pp_symbol *pp_syms = NULL;
+static int n_pp_syms = 0, max_pp_syms = 0;
+static int *pp_hash = NULL;
+static int pp_hash_size = 0;
+static int pp_nsyms = 0;   /* symbols currently defined */
+static int pp_nvals = 0;   /* ... and how many of them have values */
+static THREAD_LOCAL int curr_year_reset = FALSE;
 static int delete_entry = FALSE;
 
+/* months which will be printed (cf. MONTH_INDEX, enter_day_info()) */
+static int window_first = 0, window_last = MONTH_INDEX(DEC, MAX_YR);
+
+/* year records within MIN_YR..MAX_YR, indexed by year - MIN_YR (cf.
+   find_year()) */
+static year_info *year_tab[MAX_YR - MIN_YR + 1];
+
+/* wildcard bitmaps, indexed by year - MIN_YR (cf. get_day_bitmaps()) and
+   by year type (cf. get_year_type_bitmaps()) */
+static day_bitmaps *day_maps[MAX_YR - MIN_YR + 1];
+static year_type_bitmaps year_type_maps[14];
+static int year_type_ok[14];
+
+/* files read via "include" (cf. do_include()) */
+static include_file *include_files = NULL;
+
+/* hash table of interned event text (cf. intern_text()) */
+static text_entry **text_tab = NULL;
+static int text_tab_size = 0;
+static int text_count = 0;
+
+/* pool of compiled date specification nodes for the current line (cf.
+   parse_date(), eval_date()) */
+static event_rule *rule_pool = NULL;
+static int nrules = 0;
+static int max_rules = 0;
+
+/* span events, in order of entry (cf. enter_span_info()), and the index
+   of those not deleted (cf. build_span_index()), rebuilt when 'nindexed'
+   is negative; 'span_hits' holds the spans covering day 'hits_day' (cf.
+   find_spans()) */
+static span_info *span_pool = NULL;
+static int nspans = 0;
+static int max_spans = 0;
+static int *span_order = NULL, *span_hits = NULL;
+static long *span_reach = NULL;
+static int nindexed = -1, max_indexed = 0, nhits = 0;
+static long hits_day = NO_DAY;
+
+/* date file cache (cf. read_cache(), write_cache()): the key describing
+   the parse, the "opt" lines and optional include files which were not
+   found while recording, and the contents of a cache file in use */
+static char *cache_key = NULL;
+static int cache_key_size = 0;
+static int caching = FALSE;
+static opt_line *opt_lines = NULL, **opt_tail = &opt_lines;
+static char **missing_files = NULL;
+static int n_missing = 0, max_missing = 0;
+static long cache_mtime = 0, cache_size = 0;
+static char *cache_data = NULL;
+static long cache_len = 0;
+static int cache_mapped = FALSE;
+
+/* keyword tries (cf. find_keyword()), built on first use from the tables
+   in pcallang.h; the month and day name tries are built per language */
+static kw_node *kw_nodes = NULL;
+static int n_kw_nodes = 0, max_kw_nodes = 0;
+static int keywd_trie, ordinal_trie, phase_trie, prep_trie, pp_trie, predef_trie, wild_trie;
+static int month_trie[NUM_LANGUAGES], day_trie[NUM_LANGUAGES];
+
 /* ---------------------------------------------------------------------------
 
    External Routine References & Function Prototypes
 
 */
 
+static include_file *find_include (char *filespec);
+static void free_include_text (include_text *pbody);
+static int lookup_sym (char *sym);
+static void rehash_syms (int n);
+static void read_lines (FILE *fp, include_file *pinc, char *filename);
+static date_str *reserve_dates (int used, int n);
+static int enter_event (int rule, int span, int text_type, char **ptext, date_str **dates);
+static int queue_event (int rule, int span, int text_type, char **ptext, char *filename, int line);
+static int rule_year (int rule);
+static void fill_holiday_map (int yy, unsigned long *map);
+static int span_holiday (long n);
+static void add_span_holidays (int yy, unsigned long *map, span_info *ps);
+#ifdef USE_PTHREADS
+static int uses_entries (int rule);
+static void *expand_dates (void *worker);
+static void expand_in_threads (void);
+#endif
+static int new_kw_node (int c);
+static void add_keyword (int root, char *name, int index);
+static void build_kw_tries (void);
+static int find_keyword (int root, char *cp, int n, int mode);
+#ifdef CACHE_OK
+static void make_cache_key (char *filename);
+static int read_cache (char *cachefile);
+static void write_cache (char *cachefile, char *filename);
+#endif
+
 /* ---------------------------------------------------------------------------
 
    read_datefile
@@ -312,6 +573,75 @@ static int delete_entry = FALSE;
       
 */
 void read_datefile (FILE *fp, char *filename)
+{
+#ifdef CACHE_OK
+   char *cachefile;
+#endif
+#ifdef USE_PTHREADS
+   char *cp;
+#endif
+
+   if (fp == NULL) return;   /* whoops, no date file */
+
+#ifdef CACHE_OK
+   /* use the cache named by PCAL_CACHE if it is current, else parse the
+      file and record the result - except when debugging, so that the
+      debugging output reflects an actual parse
+   */
+   if ((cachefile = getenv(PCAL_CACHE)) != NULL && *cachefile && debug_flags == 0) {
+      make_cache_key(filename);
+      if (read_cache(cachefile)) return;
+      caching = TRUE;
+   }
+#endif
+
+   /* only the months to be printed need their events (cf.
+      enter_day_info()) - but when debugging, enter them all, so that the
+      debugging output lists every date
+   */
+   if (! DEBUG(DEBUG_DATES)) {
+      window_first = MONTH_INDEX(init_month, init_year);
+      window_last = MONTH_INDEX(final_month, final_year);
+   }
+
+#ifdef USE_PTHREADS
+   /* read all the event specifications before entering them, so that their
+      dates can be expanded in parallel (cf. expand_events()) - except when
+      debugging, so that the debugging output appears in order
+   */
+   if ((cp = getenv(PCAL_THREADS)) != NULL && *cp) nthreads = atoi(cp);
+   else nthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+   if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+   batching = nthreads > 1 && debug_flags == 0;
+#endif
+
+   read_lines(fp, NULL, filename);
+
+   expand_events();   /* enter any events still pending */
+   batching = FALSE;
+
+#ifdef CACHE_OK
+   if (caching) {
+      write_cache(cachefile, filename);
+      caching = FALSE;
+   }
+#endif
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   read_lines
+
+   Notes:
+
+      This routine does the work of 'read_datefile()' (q.v.), taking its input
+      either from the open file 'fp' or, if 'pinc' is non-NULL, from the lines
+      of an included file already read into memory (cf. do_include()).
+
+*/
+static void read_lines (FILE *fp, include_file *pinc, char *filename)
 {
    static int file_level = 0;
    int if_level = 0;
@@ -320,7 +650,9 @@ void read_datefile (FILE *fp, char *filename)
    int pptype, ntokens, save_year, expr, (*pfcn) (char *) = NULL;
    char *ptok = NULL;
    char **pword;
-   char msg[STRSIZ], incpath[STRSIZ], save_font;
+   char msg[STRSIZ], incpath[STRSIZ], save_font, *ptext = NULL;
+   int iline = 0;
+   include_text *pbody = NULL;
 
    /* stack for processing nested "if{n}defs" - required for "elif" */
    struct {
@@ -328,8 +660,6 @@ void read_datefile (FILE *fp, char *filename)
       int else_ok;   /* is "elif" or "else" legal at this point? */
    } if_state[MAX_IF_NESTING+1];
    
-   if (fp == NULL) return;   /* whoops, no date file */
-      
    /* Note that there is no functional limit on file nesting.  This is mostly
       to catch infinite loops (e.g., a includes b, b includes a).
    */
@@ -346,8 +676,20 @@ void read_datefile (FILE *fp, char *filename)
    
    /* read lines until EOF */
    
-   while (get_pcal_line(fp, lbuf, &line)) {
+   if (pinc) {   /* hold on to this copy even if the file changes */
+      pbody = pinc->body;
+      pbody->refs++;
+      ptext = pbody->text;
+   }
+
+   while (pbody ? iline < pbody->nlines : get_pcal_line(fp, &lbuf, &lbuf_size, &line)) {
       char suffix;
+
+      if (pbody) {   /* next line from memory */
+         strcpy(grow_buf(&lbuf, &lbuf_size, (int) strlen(ptext) + 1), ptext);
+         ptext += strlen(ptext) + 1;
+         line = pbody->lineno[iline++];
+      }
       
       if (DEBUG(DEBUG_PP)) {
          fprintf(stderr, "%s (%d)", filename, line);
@@ -355,8 +697,9 @@ void read_datefile (FILE *fp, char *filename)
          fprintf(stderr, "\n");
       }
       
-      ntokens = loadwords(words, lbuf); /* split line into tokens */
+      ntokens = loadwords(&words, &max_words, lbuf); /* split line into tokens */
       pword = words;   /* point to the first */
+      if (ntokens == 0) continue;   /* nothing left after escapes */
       
       /* get token type and pointers to function and name */
       
@@ -369,9 +712,10 @@ void read_datefile (FILE *fp, char *filename)
       
       /* Perform symbol value substitution, but bypass it for any 'undef'
         preprocessor commands, otherwise there's no way to 'undef' a symbol
-        which also had a value defined with it.
+        which also had a value defined with it.  Skip it altogether when no
+        symbol has a value.
       */
-      if (pptype != PP_UNDEF) {
+      if (pptype != PP_UNDEF && pp_nvals > 0) {
          char **ap, *nap;
          for (ap=words; *ap; ap++) {
             if ((nap = find_sym_val(*ap))) *ap=nap;
@@ -406,8 +750,8 @@ void read_datefile (FILE *fp, char *filename)
             if_state[if_level].state = SKIP_TO_ENDIF;
             break;
          case AWAITING_TRUE:
-            copy_text(lbuf, pword);   /* reconstruct string */
-            if ((expr = (*pfcn)(lbuf)) == EXPR_ERR) {
+            /* reconstruct string */
+            if ((expr = (*pfcn)(join_text(pword))) == EXPR_ERR) {
                ERR(E_EXPR_SYNTAX);
                expr = FALSE;
             }
@@ -465,8 +809,8 @@ void read_datefile (FILE *fp, char *filename)
             matching endif
          */
          if (if_state[if_level-1].state == PROCESSING) {
-            copy_text(lbuf, pword);   /* reconstruct string */
-            if ((expr = (*pfcn)(lbuf)) == EXPR_ERR) {
+            /* reconstruct string */
+            if ((expr = (*pfcn)(join_text(pword))) == EXPR_ERR) {
                ERR(E_EXPR_SYNTAX);
                expr = FALSE;
             }
@@ -485,6 +829,27 @@ void read_datefile (FILE *fp, char *filename)
          extra = ntokens > 2;
          break;
          
+      case PP_ONCE:
+         /* note that this file has been read for the current year, so that
+            subsequent inclusions (cf. do_include()) skip it; the top-level
+            date file can't be included again
+         */
+         if (if_state[if_level].state == PROCESSING && ! pinc) ERR(E_ONCE_ERR);
+         else if (if_state[if_level].state == PROCESSING) {
+            int i;
+            for (i = 0; i < pinc->nonce && pinc->once_year[i] != save_year; i++)
+               ;
+            if (i == pinc->nonce) {
+               if ((pinc->once_year = (int *) realloc(pinc->once_year, (i + 1) * sizeof(int))) == NULL) {
+                  fprintf(stderr, E_ALLOC_ERR, progname);
+                  exit(EXIT_FAILURE);
+               }
+               pinc->once_year[pinc->nonce++] = save_year;
+            }
+         }
+         extra = ntokens > 1;
+         break;
+         
       case PP_OTHER:   
          /* None of the above... Parse this configuration file line as a
             non-preprocessor directive.  This could be an event specification,
@@ -494,7 +859,7 @@ void read_datefile (FILE *fp, char *filename)
          */
          if (if_state[if_level].state == PROCESSING) {
 
-            switch (parse_as_non_preproc(words, filename)) {
+            switch (parse_as_non_preproc(words, filename, line)) {
 
             case PARSE_INVDATE:
                ERR(E_INV_DATE);
@@ -507,6 +872,14 @@ void read_datefile (FILE *fp, char *filename)
             case PARSE_NOMATCH:
                ERR(E_NO_MATCH);
                break;
+
+            case PARSE_INVSPAN:
+               ERR(E_INV_SPAN);
+               break;
+
+            case PARSE_SPANORDER:
+               ERR(E_SPAN_ORDER);
+               break;
             }
          }
          extra = FALSE;
@@ -521,7 +894,14 @@ void read_datefile (FILE *fp, char *filename)
       
    } /* end while */
    
-   if (if_level > 0) fprintf(stderr, E_UNT_IFDEF, progname, filename);
+   if (if_level > 0) {
+      expand_events();   /* keep messages in order */
+      fprintf(stderr, E_UNT_IFDEF, progname, filename);
+   }
+
+   if (pbody && --pbody->refs == 0 && pbody != pinc->body) {
+      free_include_text(pbody);   /* replaced while in use */
+   }
    
    file_level--;
    curr_year = save_year;   /* restore saved year and font style */
@@ -540,7 +920,9 @@ void read_datefile (FILE *fp, char *filename)
 
    Notes:
 
-      This routine clears and deallocates the symbol table.
+      This routine clears and deallocates the symbol table.  The compiled
+      expressions refer to symbols by their indices (cf. 'sym_slot()'), so
+      they are discarded too.
 
 */
 /*
@@ -550,19 +932,120 @@ void clear_syms (void)
 {
    int i;
    
-   for (i = 0; i < MAX_PP_SYMS; i++) {
-      if (pp_sym[i]) {
-         free(pp_sym[i]);
-         pp_sym[i] = NULL;
-      }
-      if (pp_val[i]) {
-         free(pp_val[i]);
-         pp_val[i] = NULL;
-      }
+   for (i = 0; i < n_pp_syms; i++) {
+      if (pp_syms[i].name) free(pp_syms[i].name);
+      if (pp_syms[i].val) free(pp_syms[i].val);
+   }
+
+   if (pp_syms) free(pp_syms);
+   if (pp_hash) free(pp_hash);
+   pp_syms = NULL;
+   pp_hash = NULL;
+   n_pp_syms = max_pp_syms = pp_hash_size = 0;
+   pp_nsyms = pp_nvals = 0;
+
+   clear_exprs();
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   clear_includes
+
+   Notes:
+
+      This routine deallocates the in-memory copies of included files.
+
+*/
+void clear_includes (void)
+{
+   include_file *pinc;
+
+   while ((pinc = include_files) != NULL) {
+      include_files = pinc->next;
+      free(pinc->path);
+      if (pinc->body) free_include_text(pinc->body);
+      if (pinc->once_year) free(pinc->once_year);
+      free(pinc);
+   }
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   clear_cache
+
+   Notes:
+
+      This routine deallocates the data recorded for the date file cache and
+      releases the contents of the cache file in use (if any), to which the
+      event text loaded from it points.
+
+*/
+void clear_cache (void)
+{
+   opt_line *po;
+   int i;
+
+   while ((po = opt_lines) != NULL) {
+      opt_lines = po->next;
+      for (i = 0; i < po->nwords; i++) free(po->words[i]);
+      free(po->words);
+      free(po->where);
+      free(po);
+   }
+   opt_tail = &opt_lines;
+
+   for (i = 0; i < n_missing; i++) free(missing_files[i]);
+   if (missing_files) free(missing_files);
+   missing_files = NULL;
+   n_missing = max_missing = 0;
+
+   if (cache_key) free(cache_key);
+   cache_key = NULL;
+   cache_key_size = 0;
+
+   if (cache_data) {
+#ifdef BUILD_ENV_UNIX
+      if (cache_mapped) munmap(cache_data, (size_t) cache_len);
+      else
+#endif
+      free(cache_data);
    }
+   cache_data = NULL;
+   cache_len = 0;
+   cache_mapped = FALSE;
+
    return;
 }
 
+/* ---------------------------------------------------------------------------
+
+   clear_tree
+
+   Notes:
+
+      This routine discards the data structure, leaving the span event
+      array allocated.
+
+*/
+static void clear_tree (void)
+{
+   /* main data structure and wildcard bitmaps (all allocated from the
+      arena - cf. arena_alloc()) */
+   arena_free();
+   head = NULL;
+   memset(year_tab, 0, sizeof(year_tab));
+   memset(day_maps, 0, sizeof(day_maps));
+   text_tab = NULL;
+   text_tab_size = text_count = 0;
+
+   nspans = 0;
+   nindexed = -1;
+}
+
 /* ---------------------------------------------------------------------------
 
    cleanup
@@ -574,28 +1057,60 @@ void clear_syms (void)
 */
 void cleanup (void)
 {
-   int i, j;
-   year_info *py, *pny;
-   month_info *pm;
-   day_info *pd, *pnd;
-   
-   for (py = head; py; py = pny) {   /* main data structure */
-      pny = py->next;
-      for (i = 0; i < 12; i++) {
-         if ((pm = py->month[i]) == NULL) continue;
-         for (j = 0; j < LAST_NOTE_DAY; j++) {
-            for (pd = pm->day[j]; pd; pd = pnd) {
-               pnd = pd->next;
-               free(pd->text);
-               free(pd);
-            }
-         }
-         free(pm);
-      }
-      free(py);
-   }
-   
+   clear_tree();   /* main data structure */
+
    clear_syms();   /* symbol table */
+   clear_exprs();   /* compiled expressions */
+   clear_includes();   /* included files */
+
+   if (candidate_dates) {   /* candidate date list */
+      free(candidate_dates);
+      candidate_dates = NULL;
+      max_dates = 0;
+   }
+
+   if (jump_tabs) {   /* wildcard jump tables */
+      free(jump_tabs);
+      jump_tabs = NULL;
+   }
+
+   if (rule_pool) {   /* compiled date specifications */
+      free(rule_pool);
+      rule_pool = NULL;
+      nrules = max_rules = 0;
+   }
+
+   if (span_pool) {   /* span events (text is in the arena) */
+      free(span_pool);
+      span_pool = NULL;
+      nspans = max_spans = 0;
+   }
+
+   if (span_order) {   /* span event index */
+      free(span_order);
+      free(span_reach);
+      free(span_hits);
+      span_order = span_hits = NULL;
+      span_reach = NULL;
+      nindexed = -1;
+      max_indexed = 0;
+   }
+
+   if (pending) {   /* event queue (entries freed by expand_events()) */
+      free(pending);
+      pending = NULL;
+      npending = max_pending = 0;
+   }
+
+   clear_cache();   /* date file cache */
+
+   if (kw_nodes) {   /* keyword tries */
+      free(kw_nodes);
+      kw_nodes = NULL;
+      n_kw_nodes = max_kw_nodes = 0;
+      memset(month_trie, 0, sizeof(month_trie));
+      memset(day_trie, 0, sizeof(day_trie));
+   }
 
    return;
 }
@@ -610,25 +1125,106 @@ void cleanup (void)
 
    Notes:
 
-      This routine looks up a symbol name.
+      This routine looks up a symbol name (case-insensitive).
 
-      It returns the symbol table index if found or 'PP_SYM_UNDEF' if not
-      found.
+      It returns the symbol table index if found and defined or
+      'PP_SYM_UNDEF' if not.
 
 */
 int find_sym_name (char *sym)
 {
    int i;
    
-   if (!sym) return PP_SYM_UNDEF;
+   if (!sym || pp_nsyms == 0) return PP_SYM_UNDEF;
+   
+   return (i = lookup_sym(sym)) != PP_SYM_UNDEF && pp_syms[i].defined ? i : PP_SYM_UNDEF;
+}
+
+/* ---------------------------------------------------------------------------
+
+   lookup_sym
+
+   Notes:
+
+      This routine returns the symbol table index of 'sym', defined or not,
+      or 'PP_SYM_UNDEF' if it has none.
+
+*/
+static int lookup_sym (char *sym)
+{
+   int i;
+   unsigned long h;
+   
+   if (n_pp_syms == 0) return PP_SYM_UNDEF;
    
-   for (i = 0; i < MAX_PP_SYMS; i++) {
-      if (pp_sym[i] && ci_strcmp(pp_sym[i], sym) == 0) return i;
+   h = ci_strhash(sym);
+   for (i = pp_hash[h & (pp_hash_size - 1)]; i != PP_SYM_UNDEF; i = pp_syms[i].next) {
+      if (pp_syms[i].hash == h && ci_strcmp(pp_syms[i].name, sym) == 0) return i;
    }
    
    return PP_SYM_UNDEF;
 }
 
+/* ---------------------------------------------------------------------------
+
+   sym_slot
+
+   Notes:
+
+      This routine returns the symbol table index of 'sym', giving it one
+      (as an undefined symbol) if it has none yet.  The index stays the same
+      as the symbol is defined and undefined (cf. 'do_define()',
+      'do_undef()'), so compiled expressions resolve each identifier just
+      once (cf. 'compile_expr()').
+
+*/
+int sym_slot (char *sym)
+{
+   int i, *p;
+
+   if ((i = lookup_sym(sym)) != PP_SYM_UNDEF) return i;
+
+   /* add it, growing the table if necessary (keeping the hash table no
+      more than fully loaded) */
+   if (n_pp_syms == max_pp_syms) {
+      max_pp_syms = max_pp_syms ? 2 * max_pp_syms : PP_HASH_INIT;
+      if ((pp_syms = (pp_symbol *) realloc(pp_syms, max_pp_syms * sizeof(pp_symbol))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+   }
+   i = n_pp_syms++;
+
+   strcpy(pp_syms[i].name = alloc(strlen(sym)+1), sym);
+   pp_syms[i].val = NULL;
+   pp_syms[i].hash = ci_strhash(sym);
+   pp_syms[i].defined = FALSE;
+
+   if (pp_hash_size < max_pp_syms) rehash_syms(max_pp_syms);
+   else {
+      p = &pp_hash[pp_syms[i].hash & (pp_hash_size - 1)];
+      pp_syms[i].next = *p;
+      *p = i;
+   }
+
+   return i;
+}
+
+/* ---------------------------------------------------------------------------
+
+   sym_defined
+
+   Notes:
+
+      This routine returns TRUE if the symbol with table index 'i' (cf.
+      'sym_slot()') is currently defined.
+
+*/
+int sym_defined (int i)
+{
+   return pp_syms[i].defined;
+}
+
 /* ---------------------------------------------------------------------------
 
    find_sym_val
@@ -645,7 +1241,39 @@ char *find_sym_val (char *sym)
 {
    int j;
    
-   return (j=find_sym_name(sym))==PP_SYM_UNDEF ? NULL : pp_val[j];
+   return (j=find_sym_name(sym))==PP_SYM_UNDEF ? NULL : pp_syms[j].val;
+}
+
+/* ---------------------------------------------------------------------------
+
+   rehash_syms
+
+   Notes:
+
+      This routine rebuilds the preprocessor symbol hash table with 'n'
+      buckets ('n' must be a power of 2).
+
+*/
+static void rehash_syms (int n)
+{
+   int i, *p;
+
+   if ((p = (int *) realloc(pp_hash, n * sizeof(int))) == NULL) {
+      fprintf(stderr, E_ALLOC_ERR, progname);
+      exit(EXIT_FAILURE);
+   }
+   pp_hash = p;
+   pp_hash_size = n;
+
+   for (i = 0; i < n; i++) pp_hash[i] = PP_SYM_UNDEF;
+
+   for (i = 0; i < n_pp_syms; i++) {
+      p = &pp_hash[pp_syms[i].hash & (n - 1)];
+      pp_syms[i].next = *p;
+      *p = i;
+   }
+
+   return;
 }
 
 /* ---------------------------------------------------------------------------
@@ -705,15 +1333,11 @@ int do_define (char *sym)
    if (DEBUG(DEBUG_PP)) fprintf(stderr, "defining %s\n", sym);
    
    if (do_ifdef(sym)) return 0;   /* already defined? */
-      
-   for (i = 0; i < MAX_PP_SYMS; i++) {   /* find room for it */
-      if (!pp_sym[i]) {
-         strcpy(pp_sym[i] = alloc(strlen(sym)+1), sym);
-         return 0;
-      }
-   }
-   
-   fprintf(stderr, E_SYMFULL, progname, sym);
+
+   i = sym_slot(sym);   /* reuses the slot of a symbol once defined */
+   pp_syms[i].defined = TRUE;
+   pp_nsyms++;
+   invalidate_exprs();
 
    return 0;
 }
@@ -735,13 +1359,16 @@ int do_define_sym_val (char *sym, char *val)
    i = find_sym_name(sym);
    if (i == PP_SYM_UNDEF) return PP_SYM_UNDEF;
    
-   if (pp_val[i]) {
-      free(pp_val[i]);
-      pp_val[i]=NULL;
+   if (pp_syms[i].val) {
+      free(pp_syms[i].val);
+      pp_syms[i].val=NULL;
+      pp_nvals--;
    }
    
-   if (val) strcpy(pp_val[i] = alloc(strlen(val)+1), val); 
-   else pp_val[i]=NULL;
+   if (val) {
+      strcpy(pp_syms[i].val = alloc(strlen(val)+1), val); 
+      pp_nvals++;
+   }
    
    return 0;
 }
@@ -767,13 +1394,16 @@ int do_undef (char *sym)
 
    if (DEBUG(DEBUG_PP)) fprintf(stderr, "undefining %s\n", sym);
 
+   /* the symbol keeps its slot (cf. 'sym_slot()') */
    if ((i = find_sym_name(sym)) != PP_SYM_UNDEF) {
-      if (pp_val[i]) {
-         free(pp_val[i]);
-         pp_val[i] = NULL;
+      if (pp_syms[i].val) {
+         free(pp_syms[i].val);
+         pp_nvals--;
       }
-      free(pp_sym[i]);
-      pp_sym[i] = NULL;
+      pp_syms[i].val = NULL;
+      pp_syms[i].defined = FALSE;
+      pp_nsyms--;
+      invalidate_exprs();
    }
    
    return 0;
@@ -797,9 +1427,9 @@ int do_undef (char *sym)
 */
 int do_include (char *path, char *name, int noerr)
 {
-   FILE *fp;
+   include_file *pinc;
    char *p, incfile[STRSIZ], tmpnam[STRSIZ], sv_tmpnam[STRSIZ];
-   int yy, yyfirst, yylast, sv_curr_year;
+   int i, yy, yyfirst, yylast, sv_curr_year;
    
    if (!name) return 0;   /* whoops, no date file */
 
@@ -833,15 +1463,35 @@ int do_include (char *path, char *name, int noerr)
          *p = yy % 10 + '0';
       }
       
-      if ((fp = fopen(mk_filespec(incfile, path, tmpnam), "r")) == NULL) {
-         if (noerr) continue;   /* silently ignore in include? mode */
+      if ((pinc = find_include(mk_filespec(incfile, path, tmpnam))) == NULL) {
+         if (noerr) {   /* silently ignore in include? mode */
+            if (caching) {   /* ... but note it for the cache */
+               if (n_missing == max_missing) {
+                  max_missing = max_missing ? 2 * max_missing : 8;
+                  if ((missing_files = (char **) realloc(missing_files, max_missing * sizeof(char *))) == NULL) {
+                     fprintf(stderr, E_ALLOC_ERR, progname);
+                     exit(EXIT_FAILURE);
+                  }
+               }
+               strcpy(missing_files[n_missing++] = alloc(strlen(incfile) + 1), incfile);
+            }
+            continue;
+         }
+         expand_events();   /* keep messages in order */
          fprintf(stderr, E_FOPEN_ERR, progname, incfile);
          exit(EXIT_FAILURE);
       }
+
+      /* skip file if already read for this year and marked "once" */
+      for (i = 0; i < pinc->nonce && pinc->once_year[i] != yy; i++)
+         ;
+      if (i < pinc->nonce) {
+         if (DEBUG(DEBUG_PP)) fprintf(stderr, "skipping %s (once)\n", incfile);
+         continue;
+      }
       
       curr_year = yy;   /* avoid infinite recursion */
-      read_datefile(fp, incfile);   /* recursive call */
-      fclose(fp);
+      read_lines(NULL, pinc, incfile);   /* recursive call */
    }
 
    curr_year = sv_curr_year;   /* restore original value */
@@ -849,6 +1499,108 @@ int do_include (char *path, char *name, int noerr)
    return 0;
 }
 
+/* ---------------------------------------------------------------------------
+
+   find_include
+
+   Notes:
+
+      This routine returns the in-memory copy of the file 'filespec' for
+      'do_include()', reading it first if it hasn't been read yet or if it has
+      changed (by modification time or size) since it was read.  An old copy
+      still being read by an enclosing 'read_lines()' (the file includes
+      itself) is left for that to free.
+
+      It returns NULL if the file cannot be opened.
+
+*/
+static include_file *find_include (char *filespec)
+{
+   include_file *pinc, **ppinc;
+   include_text *pbody;
+   FILE *fp;
+   long mtime = 0, size = 0;
+   int line = 0, len, ntext = 0, max_text = 0, max_lines = 0;
+   char *buf = NULL;
+   int bufsize = 0;
+#if defined (BUILD_ENV_UNIX) || defined (BUILD_ENV_DJGPP)
+   struct stat st;
+
+   if (stat(filespec, &st) == 0) {
+      mtime = (long) st.st_mtime;
+      size = (long) st.st_size;
+   }
+#endif
+
+   for (ppinc = &include_files; (pinc = *ppinc) != NULL; ppinc = &pinc->next) {
+      if (strcmp(pinc->path, filespec) == 0) break;
+   }
+
+   if (pinc && pinc->mtime == mtime && pinc->size == size) return pinc;
+
+   if ((fp = fopen(filespec, "r")) == NULL) return NULL;
+
+   if (pinc) {   /* file has changed - discard old copy unless in use */
+      if (pinc->body->refs == 0) free_include_text(pinc->body);
+      pinc->body = NULL;
+   }
+   else {
+      pinc = (include_file *) alloc(sizeof(include_file));
+      memset(pinc, 0, sizeof(include_file));
+      strcpy(pinc->path = alloc(strlen(filespec) + 1), filespec);
+      *ppinc = pinc;
+   }
+   pinc->mtime = mtime;
+   pinc->size = size;
+
+   /* read all lines into memory */
+   pinc->body = pbody = (include_text *) alloc(sizeof(include_text));
+   memset(pbody, 0, sizeof(include_text));
+   max_text = LINSIZ;
+   pbody->text = alloc(max_text);
+   while (get_pcal_line(fp, &buf, &bufsize, &line)) {
+      len = strlen(buf) + 1;
+      if (ntext + len > max_text) {
+         while (ntext + len > max_text) max_text *= 2;
+         if ((pbody->text = (char *) realloc(pbody->text, max_text)) == NULL) {
+            fprintf(stderr, E_ALLOC_ERR, progname);
+            exit(EXIT_FAILURE);
+         }
+      }
+      if (pbody->nlines == max_lines) {
+         max_lines = max_lines ? 2 * max_lines : 64;
+         if ((pbody->lineno = (int *) realloc(pbody->lineno, max_lines * sizeof(int))) == NULL) {
+            fprintf(stderr, E_ALLOC_ERR, progname);
+            exit(EXIT_FAILURE);
+         }
+      }
+      memcpy(pbody->text + ntext, buf, len);
+      ntext += len;
+      pbody->lineno[pbody->nlines++] = line;
+   }
+
+   fclose(fp);
+   if (buf) free(buf);
+
+   return pinc;
+}
+
+/* ---------------------------------------------------------------------------
+
+   free_include_text
+
+   Notes:
+
+      This routine frees an in-memory copy of an included file.
+
+*/
+static void free_include_text (include_text *pbody)
+{
+   free(pbody->text);
+   if (pbody->lineno) free(pbody->lineno);
+   free(pbody);
+}
+
 /*
  * Dispatch functions for wildcard matching
  */
@@ -904,16 +1656,22 @@ int is_workday (int mm, int dd, int yy)
 
    Notes:
 
-      This routine determines whether or not mm/dd/yy is a holiday.
+      This routine determines whether or not mm/dd/yy is a holiday.  The
+      holiday flags of a month which is not printed do not include those
+      of any span events covering it (cf. 'mark_span_days()').
 
 */
 int is_holiday (int mm, int dd, int yy)
 {
    year_info *py;
    month_info *pm;
+   date_str date;
    
    pm = (py = find_year(yy, FALSE)) ? py->month[mm-1] : NULL;
-   return pm ? (pm->holidays & (1L << (dd-1))) != 0 : FALSE;
+   if (pm && (pm->holidays & (1L << (dd-1)))) return TRUE;
+
+   date.mm = mm, date.dd = dd, date.yy = yy;
+   return nspans > 0 && span_holiday(day_serial(&date));
 }
 
 /* ---------------------------------------------------------------------------
@@ -1032,7 +1790,418 @@ int is_lastq (int mm, int dd, int yy)
 }
 
 /*
-   Routines to find predefined holidays too complicated to express as Pcal
+ * Wildcard bitmap routines:
+ *
+ * The wildcard predicates above are also kept as per-year bitmaps (one bit
+ * per day of the year), so that searches for "all workday in all", "odd
+ * nonholiday in year", "3rd workday after ...", etc. can use word-wide bit
+ * operations instead of calling the predicate for every day.  The functions
+ * above remain the reference definitions (and are still used for dates
+ * outside MIN_YR..MAX_YR).
+ */
+
+/* ---------------------------------------------------------------------------
+
+   get_year_type_bitmaps
+
+   Notes:
+
+      This routine returns the day-of-week bitmaps for years of the same
+      type as the specified year, creating them on first use.  (These do not
+      depend on the date file, so they survive 'cleanup()'.)
+
+*/
+static year_type_bitmaps *get_year_type_bitmaps (int yy)
+{
+   year_type_bitmaps *pt;
+   int t, w, doy, ndays;
+
+   t = calc_weekday(JAN, 1, yy) + (IS_LEAP(yy) ? 7 : 0);
+   pt = &year_type_maps[t];
+   if (year_type_ok[t]) return pt;
+
+   /* days of the week cycle from January 1 */
+   ndays = YEAR_LEN(yy);
+   for (doy = 1, w = calc_weekday(JAN, 1, yy); doy <= ndays; doy++, w = (w + 1) % 7) {
+      SET_DAY_BIT(pt->dow[w], doy);
+      SET_DAY_BIT(pt->all, doy);
+   }
+   year_type_ok[t] = TRUE;
+
+   return pt;
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_day_bitmaps
+
+   Notes:
+
+      This routine returns the holiday and moon phase bitmaps for the
+      specified year, creating them on first use.
+
+      The holiday bitmap is initialized from the holidays entered so far (cf.
+      'fill_holiday_map()'); it is kept current afterwards by
+      'mark_holiday()' and 'mark_span_days()'.  The moon phase
+      bitmaps are filled in by 'wild_bitmap()' the first time a moon phase
+      wildcard is used.
+
+      It returns NULL if the year is out of range.
+
+*/
+static day_bitmaps *get_day_bitmaps (int yy)
+{
+   day_bitmaps *pb;
+
+   if (yy < MIN_YR || yy > MAX_YR) return NULL;
+
+   if ((pb = day_maps[yy - MIN_YR]) != NULL) return pb;
+
+   pb = day_maps[yy - MIN_YR] = (day_bitmaps *) arena_alloc((int) sizeof(day_bitmaps));
+   fill_holiday_map(yy, pb->holiday);   /* holidays entered so far */
+
+   return pb;
+}
+
+/* ---------------------------------------------------------------------------
+
+   fill_holiday_map
+
+   Notes:
+
+      This routine sets 'map' to the holidays of year 'yy' entered so far:
+      those flagged in its months plus the days covered by holiday spans.
+
+*/
+static void fill_holiday_map (int yy, unsigned long *map)
+{
+   year_info *py;
+   month_info *pm;
+   int mm, dd;
+
+   memset(map, 0, DAY_WORDS * sizeof(unsigned long));
+
+   if ((py = find_year(yy, FALSE)) != NULL) {
+      for (mm = JAN; mm <= DEC; mm++) {
+         if ((pm = py->month[mm-1]) == NULL || pm->holidays == 0) continue;
+         for (dd = 1; dd <= LENGTH_OF(mm, yy); dd++) {
+            if (pm->holidays & (1L << (dd-1))) SET_DAY_BIT(map, DAY_OF_YEAR(mm, dd, yy));
+         }
+      }
+   }
+
+   if (nspans > 0) add_span_holidays(yy, map, NULL);
+}
+
+/* ---------------------------------------------------------------------------
+
+   mark_holiday
+
+   Notes:
+
+      This routine sets or clears the holiday bit for mm/dd/yy in the year's
+      bitmaps (if they exist yet).
+
+*/
+void mark_holiday (int mm, int dd, int yy, int is_holiday)
+{
+   day_bitmaps *pb;
+
+   if (yy < MIN_YR || yy > MAX_YR || (pb = day_maps[yy - MIN_YR]) == NULL) return;
+
+   if (is_holiday) SET_DAY_BIT(pb->holiday, DAY_OF_YEAR(mm, dd, yy));
+   else CLR_DAY_BIT(pb->holiday, DAY_OF_YEAR(mm, dd, yy));
+}
+
+/* ---------------------------------------------------------------------------
+
+   wild_bitmap
+
+   Notes:
+
+      This routine fills in 'map' with the days of year 'yy' which match the
+      specified wildcard (cf. 'pdatefcn[]').  "Weekdays" are those whose
+      color is currently the predominant one, so that "opt -b" etc. take
+      effect immediately.
+
+      It returns FALSE if the year is out of range.
+
+*/
+int wild_bitmap (int wkd, int yy, unsigned long *map)
+{
+   static unsigned long no_holidays[DAY_WORDS];
+   year_type_bitmaps *pt;
+   day_bitmaps *pb = NULL;
+   unsigned long wk, *hol = no_holidays;
+   int i, w, mm, dd, quarter;
+
+   if (yy < MIN_YR || yy > MAX_YR) return FALSE;
+
+   pt = get_year_type_bitmaps(yy);
+
+   /* a year without entries has no holidays - don't create its bitmaps
+      just to find that out (cf. wild_search()), nor for wildcards which
+      don't depend on holidays (cf. expand_events()) */
+   if (wkd >= WILD_FIRST_MOON || (USES_HOLIDAYS(wkd) && find_year(yy, FALSE) != NULL)) {
+      pb = get_day_bitmaps(yy);
+      hol = pb->holiday;
+   }
+
+   if (wkd >= WILD_FIRST_MOON && ! pb->moon_ok) {   /* fill moon bitmaps */
+      for (mm = JAN; mm <= DEC; mm++) {
+         for (dd = 1; dd <= LENGTH_OF(mm, yy); dd++) {
+            (void) find_phase(mm, dd, yy, &quarter);
+            if (quarter != MOON_OTHER) SET_DAY_BIT(pb->moon[quarter], DAY_OF_YEAR(mm, dd, yy));
+         }
+      }
+      pb->moon_ok = TRUE;
+   }
+
+   for (i = 0; i < DAY_WORDS; i++) {
+      for (wk = 0, w = SUN; w <= SAT; w++) {
+         if (day_color[w] == weekday_color) wk |= pt->dow[w][i];
+      }
+      
+      switch (wkd) {
+      case ANY_DAY:         map[i] = pt->all[i];                              break;
+      case ANY_WEEKDAY:     map[i] = wk;                                      break;
+      case ANY_WORKDAY:     map[i] = wk & ~hol[i];                            break;
+      case ANY_HOLIDAY:     map[i] = hol[i];                                  break;
+      case ANY_NONWEEKDAY:  map[i] = pt->all[i] & ~wk;                        break;
+      case ANY_NONWORKDAY:  map[i] = pt->all[i] & ~(wk & ~hol[i]);            break;
+      case ANY_NONHOLIDAY:  map[i] = pt->all[i] & ~hol[i];                    break;
+      default:              map[i] = pb->moon[wkd - WILD_FIRST_MOON][i];      break;
+      }
+   }
+
+   return TRUE;
+}
+
+/* ---------------------------------------------------------------------------
+
+   day_range_mask
+
+   Notes:
+
+      This routine returns the mask of the bits of word 'i' of a day bitmap
+      which fall within days 'first'..'last' of the year.
+
+*/
+static unsigned long day_range_mask (int i, int first, int last)
+{
+   unsigned long mask = ~0UL;
+   int lo = first - 1 - i * WORD_BITS, hi = last - 1 - i * WORD_BITS;
+
+   if (lo > 0) mask &= ~0UL << lo;
+   if (hi < WORD_BITS - 1) mask &= (2UL << hi) - 1;
+
+   return mask;
+}
+
+/* ---------------------------------------------------------------------------
+
+   find_nth_day
+
+   Notes:
+
+      This routine finds the nth set bit of a day bitmap within days
+      'first'..'last', counting forward from 'first' if *pn > 0 or backward
+      from 'last' if *pn < 0.  Whole words are skipped by counting their
+      bits.
+
+      It returns the day of the year found, or 0 if there are fewer than n
+      matches; in that case *pn is reduced by the number of matches seen.
+
+*/
+static int find_nth_day (unsigned long *map, int first, int last, int *pn)
+{
+   unsigned long w;
+   int i, c, n = *pn;
+
+   if (n > 0) {   /* search forwards */
+      for (i = (first - 1) / WORD_BITS; i <= (last - 1) / WORD_BITS; i++) {
+         w = map[i] & day_range_mask(i, first, last);
+         if ((c = BIT_COUNT(w)) >= n) {
+            while (--n) w &= w - 1;   /* drop earlier matches */
+            return i * WORD_BITS + LOW_BIT(w) + 1;
+         }
+         n -= c;
+      }
+   }
+   else if (n < 0) {   /* search backwards */
+      for (i = (last - 1) / WORD_BITS; i >= (first - 1) / WORD_BITS; i--) {
+         w = map[i] & day_range_mask(i, first, last);
+         if ((c = BIT_COUNT(w)) >= -n) {
+            for (c += n; c > 0; c--) w &= w - 1;   /* drop earlier matches */
+            return i * WORD_BITS + LOW_BIT(w) + 1;
+         }
+         n += c;
+      }
+   }
+
+   *pn = n;
+   return 0;
+}
+
+/* ---------------------------------------------------------------------------
+
+   nth_wild_day
+
+   Notes:
+
+      This routine finds the nth day (counting from 'first' if n > 0, or
+      backwards from 'last' if n < 0) within days 'first'..'last' of year 'yy'
+      which matches the specified wildcard.
+
+      It returns the day of the year of the match, 0 if there is none, or -1
+      if the year is out of range (in which case the caller must search day
+      by day).
+
+*/
+int nth_wild_day (int wkd, int yy, int first, int last, int n)
+{
+   unsigned long map[DAY_WORDS];
+
+   if (! wild_bitmap(wkd, yy, map)) return -1;
+
+   return find_nth_day(map, first, last, &n);
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_jump_table
+
+   Notes:
+
+      This routine returns the jump table for the days of year 'yy' which
+      match wildcard 'wkd', given their bitmap 'map' (cf. 'wild_bitmap()').
+      Tables are kept per thread in a small cache indexed by wildcard and
+      year; one is rebuilt (a single pass over the year) only if the bitmap
+      has changed since - e.g., because more holidays have been entered or
+      "opt -b" has changed which days are weekdays.
+
+*/
+static jump_table *get_jump_table (int wkd, int yy, unsigned long *map)
+{
+   jump_table *pj;
+   int d, ndays = YEAR_LEN(yy);
+
+   if (jump_tabs == NULL &&
+       (jump_tabs = (jump_table *) calloc(JUMP_TABLES, sizeof(jump_table))) == NULL) {
+      fprintf(stderr, E_ALLOC_ERR, progname);
+      exit(EXIT_FAILURE);
+   }
+
+   pj = &jump_tabs[(yy * (WILD_LAST_MOON + 1) + wkd) % JUMP_TABLES];
+   if (pj->wkd == wkd && pj->yy == yy && memcmp(pj->map, map, sizeof(pj->map)) == 0) return pj;
+
+   pj->wkd = wkd;
+   pj->yy = yy;
+   memcpy(pj->map, map, sizeof(pj->map));
+   for (d = 1, pj->count = 0, pj->rank[0] = 0; d <= ndays; d++) {
+      if (map[(d-1) / WORD_BITS] & (1UL << ((d-1) % WORD_BITS))) pj->day[++pj->count] = d;
+      pj->rank[d] = pj->count;
+   }
+
+   return pj;
+}
+
+/* ---------------------------------------------------------------------------
+
+   wild_search
+
+   Notes:
+
+      This routine searches forward (incr > 0) or backward (incr < 0) from
+      the date 'pd' (inclusive) for the nth date which matches the specified
+      wildcard, crossing into following or preceding years as necessary.
+
+      If found, it stores the matching date in 'pd' and returns TRUE.  It
+      returns FALSE (leaving 'pd' unchanged) if no match is found within
+      MIN_YR..MAX_YR.
+
+      Within a year the match is found in constant time from the year's
+      jump table (cf. 'get_jump_table()').  Each year passed over without a
+      match costs only the few word operations of 'wild_bitmap()' (years
+      without entries have no holidays), and a wildcard which depends only
+      on the day of the week gives up as soon as a whole year has no match,
+      since no other year will have one either.
+
+*/
+int wild_search (int wkd, date_str *pd, int n, int incr)
+{
+   unsigned long map[DAY_WORDS], any;
+   jump_table *pj;
+   int i, yy, doy, r;
+
+   for (yy = pd->yy, doy = DAY_OF_YEAR(pd->mm, pd->dd, pd->yy);
+        wild_bitmap(wkd, yy, map);
+        yy += incr, doy = incr > 0 ? 1 : YEAR_LEN(yy)) {
+
+      for (i = 0, any = 0; i < DAY_WORDS; i++) any |= map[i];
+      if (any == 0) {   /* no match this year */
+         if (wkd == ANY_DAY || wkd == ANY_WEEKDAY || wkd == ANY_NONWEEKDAY) break;
+         continue;
+      }
+
+      pj = get_jump_table(wkd, yy, map);
+      if (incr > 0) {   /* nth match on or after doy */
+         if ((r = pj->rank[doy-1] + n) <= pj->count) {
+            doy_to_date(pj->day[r], yy, pd);
+            return TRUE;
+         }
+         n = r - pj->count;
+      }
+      else {   /* nth match on or before doy */
+         if ((r = pj->rank[doy] - n + 1) >= 1) {
+            doy_to_date(pj->day[r], yy, pd);
+            return TRUE;
+         }
+         n = 1 - r;
+      }
+   }
+
+   return FALSE;
+}
+
+/* ---------------------------------------------------------------------------
+
+   wild_nearest
+
+   Notes:
+
+      This routine finds the date nearest to 'pd' which matches the specified
+      wildcard.  Equally near dates are resolved in favor of the later one if
+      'incr' > 0, the earlier one if 'incr' < 0 (cf. 'eval_rel()').
+
+      If found, it stores the matching date in 'pd' and returns TRUE.  It
+      returns FALSE (leaving 'pd' unchanged) if there is no match within
+      MIN_YR..MAX_YR in either direction.
+
+*/
+int wild_nearest (int wkd, date_str *pd, int incr)
+{
+   date_str after, before;
+   int found_after, found_before;
+   long n;
+
+   after = before = *pd;
+   found_after = wild_search(wkd, &after, 1, 1);
+   found_before = wild_search(wkd, &before, 1, -1);
+   if (! found_after && ! found_before) return FALSE;
+
+   /* compare the distances to the next and previous matches */
+   if (found_after && found_before) {
+      n = (day_serial(&after) - day_serial(pd)) - (day_serial(pd) - day_serial(&before));
+      *pd = n < 0 || (n == 0 && incr > 0) ? after : before;
+   }
+   else *pd = found_after ? after : before;
+
+   return TRUE;
+}
+
+/*
+   Routines to find predefined holidays too complicated to express as Pcal
    date strings.  All add the matching date(s) (yes, holidays which span
    multiple days are allowed) to the 'candidate_dates[]' array (pointed to by
    pdate) and return the number of matching dates.
@@ -1201,134 +2370,299 @@ int find_odox_marcus (date_str *pdate)   /* pointer into date array */
 
 /* ---------------------------------------------------------------------------
 
-   get_month
+   new_kw_node
 
    Notes:
 
-      This routine converts an alpha (or, optionally, numeric) string to a month.
-
-      It returns 1..12 if valid, 'NOT_MONTH' if not, 'ALL_MONTHS' if "all",
-      'ENTIRE_YEAR' if "year".
-
-      The first parameter is the string to convert.
-
-      The second parameter is a flag to indicate that a numeric string can be
-      accepted.
-
-      The third parameter is a flag to indicate that the string "year" can be
-      accepted.
+      This routine adds a node for the (lower-case) character 'c' to the
+      keyword trie array and returns its index.
 
 */
-int get_month (char *cp, int numeric_ok, int year_ok)
+static int new_kw_node (int c)
 {
-   int mm;
-   
-   if (!cp) return NOT_MONTH;
-
-   if (get_keywd(cp) == DT_ALL) return ALL_MONTHS;
+   kw_node *p;
 
-   if (year_ok && get_keywd(cp) == DT_YEAR) return ENTIRE_YEAR;
-   
-   if (numeric_ok && isdigit((int)*cp)) mm = atoi(cp);
-   else {
-      /* accept month names in the active 'input' language only */
-      for (mm = JAN; mm <= DEC; mm++) {
-         /* Need to shorten length of string compare by 1 character when the
-            last character is '*' so that event like '2nd Sunday in May*'
-            don't report 'no match for wildcard'.
-         */
-         if ((ci_strncmp(cp, months_ml[input_language][mm-1], 
-                         strlen(cp) - ((*(cp + strlen(cp) - 1) == '*') ? 1 : 0)) == 0))
-            break;
+   if (n_kw_nodes == max_kw_nodes) {
+      max_kw_nodes = max_kw_nodes ? 2 * max_kw_nodes : 256;
+      if ((kw_nodes = (kw_node *) realloc(kw_nodes, max_kw_nodes * sizeof(kw_node))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
       }
+      if (n_kw_nodes == 0) n_kw_nodes = 1;   /* node 0 means "none" */
    }
-   
-   return mm >= JAN && mm <= DEC ? mm : NOT_MONTH;
+
+   p = &kw_nodes[n_kw_nodes];
+   p->c = c;
+   p->term = p->sub = NO_KEYWORD;
+   p->child = p->next = 0;
+
+   return n_kw_nodes++;
 }
 
 /* ---------------------------------------------------------------------------
 
-   get_weekday
+   add_keyword
 
    Notes:
 
-      This routine looks up the specified string in the weekday list.
-
-      It returns 0-6 if valid, 'NOT_WEEKDAY' if not.  If 'wild_ok' flag is
-      set, accept "day", "weekday", "workday", "holiday", or moon phase and
-      return appropriate value.
+      This routine adds 'name' to the keyword trie rooted at 'root' as table
+      entry 'index'.  When several names match a word, the lookup routines
+      return the one with the lowest index, which is the one the table
+      search they replace would have found first.
 
 */
-int get_weekday (char *cp, int wild_ok)
+static void add_keyword (int root, char *name, int index)
 {
-   int w;
-   
-   if (!cp) return NOT_WEEKDAY;
-
-   if (wild_ok) {   /* try wildcards first */
-      for (w = WILD_FIRST_WKD; w <= WILD_LAST_WKD; w++) {
-         if (ci_strncmp(cp, days[w], strlen(days[w])) == 0) return w;
+   int node, child;
+   char c;
+
+   for (node = root; ; node = child) {
+      if (index < kw_nodes[node].sub) kw_nodes[node].sub = index;
+      if (*name == '\0') break;
+
+      /* fold case exactly as ci_strncmp() does */
+      c = tolower(*name++);
+      for (child = kw_nodes[node].child; child && kw_nodes[child].c != c;
+           child = kw_nodes[child].next)
+         ;
+      if (!child) {
+         child = new_kw_node(c);
+         kw_nodes[child].next = kw_nodes[node].child;
+         kw_nodes[node].child = child;
       }
-      if ((w = get_phase(cp)) != MOON_OTHER) return w + WILD_FIRST_MOON;
-   }
-   
-   /* accept day names in the active 'input' language only */
-   for (w = SUN; w <= SAT; w++) {
-      int compare_count;
-      /* To allow for proper detection of the day-of-week name in constructs
-         from the configuration file like 'all Fridays in Oct' (i.e. with the
-         plural form of the day-of-week name), we need to compare the fewest
-         number of characters of the 2 strings.
-      */
-      compare_count = 
-         (strlen(cp) < strlen(days_ml[input_language][w])) ? 
-         strlen(cp) : strlen(days_ml[input_language][w]);
-      
-      if (ci_strncmp(cp, days_ml[input_language][w], compare_count) == 0) return w;
    }
-   
-   return NOT_WEEKDAY;
+
+   if (index < kw_nodes[node].term) kw_nodes[node].term = index;
 }
 
 /* ---------------------------------------------------------------------------
 
-   get_keywd
+   build_kw_tries
 
    Notes:
 
-      This routine looks up the specified string in the 'miscellaneous keyword' list.
-
-      It returns the keyword code if valid, 'DT_OTHER' if not.
+      This routine builds the tries for the language-independent keyword
+      tables.
 
 */
-int get_keywd (char *cp)
+static void build_kw_tries (void)
 {
    KWD *k;
-   
-   if (!cp) return DT_OTHER;
-   
-   for (k = keywds; k->name && ci_strncmp(cp, k->name, strlen(k->name)); k++)
-      ;
-   
-   return k->code;
+   KWD_O *o;
+   KWD_F *f;
+   KWD_H *h;
+   int w;
+
+   keywd_trie = new_kw_node(0);
+   for (k = keywds; k->name; k++) add_keyword(keywd_trie, k->name, k - keywds);
+
+   ordinal_trie = new_kw_node(0);
+   for (o = ordinals; o->name; o++) add_keyword(ordinal_trie, o->name, o - ordinals);
+
+   phase_trie = new_kw_node(0);
+   for (k = phases; k->name; k++) add_keyword(phase_trie, k->name, k - phases);
+
+   prep_trie = new_kw_node(0);
+   for (k = preps; k->name; k++) add_keyword(prep_trie, k->name, k - preps);
+
+   pp_trie = new_kw_node(0);
+   for (f = pp_info; f->name; f++) add_keyword(pp_trie, f->name, f - pp_info);
+
+   predef_trie = new_kw_node(0);
+   for (h = predef_events; h->name; h++) add_keyword(predef_trie, h->name, h - predef_events);
+
+   wild_trie = new_kw_node(0);
+   for (w = WILD_FIRST_WKD; w <= WILD_LAST_WKD; w++) add_keyword(wild_trie, days[w], w);
 }
 
 /* ---------------------------------------------------------------------------
 
-   get_ordinal
+   find_keyword
 
    Notes:
 
-      This routine looks up the specified string in the ordinal list.
+      This routine looks up the word 'cp' (case-insensitive) in the keyword
+      trie rooted at 'root', matching it against the names as specified by
+      'mode' (KW_NAME_PREFIX, KW_WORD_PREFIX, etc.).  'n' is the number of
+      characters of the word to consider for 'KW_WORD_PREFIX' and the minimum
+      number which must match for 'KW_MIN_LEN'.
 
-      It returns the ordinal code (and fills in the ordinal value) if valid.
-      It returns 'ORD_OTHER' if invalid.
+      It returns the lowest table index of the matching names, or
+      'NO_KEYWORD' if none match.
+
+*/
+static int find_keyword (int root, char *cp, int n, int mode)
+{
+   int node, best, i;
+   char c;
+
+   best = NO_KEYWORD;
+
+   for (node = root, i = 0; ; i++) {
+      /* names ending here are prefixes of the word */
+      if ((mode == KW_NAME_PREFIX || mode == KW_EITHER) && kw_nodes[node].term < best)
+         best = kw_nodes[node].term;
+
+      /* first 'n' characters match: any name continuing from here will do */
+      if (mode == KW_MIN_LEN && i == n) return kw_nodes[node].sub;
+
+      if (cp[i] == '\0' || (mode == KW_WORD_PREFIX && i == n)) break;
+
+      c = tolower(cp[i]);
+      for (node = kw_nodes[node].child; node && kw_nodes[node].c != c;
+           node = kw_nodes[node].next)
+         ;
+      if (!node) return best;   /* no name continues with this character */
+   }
+
+   switch (mode) {
+   case KW_WORD_PREFIX:
+      return kw_nodes[node].sub;
+   case KW_EITHER:
+      return kw_nodes[node].sub < best ? kw_nodes[node].sub : best;
+   case KW_EXACT:
+   case KW_MIN_LEN:   /* word is shorter than 'n' characters */
+      return kw_nodes[node].term;
+   default:
+      return best;
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_month
+
+   Notes:
+
+      This routine converts an alpha (or, optionally, numeric) string to a month.
+
+      It returns 1..12 if valid, 'NOT_MONTH' if not, 'ALL_MONTHS' if "all",
+      'ENTIRE_YEAR' if "year".
+
+      The first parameter is the string to convert.
+
+      The second parameter is a flag to indicate that a numeric string can be
+      accepted.
+
+      The third parameter is a flag to indicate that the string "year" can be
+      accepted.
+
+*/
+int get_month (char *cp, int numeric_ok, int year_ok)
+{
+   int mm, len;
+   
+   if (!cp) return NOT_MONTH;
+
+   if (get_keywd(cp) == DT_ALL) return ALL_MONTHS;
+
+   if (year_ok && get_keywd(cp) == DT_YEAR) return ENTIRE_YEAR;
+   
+   if (numeric_ok && isdigit((int)*cp)) mm = atoi(cp);
+   else {
+      /* accept month names in the active 'input' language only */
+      if (!month_trie[input_language]) {
+         if (!kw_nodes) build_kw_tries();
+         month_trie[input_language] = new_kw_node(0);
+         for (mm = JAN; mm <= DEC; mm++)
+            add_keyword(month_trie[input_language], months_ml[input_language][mm-1], mm);
+      }
+
+      /* Need to shorten length of string compare by 1 character when the
+         last character is '*' so that event like '2nd Sunday in May*'
+         don't report 'no match for wildcard'.
+      */
+      len = strlen(cp);
+      if (len > 0 && cp[len - 1] == '*') len--;
+
+      mm = find_keyword(month_trie[input_language], cp, len, KW_WORD_PREFIX);
+   }
+   
+   return mm >= JAN && mm <= DEC ? mm : NOT_MONTH;
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_weekday
+
+   Notes:
+
+      This routine looks up the specified string in the weekday list.
+
+      It returns 0-6 if valid, 'NOT_WEEKDAY' if not.  If 'wild_ok' flag is
+      set, accept "day", "weekday", "workday", "holiday", or moon phase and
+      return appropriate value.
+
+*/
+int get_weekday (char *cp, int wild_ok)
+{
+   int w;
+   
+   if (!cp) return NOT_WEEKDAY;
+
+   if (!kw_nodes) build_kw_tries();
+
+   if (wild_ok) {   /* try wildcards first */
+      if ((w = find_keyword(wild_trie, cp, 0, KW_NAME_PREFIX)) != NO_KEYWORD) return w;
+      if ((w = get_phase(cp)) != MOON_OTHER) return w + WILD_FIRST_MOON;
+   }
+   
+   /* accept day names in the active 'input' language only */
+   if (!day_trie[input_language]) {
+      day_trie[input_language] = new_kw_node(0);
+      for (w = SUN; w <= SAT; w++)
+         add_keyword(day_trie[input_language], days_ml[input_language][w], w);
+   }
+
+   /* To allow for proper detection of the day-of-week name in constructs
+      from the configuration file like 'all Fridays in Oct' (i.e. with the
+      plural form of the day-of-week name), we need to compare the fewest
+      number of characters of the 2 strings.
+   */
+   w = find_keyword(day_trie[input_language], cp, 0, KW_EITHER);
+   
+   return w == NO_KEYWORD ? NOT_WEEKDAY : w;
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_keywd
+
+   Notes:
+
+      This routine looks up the specified string in the 'miscellaneous keyword' list.
+
+      It returns the keyword code if valid, 'DT_OTHER' if not.
+
+*/
+int get_keywd (char *cp)
+{
+   int i;
+   
+   if (!cp) return DT_OTHER;
+   
+   if (!kw_nodes) build_kw_tries();
+
+   if ((i = find_keyword(keywd_trie, cp, 0, KW_NAME_PREFIX)) == NO_KEYWORD) return DT_OTHER;
+   
+   return keywds[i].code;
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_ordinal
+
+   Notes:
+
+      This routine looks up the specified string in the ordinal list.
+
+      It returns the ordinal code (and fills in the ordinal value) if valid.
+      It returns 'ORD_OTHER' if invalid.
 
 */
 int get_ordinal (char *cp, int *pval)
 {
-   KWD_O *o;
-   int val;
+   int i, val;
    char **psuf;
    
    if (!cp) return ORD_OTHER;
@@ -1351,11 +2685,15 @@ int get_ordinal (char *cp, int *pval)
    
    /* look for word in ordinals list */
 
-   for (o = ordinals; o->name && ci_strncmp(cp, o->name, MIN_ORD_LEN); o++)
-      ;
+   if (!kw_nodes) build_kw_tries();
+
+   if ((i = find_keyword(ordinal_trie, cp, MIN_ORD_LEN, KW_MIN_LEN)) == NO_KEYWORD) {
+      *pval = 0;
+      return ORD_OTHER;
+   }
    
-   *pval = o->value;
-   return o->code;
+   *pval = ordinals[i].value;
+   return ordinals[i].code;
 }
 
 /* ---------------------------------------------------------------------------
@@ -1370,14 +2708,15 @@ int get_ordinal (char *cp, int *pval)
 */
 int get_phase (char *cp)
 {
-   KWD *p;
+   int i;
    
    if (!cp) return MOON_OTHER;
    
-   for (p = phases; p->name && ci_strcmp(cp, p->name); p++)
-      ;
+   if (!kw_nodes) build_kw_tries();
+
+   if ((i = find_keyword(phase_trie, cp, 0, KW_EXACT)) == NO_KEYWORD) return MOON_OTHER;
    
-   return p->code;
+   return phases[i].code;
 }
 
 /* ---------------------------------------------------------------------------
@@ -1393,14 +2732,15 @@ int get_phase (char *cp)
 */
 int get_prep (char *cp)
 {
-   KWD *p;
+   int i;
    
    if (!cp) return PR_OTHER;
 
-   for (p = preps; p->name && ci_strncmp(cp, p->name, MIN_PREP_LEN); p++)
-      ;
+   if (!kw_nodes) build_kw_tries();
+
+   if ((i = find_keyword(prep_trie, cp, MIN_PREP_LEN, KW_MIN_LEN)) == NO_KEYWORD) return PR_OTHER;
    
-   return p->code;
+   return preps[i].code;
 }
 
 /* ---------------------------------------------------------------------------
@@ -1416,13 +2756,13 @@ int get_prep (char *cp)
 */
 int get_token (char *token)
 {
-   KWD_F *p;
+   int i;
    
-   for (p = pp_info; p->name; p++) {
-      if (ci_strncmp(token, p->name, MIN_PPTOK_LEN) == 0) return p - pp_info;
-   }
+   if (!kw_nodes) build_kw_tries();
+
+   if ((i = find_keyword(pp_trie, token, MIN_PPTOK_LEN, KW_MIN_LEN)) == NO_KEYWORD) return PP_OTHER;
    
-   return PP_OTHER;
+   return i;
 }
 
 /* ---------------------------------------------------------------------------
@@ -1438,13 +2778,13 @@ int get_token (char *token)
 */
 int get_predef_event (char *cp)
 {
-   KWD_H *p;
+   int i;
    
-   for (p = predef_events; p->name; p++) {
-      if (ci_strncmp(cp, p->name, strlen(p->name)) == 0) return p - predef_events;
-   }
+   if (!kw_nodes) build_kw_tries();
+
+   if ((i = find_keyword(predef_trie, cp, 0, KW_NAME_PREFIX)) == NO_KEYWORD) return NOT_PREDEF_EVENT;
    
-   return NOT_PREDEF_EVENT;
+   return i;
 }
 
 /* ---------------------------------------------------------------------------
@@ -1516,29 +2856,258 @@ int date_type (char *cp, int *pn, int *pv)
       It will optionally create it (based on the second parameter) if not
       present.
 
+      Years within MIN_YR..MAX_YR are found directly through 'year_tab[]';
+      the linked list (kept in ascending order for 'cleanup()' and the
+      writers) is only searched for years outside that range.
+
 */
 year_info *find_year (int year, int insert)
 {
    year_info *pyear, *plast, *p;
+   int y;
    
-   for (plast = NULL, pyear = head;   /* search linked list */
-        pyear && pyear->year < year;
-        plast = pyear, pyear = pyear->next)
-      ;
-   
-   if (pyear && pyear->year == year) return pyear;   /* found - return it */
+   if (year >= MIN_YR && year <= MAX_YR) {
+      if ((pyear = year_tab[year - MIN_YR]) != NULL || !insert) return pyear;
+
+      /* find the preceding year in the list - ordinarily adjacent */
+      for (y = year - 1; y >= MIN_YR && year_tab[y - MIN_YR] == NULL; y--)
+         ;
+      if (y >= MIN_YR) plast = year_tab[y - MIN_YR];
+      else {
+         for (plast = NULL, p = head; p && p->year < year; plast = p, p = p->next)
+            ;
+      }
+      pyear = plast ? plast->next : head;
+   }
+   else {
+      for (plast = NULL, pyear = head;   /* search linked list */
+           pyear && pyear->year < year;
+           plast = pyear, pyear = pyear->next)
+         ;
+      
+      if (pyear && pyear->year == year) return pyear;   /* found - return it */
+   }
 
    if (insert) {   /* not found - insert it if requested */
       int i;
-      p = (year_info *) alloc((int) sizeof(year_info));   /* create new record */
+      p = (year_info *) arena_alloc((int) sizeof(year_info));   /* create new record */
       p->year = year;
       for (i = 0; i < (int)(ARRAYSIZE(p->month)); i++) p->month[i] = NULL;
       p->next = pyear;   /* link it in */
+      if (year >= MIN_YR && year <= MAX_YR) year_tab[year - MIN_YR] = p;
       return *(plast ? &plast->next : &head) = p;
    }
    else return NULL;
 }
 
+/* ---------------------------------------------------------------------------
+
+   intern_text
+
+   Notes:
+
+      This routine returns a shared copy of the specified event text, so
+      that text entered for many days (e.g., by wildcard or "year all"
+      events) is stored only once.  It also returns the text's
+      'ci_strhash()' value via 'pci_hash'.
+
+      The copies are allocated from the arena and must not be modified.
+
+*/
+char *intern_text (char *text, unsigned long *pci_hash)
+{
+   text_entry *pe, **pnew;
+   unsigned long h = 5381;
+   char *p;
+   int i, b, len;
+
+   for (p = text; *p; p++) h = (h << 5) + h + (*p & CHAR_MSK);
+   len = (int) (p - text);
+
+   if (text_tab) {
+      for (pe = text_tab[h & (text_tab_size - 1)]; pe; pe = pe->next) {
+         if (pe->hash == h && strcmp((char *) (pe + 1), text) == 0) {
+            *pci_hash = pe->ci_hash;
+            return (char *) (pe + 1);
+         }
+      }
+   }
+
+   if (text_count >= text_tab_size) {   /* double table and rehash */
+      i = text_tab_size ? 2 * text_tab_size : 256;
+      pnew = (text_entry **) arena_alloc(i * (int) sizeof(text_entry *));
+      while (--text_tab_size >= 0) {
+         while ((pe = text_tab[text_tab_size]) != NULL) {
+            text_tab[text_tab_size] = pe->next;
+            b = (int) (pe->hash & (i - 1));
+            pe->next = pnew[b];
+            pnew[b] = pe;
+         }
+      }
+      text_tab = pnew;
+      text_tab_size = i;
+   }
+
+   pe = (text_entry *) arena_alloc((int) sizeof(text_entry) + len + 1);
+   strcpy((char *) (pe + 1), text);
+   pe->hash = h;
+   pe->ci_hash = *pci_hash = ci_strhash(text);
+   b = (int) (h & (text_tab_size - 1));
+   pe->next = text_tab[b];
+   text_tab[b] = pe;
+   text_count++;
+
+   return (char *) (pe + 1);
+}
+
+/* ---------------------------------------------------------------------------
+
+   store_text
+
+   Notes:
+
+      This routine returns the shared copy of the specified event text to be
+      stored in the data structure, prepending the font shift sequence for
+      the current font style when generating PostScript output.  It also
+      returns the stored text's 'ci_strhash()' value via 'pci_hash'.
+
+*/
+static char *store_text (char *text, unsigned long *pci_hash)
+{
+   static char *ftext = NULL;
+   static int ftext_size = 0;
+   char *tface;
+
+   if (fontstyle[0] == ROMAN || output_type != OUTPUT_PS) {
+      /* share text intact (no font shift) */
+      return intern_text(text, pci_hash);
+   }
+
+   /* prepend font shift sequence to text */
+   tface = fontstyle[0] == BOLD   ? BOLD_FONT : fontstyle[0] == ITALIC ? ITALIC_FONT : "";
+   strcpy(grow_buf(&ftext, &ftext_size, (int) (strlen(tface) + strlen(text)) + 2), tface);
+   if (*tface) strcat(ftext, " ");
+   strcat(ftext, text);
+
+   return intern_text(ftext, pci_hash);
+}
+
+/* ---------------------------------------------------------------------------
+
+   rehash_day_info
+
+   Notes:
+
+      This routine rebuilds the hash table of the specified month from its
+      first 'n' entries.
+
+      Entries are pushed onto the front of their bucket in the order of the
+      array, so that among entries with the same day and text the most
+      recent one is found first.
+
+*/
+static void rehash_day_info (month_info *pmonth, int n)
+{
+   day_info *pe;
+   int i, b;
+
+   for (i = 0; i < pmonth->hash_size; i++) pmonth->hash_tab[i] = -1;
+
+   for (i = 0, pe = pmonth->event; i < n; i++, pe++) {
+      if (pe->deleted) continue;
+      b = DAY_HASH(pmonth, pe->day, pe->hash);
+      pe->hnext = pmonth->hash_tab[b];
+      pmonth->hash_tab[b] = i;
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   hash_day_info
+
+   Notes:
+
+      This routine adds the last entry (whose 'day' and 'hash' members are
+      already set) of the specified month to its hash table, doubling the
+      table when it becomes full.
+
+*/
+void hash_day_info (month_info *pmonth)
+{
+   int i = pmonth->nevents - 1, b;
+   day_info *pe = &pmonth->event[i];
+
+   if (pmonth->nevents > pmonth->hash_size) {
+      pmonth->hash_size = pmonth->hash_size ? 2 * pmonth->hash_size : DAY_HASH_INIT;
+      pmonth->hash_tab = (int *) arena_alloc(pmonth->hash_size * (int) sizeof(int));
+      rehash_day_info(pmonth, i);
+   }
+
+   b = DAY_HASH(pmonth, pe->day, pe->hash);
+   pe->hnext = pmonth->hash_tab[b];
+   pmonth->hash_tab[b] = i;
+}
+
+/* ---------------------------------------------------------------------------
+
+   sort_day_info
+
+   Notes:
+
+      This routine sorts the entries of the specified month by day
+      (preserving their order within each day), drops the deleted ones, and
+      sets up the 'first[]' index for use by 'FIRST_DAY_INFO()' and
+      'END_DAY_INFO()'.
+
+*/
+void sort_day_info (month_info *pmonth)
+{
+   day_info *pnew, *pe;
+   int i, n, pos[LAST_NOTE_DAY];
+
+   for (i = n = 0; i < LAST_NOTE_DAY; i++) {
+      pos[i] = pmonth->first[i] = n;
+      n += pmonth->ntext[i];
+   }
+   pmonth->first[LAST_NOTE_DAY] = n;
+
+   pnew = n ? (day_info *) arena_alloc(n * (int) sizeof(day_info)) : NULL;
+   for (i = 0, pe = pmonth->event; i < pmonth->nevents; i++, pe++) {
+      if (! pe->deleted) pnew[pos[pe->day]++] = *pe;
+   }
+
+   pmonth->event = pnew;
+   pmonth->nevents = pmonth->max_events = n;
+   pmonth->unsorted = FALSE;
+   if (pmonth->hash_tab) rehash_day_info(pmonth, n);
+}
+
+/* ---------------------------------------------------------------------------
+
+   find_month_info
+
+   Notes:
+
+      This routine returns the month_info node for the specified month and
+      year (NULL if none), sorting its entries first if necessary.
+
+      The output routines use this to walk the entries for each day with
+      'FIRST_DAY_INFO()' and 'END_DAY_INFO()'.
+
+*/
+month_info *find_month_info (int month, int year)
+{
+   year_info *py;
+   month_info *pm;
+
+   if ((py = find_year(year, FALSE)) == NULL || (pm = py->month[month-1]) == NULL) {
+      return NULL;
+   }
+   if (pm->unsorted) sort_day_info(pm);
+
+   return pm;
+}
+
 /* ---------------------------------------------------------------------------
 
    enter_day_info
@@ -1555,20 +3124,29 @@ year_info *find_year (int year, int insert)
       If symbol 'FEB_29_OK' is non-zero (see 'pcaldefs.h'), it will silently
       ignore Feb 29 of common year.
 
+      Only holidays are entered for days outside the months to be printed
+      (cf. 'read_datefile()'): the other events would never be seen, but
+      holidays may still affect wildcards such as "workday" in later date
+      specifications which reach into the printed months.
+
 */
 int enter_day_info (int m, int d, int y, int text_type, char **pword)
 {
    static year_info *pyear;
    static int prev_year = 0;
    month_info *pmonth;
-   day_info *pday, *plast;
-   int is_holiday = text_type == HOLIDAY_TEXT;
-   char text[LINSIZ], *tface;
+   day_info *pday;
+   int i, is_holiday = text_type == HOLIDAY_TEXT;
+   char *text;
 
    if (! is_valid(m, d >= FIRST_NOTE_DAY && text_type == NOTE_TEXT ? 1 : d, y)) {
       return (m == FEB && d == 29 && FEB_29_OK) ? PARSE_OK : PARSE_INVDATE;
    }
 
+   if (! is_holiday && (MONTH_INDEX(m, y) < window_first || MONTH_INDEX(m, y) > window_last)) {
+      return PARSE_OK;   /* not printed */
+   }
+
    if (y != prev_year) {   /* avoid unnecessary year lookup */
       pyear = find_year(y, 1);
    }
@@ -1576,19 +3154,20 @@ int enter_day_info (int m, int d, int y, int text_type, char **pword)
    --m, --d;   /* adjust for use as subscripts */
 
    if ((pmonth = pyear->month[m]) == NULL) {   /* find/create month record */
-      int i;
-      pyear->month[m] = pmonth = (month_info *) alloc((int) sizeof(month_info));
-      for (i = 0; i < (int)(ARRAYSIZE(pmonth->day)); i++) pmonth->day[i] = NULL;
+      pyear->month[m] = pmonth = (month_info *) arena_alloc((int) sizeof(month_info));
    }
 
-   if (is_holiday) pmonth->holidays |= (1L << d);
+   if (is_holiday) {
+      pmonth->holidays |= (1L << d);
+      mark_holiday(m+1, d+1, y, TRUE);
+   }
 
    /* insert text for day at end of list (preserving the order of entry for
       multiple lines on same day); eliminate those differing only in spacing
       and capitalization from existing entries
    */
 
-   copy_text(text, pword);   /* consolidate text from lbuf into text */
+   text = join_text(pword);   /* consolidate text from lbuf */
 
    if (DEBUG(DEBUG_DATES)) {
       char *p;
@@ -1600,46 +3179,50 @@ int enter_day_info (int m, int d, int y, int text_type, char **pword)
    }
 
 #if KEEP_NULL_LINES   /* preserve blank text lines in output */
-   if (*text == '\0' && pmonth->day[d]) strcpy(text, BLANK_TEXT);
+   if (*text == '\0' && pmonth->ntext[d]) text = BLANK_TEXT;
 #endif
 
    /* check that non-null text is unique */
    
    if (*text) {
-      for (plast = NULL, pday = pmonth->day[d];
-           pday;
-           plast = pday, pday = pday->next) {
+      unsigned long h = ci_strhash(text);
 
-         if (ci_strcmp(pday->text, text) == 0
 #if KEEP_NULL_LINES
-             && strcmp(text, BLANK_TEXT) != 0
+      if (strcmp(text, BLANK_TEXT) != 0)
 #endif
-             ) {
-            pday->is_holiday |= is_holiday;
-            return PARSE_OK;
+      {
+         for (i = pmonth->hash_tab ? pmonth->hash_tab[DAY_HASH(pmonth, d, h)] : -1;
+              i >= 0;
+              i = pday->hnext) {
+            pday = &pmonth->event[i];
+            if (pday->day == d && pday->hash == h && ci_strcmp(pday->text, text) == 0) {
+               if (is_holiday && ! pday->is_holiday) pmonth->nholidays[d]++;
+               pday->is_holiday |= is_holiday;
+               return PARSE_OK;
+            }
          }
       }
       
       /* unique - add to end of list */
       
-      pday = (day_info *) alloc(sizeof(day_info));
+      if (pmonth->nevents >= pmonth->max_events) {   /* grow entry array */
+         pday = pmonth->event;
+         pmonth->max_events = pmonth->max_events ? 2 * pmonth->max_events : 8;
+         pmonth->event = (day_info *) arena_alloc(pmonth->max_events * (int) sizeof(day_info));
+         if (pmonth->nevents) memcpy(pmonth->event, pday, pmonth->nevents * sizeof(day_info));
+      }
+      pday = &pmonth->event[pmonth->nevents++];
+      pmonth->unsorted = TRUE;
+      pmonth->ntext[d]++;
+      pday->day = d;
       pday->is_holiday = is_holiday;
+      if (is_holiday) pmonth->nholidays[d]++;
       
-      if (fontstyle[0] == ROMAN || output_type != OUTPUT_PS) {
-         /* copy text intact (no font shift) */
-         strcpy(pday->text = (char *) alloc(strlen(text)+1), text);
-      } 
-      else {
-         /* prepend font shift sequence to text */
-         tface = fontstyle[0] == BOLD   ? BOLD_FONT : fontstyle[0] == ITALIC ? ITALIC_FONT : "";
-         pday->text = (char *) alloc(strlen(tface) + strlen(text) + 2);
-         strcpy(pday->text, tface);
-         if (*tface) strcat(pday->text, " ");
-         strcat(pday->text, text);
-      }
+      pday->text = store_text(text, &pday->hash);
       
-      pday->next = NULL;
-      *(plast ? &plast->next : &pmonth->day[d]) = pday;
+      /* hash on the stored text, which is what later entries are compared
+         against */
+      hash_day_info(pmonth);
    }
    
    return PARSE_OK;
@@ -1669,10 +3252,10 @@ int delete_day_info (int m, int d, int y, int text_type, char **pword)
    static year_info *pyear;
    static int prev_year = 0;
    month_info *pmonth;
-   day_info *pday, *plast, *pdel = NULL, *pldel = NULL;
+   day_info *pday, *pdel = NULL;
    int is_holiday = FALSE;
    int found = FALSE;
-   char text[LINSIZ];
+   char *text;
    
    if (! is_valid(m, d >= FIRST_NOTE_DAY && text_type == NOTE_TEXT ? 1 : d, y)) {
       return (m == FEB && d == 29 && FEB_29_OK) ? PARSE_OK : PARSE_INVDATE;
@@ -1687,13 +3270,13 @@ int delete_day_info (int m, int d, int y, int text_type, char **pword)
    if ((pmonth = pyear->month[m]) == NULL) {   /* ignore delete if no entries exist */
       return PARSE_OK;
    }
-   if (pmonth->day[d] == NULL) return PARSE_OK;
+   if (pmonth->ntext[d] == 0) return PARSE_OK;
    
    /* delete text for day from list ignoring differences in only spacing and
       capitalization in the existing entry.
    */
    
-   copy_text(text, pword); /* consolidate text from lbuf into text */
+   text = join_text(pword);   /* consolidate text from lbuf */
    
    if (DEBUG(DEBUG_DATES)) {
       char *p;
@@ -1705,30 +3288,52 @@ int delete_day_info (int m, int d, int y, int text_type, char **pword)
    }
    
 #if KEEP_NULL_LINES   /* preserve blank text lines in output */
-   if (*text == '\0' && pmonth->day[d]) strcpy(text, BLANK_TEXT);
+   if (*text == '\0' && pmonth->ntext[d]) text = BLANK_TEXT;
 #endif
 
-   /* check if non-null and find entry to delete */
+   /* check if non-null and find entry to delete: the most recently entered
+      match is the first one in its hash bucket; all matches are excluded
+      when recalculating 'is_holiday'
+   */
    
-   if (*text) {
-      for (plast = NULL, pday = pmonth->day[d];
-           pday;
-           plast = pday, pday = pday->next) {
-         if (ci_strcmp(pday->text, text) == 0) {
-            found = TRUE;
-            pdel = pday;
-            pldel = plast;
-         } 
-         else is_holiday |= pday->is_holiday;
+   if (*text && pmonth->hash_tab) {
+      unsigned long h = ci_strhash(text);
+      int i, *plink, *pldel = NULL;
+      int nhol = pmonth->nholidays[d];
+
+      for (plink = &pmonth->hash_tab[DAY_HASH(pmonth, d, h)];
+           (i = *plink) >= 0;
+           plink = &pday->hnext) {
+         pday = &pmonth->event[i];
+         if (pday->day == d && pday->hash == h && ci_strcmp(pday->text, text) == 0) {
+            if (! found) {
+               found = TRUE;
+               pdel = pday;
+               pldel = plink;
+            }
+            nhol -= pday->is_holiday;
+         }
+      }
+      is_holiday = nhol > 0;
+      if (! is_holiday && nspans > 0) {   /* a holiday span may cover it */
+         date_str date;
+         date.mm = m+1, date.dd = d+1, date.yy = y;
+         is_holiday = span_holiday(day_serial(&date));
       }
       
       if (found) {
-         if (pldel) pldel->next = pdel->next;
-         else pmonth->day[d] = pdel->next;
-         free(pdel);
+         /* unlink the entry from its hash bucket and flag it; it is dropped
+            from the array when the month is next sorted (cf.
+            sort_day_info()) */
+         *pldel = pdel->hnext;
+         pdel->deleted = TRUE;
+         pmonth->unsorted = TRUE;
+         pmonth->ntext[d]--;
+         if (pdel->is_holiday) pmonth->nholidays[d]--;
          
          if (is_holiday) pmonth->holidays |= (1L << d);
          else pmonth->holidays &= ~(1L << d);
+         mark_holiday(m+1, d+1, y, is_holiday);
       }
    }
    
@@ -1737,631 +3342,2388 @@ int delete_day_info (int m, int d, int y, int text_type, char **pword)
 
 /* ---------------------------------------------------------------------------
 
-   enter_note
+   get_month_info
 
    Notes:
 
-      This routine acts as a wrapper around 'enter_day_info()' for entering
-      note text.
+      This routine returns the month_info node for the specified month and
+      year, creating it (and the year_info node) if necessary.
 
 */
-int enter_note (int mm, char **pword, int n)
+static month_info *get_month_info (int mm, int yy)
 {
-   int valid;
-   
-   /* expand "note all" into all twelve months */
-   if (mm == ALL_MONTHS || mm == ENTIRE_YEAR) {
-      valid = FALSE;   /* is at least one note box valid? */
-      for (mm = JAN; mm <= DEC; mm++) {
-         valid |= enter_day_info(mm,
-                                 note_day(mm, n, curr_year),
-                                 curr_year, NOTE_TEXT,
-                                 pword+1) == PARSE_OK;
-      }
-      return valid ? PARSE_OK : PARSE_NOMATCH;
+   year_info *pyear = find_year(yy, 1);
+
+   if (pyear->month[mm-1] == NULL) {
+      pyear->month[mm-1] = (month_info *) arena_alloc((int) sizeof(month_info));
    }
-   
-   return enter_day_info(mm, note_day(mm, n, curr_year), curr_year, NOTE_TEXT, pword+1);
+   return pyear->month[mm-1];
 }
 
 /* ---------------------------------------------------------------------------
 
-   process_event_specification
+   grow_span_index
 
    Notes:
 
-      This routine adds or deletes events (including the specific date and its
-      associated text) to/from the big linked list structure (described in
-      greater detail in 'pcaldefs.h').
+      This routine makes sure that the span index arrays (cf.
+      'build_span_index()') have room for every span in 'span_pool'.
 
 */
-int process_event_specification (char **pword, int *ptext_type, char ***pptext)
+static void grow_span_index (void)
 {
-   int rtn, match;
-   date_str *pd;
-   
-   /* parse date spec and enter information for each match */
-   if ((rtn = parse_date(pword, ptext_type, pptext)) == PARSE_OK) {
-      match = FALSE;
-      for (pd = candidate_dates; pd->mm; pd++) {
+   if (max_indexed >= max_spans) return;
 
-         if (pd->yy == -1) {
-            if (DEBUG(DEBUG_DATES)) {
-               fprintf(stderr, "Bypassing invalidated candidate date: yyyy-%02d-%02d.\n", pd->mm, pd->dd);
-            }
-         }
-         else {
-            if (DEBUG(DEBUG_DATES)) {
-               fprintf(stderr, "Processing candidate date: %4d-%02d-%02d\n", pd->yy, pd->mm, pd->dd);
-            }
-            
-            if (delete_entry) {
-               match |= delete_day_info(pd->mm, pd->dd, pd->yy, *ptext_type, *pptext) == PARSE_OK;
-            }
-            else {
-               match |= enter_day_info(pd->mm, pd->dd, pd->yy, *ptext_type, *pptext) == PARSE_OK;
-            }
-         }
-      }
-      rtn = match ? PARSE_OK : PARSE_NOMATCH;
+   max_indexed = max_spans;
+   if ((span_order = (int *) realloc(span_order, max_indexed * sizeof(int))) == NULL ||
+       (span_reach = (long *) realloc(span_reach, max_indexed * sizeof(long))) == NULL ||
+       (span_hits = (int *) realloc(span_hits, max_indexed * sizeof(int))) == NULL) {
+      fprintf(stderr, E_ALLOC_ERR, progname);
+      exit(EXIT_FAILURE);
    }
-   return rtn;
 }
 
-/*
- * Date parsing routines:
- */
-
 /* ---------------------------------------------------------------------------
 
-   parse_ord
+   index_span
 
    Notes:
 
-      This routine parses an ordinal date specification (e.g. "first Monday in
-      September", "every Sunday in October", "last workday in all").
+      This routine adds span 'i' to the span index, after any others with
+      the same first day (so that those stay in order of entry), and brings
+      'span_reach[]' up to date from that point on.
 
-      It returns 'PARSE_OK' if line syntax is valid, 'PARSE_INVLINE' if not.  
+      Spans are usually entered in date order, which makes this cheap.
 
-      It writes all matching dates (if any) to the global array
-      'candidate_dates[]'.  It terminates the date list with a null entry.
+*/
+static void index_span (int i)
+{
+   int lo = 0, hi = nindexed, mid;
+   long first = span_pool[i].first;
 
-      The first parameter is a valid ordinal code (from 'get_ordinal()').
+   while (lo < hi) {   /* first position with a later first day */
+      mid = (lo + hi) / 2;
+      if (span_pool[span_order[mid]].first <= first) lo = mid + 1;
+      else hi = mid;
+   }
 
-      The second parameter is the ordinal value (also from 'get_ordinal()').
+   memmove(span_order + lo + 1, span_order + lo, (nindexed - lo) * sizeof(int));
+   span_order[lo] = i;
 
-      The third parameter is a pointer to the word after the ordinal.
+   for (nindexed++; lo < nindexed; lo++) {
+      span_reach[lo] = span_pool[span_order[lo]].last;
+      if (lo > 0 && span_reach[lo-1] > span_reach[lo]) span_reach[lo] = span_reach[lo-1];
+   }
+   hits_day = NO_DAY;
+}
+
+/* ---------------------------------------------------------------------------
+
+   build_span_index
+
+   Notes:
+
+      This routine (re)builds the index of the spans which have not been
+      deleted, if it is out of date.  'span_order[]' lists them by first
+      day and 'span_reach[k]' is the latest last day of any of
+      'span_order[0..k]', so the spans covering a given day are found by a
+      binary search followed by a backward scan which stops as soon as no
+      earlier span can reach that day (cf. 'find_spans()').
 
 */
-int parse_ord (int ord, int val, char **pword)
+static void build_span_index (void)
 {
-   int wkd, mon, mm, dd, len, doit, (*pfcn) (int, int, int);
-   int val_first, val_last, val_incr, mon_first, mon_last;
-   date_str *pdate, date;
-   
-   if ((wkd = get_weekday(*pword, TRUE)) == NOT_WEEKDAY ||   /* weekday */
-       *++pword == NULL ||   /* any word */
-       (mon = get_month(*++pword, FALSE, TRUE)) == NOT_MONTH) {   /* month */
-      return PARSE_INVLINE;
-   }
-   
-   /* set up loop boundaries for month loop */
-   mon_first = mon == ALL_MONTHS || mon == ENTIRE_YEAR ? JAN : mon;
-   mon_last  = mon == ALL_MONTHS || mon == ENTIRE_YEAR ? DEC : mon;
-   
-   pdate = candidate_dates;   /* start of 'candidate_dates[]' array */
+   int i;
 
-   /* special case of "all|odd|even <wildcard> in <month>|all|year" */
+   if (nindexed >= 0) return;
 
-   if ((ord == ORD_ALL || ord == ORD_EVEN || ord == ORD_ODD) && IS_WILD(wkd)) {
-      pfcn = pdatefcn[wkd - WILD_FIRST];
-      doit = ord != ORD_EVEN;
-      for (mm = mon_first; mm <= mon_last; mm++) {
-         len = LENGTH_OF(mm, curr_year);
-         if (mon != ENTIRE_YEAR) doit = ord != ORD_EVEN;
-         for (dd = 1; dd <= len; dd++) {
-            if ((*pfcn)(mm, dd, curr_year)) {
-               if (doit) ADD_DATE(mm, dd, curr_year);
-               if (ord != ORD_ALL) doit = ! doit;
-            }
-         }
-      }
+   grow_span_index();
+   for (i = 0, nindexed = 0; i < nspans; i++) {
+      if (! span_pool[i].deleted) index_span(i);
    }
+   hits_day = NO_DAY;
+}
 
-   /* special case of "odd|even <weekday> in year" */
+/* ---------------------------------------------------------------------------
 
-   else if ((ord == ORD_EVEN || ord == ORD_ODD) && mon == ENTIRE_YEAR) {
-      date.mm = JAN;   /* starting date */
-      date.dd = calc_day(ord == ORD_EVEN ? 2 : 1, wkd, JAN);
-      date.yy = curr_year;
-      do {   /* alternates throughout year */
-         ADD_DATE(date.mm, date.dd, date.yy);
-         date.dd += 14;
-         normalize(&date);
-      } while (date.yy == curr_year);
-   }
-   
-   /* special case of "<ordinal>|last <weekday>|<wildcard> in year" */
-   
-   else if ((ord == ORD_NEGNUM || ord == ORD_POSNUM) && mon == ENTIRE_YEAR) {
-      if (calc_year_day(val, wkd, &date)) ADD_DATE(date.mm, date.dd, date.yy);
+   find_spans
+
+   Notes:
+
+      This routine finds the spans covering serial day 'n' and leaves their
+      indices in 'span_hits[]' in order of entry; it returns their number.
+      The result for the last day asked about is kept, since the output
+      routines ask about each day repeatedly (cf. 'find_span_info()').
+
+*/
+static int find_spans (long n)
+{
+   int lo = 0, hi, mid, k, i, j;
+
+   build_span_index();
+   if (n == hits_day) return nhits;
+
+   for (hi = nindexed; lo < hi; ) {   /* spans starting on or before n */
+      mid = (lo + hi) / 2;
+      if (span_pool[span_order[mid]].first <= n) lo = mid + 1;
+      else hi = mid;
    }
-   
-   /* all other combinations of ordinal and day */
-   
-   else {
-      /* set up loop boundaries for "wildcard" ordinals */
-      
-      val_first = ord == ORD_ALL || ord == ORD_ODD ? 1 : ord == ORD_EVEN ? 2 : val;
-      val_last  = ord == ORD_ALL || ord == ORD_ODD ? 5 : ord == ORD_EVEN ? 4 : val;
-      val_incr  = ord == ORD_ODD || ord == ORD_EVEN ? 2 : 1;
-      
-      for (mm = mon_first; mm <= mon_last; mm++) {
-         for (val = val_first; val <= val_last; val += val_incr) {
-            if ((dd = calc_day(val, wkd, mm)) != 0) ADD_DATE(mm, dd, curr_year);
-         }
-      }
+
+   for (nhits = 0, k = lo - 1; k >= 0 && span_reach[k] >= n; k--) {
+      if (span_pool[i = span_order[k]].last < n) continue;
+      for (j = nhits++; j > 0 && span_hits[j-1] > i; j--) span_hits[j] = span_hits[j-1];
+      span_hits[j] = i;
    }
-   
-   TERM_DATES;   /* terminate array with null entry */
-   return PARSE_OK;
+   hits_day = n;
+
+   return nhits;
 }
 
 /* ---------------------------------------------------------------------------
 
-   parse_rel
+   span_holiday
 
    Notes:
 
-      This routine parses a relative date specification (e.g. "Friday after
-      fourth Thursday in November", "2nd Saturday after first Friday in all").
-
-      It returns 'PARSE_OK' if the line syntax valid, 'PARSE_INVLINE' if not.  
+      This routine returns TRUE if any holiday span covers serial day 'n'.
 
-      It transforms all dates that match the base date to the appropriate day,
-      month, and year.
-    
-      It calls 'parse_date()' recursively in order to handle cases such as
-      "Friday after Tuesday before last day in all".
+*/
+static int span_holiday (long n)
+{
+   int i;
 
-      The first parameter is a valid (positive) ordinal value.
+   for (i = find_spans(n) - 1; i >= 0; i--) {
+      if (span_pool[span_hits[i]].is_holiday) return TRUE;
+   }
+   return FALSE;
+}
 
-      The second parameter is a valid weekday code (from 'get_weekday()').
+/* ---------------------------------------------------------------------------
 
-      The third parameter is a pointer to the word after the weekday.
+   set_day_range
 
-      The fourth parameter is a pointer to the returned text type
-      (holiday/non-holiday).
+   Notes:
 
-      The fifth parameter is a pointer to the returned first word of text.
+      This routine sets the bits for days 'from' through 'to' of the year
+      in bitmap 'map', a word at a time where possible.
 
 */
-int parse_rel (int val, int wkd, char **pword, int *ptype, char ***pptext)
+static void set_day_range (unsigned long *map, int from, int to)
 {
-   int prep, n, rtn, base_wkd, incr = 1, (*pfcn) (int, int, int);
-   date_str *pd;
-   
-   /* we have the weekday - now look for the preposition */
-   if ((prep = get_prep(*pword++)) == PR_OTHER) return PARSE_INVLINE;
+   for ( ; from <= to && (from - 1) % WORD_BITS != 0; from++) SET_DAY_BIT(map, from);
+   for ( ; from + WORD_BITS - 1 <= to; from += WORD_BITS) map[(from - 1) / WORD_BITS] = ~0UL;
+   for ( ; from <= to; from++) SET_DAY_BIT(map, from);
+}
 
-   /* get the base date */
-   if ((rtn = parse_date(pword, ptype, pptext)) != PARSE_OK) return rtn;
+/* ---------------------------------------------------------------------------
 
-   /* transform 'candidate_dates' array in place - note that the relative date may not
-      be in the same month or even year */
-   
-   if (IS_WILD(wkd)) {   /* wildcard for weekday name? */
-      pfcn = pdatefcn[wkd - WILD_FIRST];
-      
-      for (pd = candidate_dates; pd->mm; pd++) {
-         
-         /* search for nearest matching date */
-         
-         switch (prep) {
-         case PR_BEFORE:
-            pd->dd -= 1;   /* start with previous date */
-            normalize(pd);
-            /* fall through */
-         case PR_ON_BEFORE:
-            incr = -1;   /* search backwards */
-            break;
-            
-         case PR_AFTER:
-            pd->dd += 1;   /* start with following date */
-            normalize(pd);
-            /* fall through */
-         case PR_ON_AFTER:
-            incr = 1;   /* search forward */
-            break;
-            
-         case PR_NEAREST:
-            /* If NEAREST_INCR (cf. pcaldefs.h) is 1, pcal will disambiguate
-               "nearest" in favor of the later date; if -1, in favor of the
-               earlier.  "incr" will take the values 1, -2, 3, -4, ... or -1,
-               2, -3, 4 ...  respectively during the search loop below.
-              
-               ("nearest_before" and "nearest_after" were added to v4.6 to
-               allow the user to specify disambiguation of two equally near
-               dates.)
-            */
-            incr = NEAREST_INCR;
-            val = 1;   /* ordinals meaningless here */
-            break;
-            
-         case PR_NEAREST_BEFORE:
-            incr = -1;   /* start searching backward */
-            val = 1;   /* ordinals meaningless here */
-            break;
+   add_span_holidays
 
-         case PR_NEAREST_AFTER:
-            incr = 1;   /* start searching forward */
-            val = 1;   /* ordinals meaningless here */
-            break;
-         }
-         
-         n = val;
-         while (!((*pfcn)(pd->mm, pd->dd, pd->yy) && --n == 0)) {
-            pd->dd += incr;
-            normalize(pd);
-            /* if searching for "nearest" date, invert sign and bump magnitude
-               of 'incr' on each pass
-            */
-            if (prep == PR_NEAREST || prep == PR_NEAREST_BEFORE || prep == PR_NEAREST_AFTER) {
-               incr -= (incr > 0) ? (2 * incr + 1) : (2 * incr - 1);
-            }
+   Notes:
+
+      This routine sets the holiday bits in 'map' for the days of year 'yy'
+      covered by holiday span 'ps', or by every holiday span if 'ps' is
+      NULL.
+
+*/
+static void add_span_holidays (int yy, unsigned long *map, span_info *ps)
+{
+   date_str date;
+   long jan1, dec31;
+   int k;
+
+   date.mm = JAN, date.dd = 1, date.yy = yy;
+   jan1 = day_serial(&date);
+   dec31 = jan1 + YEAR_LEN(yy) - 1;
+
+   if (ps == NULL) {
+      build_span_index();
+      for (k = nindexed - 1; k >= 0 && span_reach[k] >= jan1; k--) {
+         if (span_pool[span_order[k]].first <= dec31) {
+            add_span_holidays(yy, map, &span_pool[span_order[k]]);
          }
       }
+      return;
+   }
 
+   if (ps->is_holiday && ps->first <= dec31 && ps->last >= jan1) {
+      set_day_range(map, ps->first < jan1 ? 1 : (int) (ps->first - jan1) + 1,
+                    ps->last > dec31 ? YEAR_LEN(yy) : (int) (ps->last - jan1) + 1);
    }
-   else  {   /* explicit weekday name */
-      for (pd = candidate_dates; pd->mm; pd++) {
-         
-         /* calculate nearest matching weekday - note that "nearest_before"
-           and "nearest_after" are synonyms for "before" and "after"
-         */
+}
 
-         base_wkd = calc_weekday(pd->mm, pd->dd, pd->yy);
-         switch (prep) {
-         case PR_BEFORE:
-         case PR_NEAREST_BEFORE:
-         case PR_ON_BEFORE:
-            if (prep != PR_ON_BEFORE || wkd != base_wkd) pd->dd -= 7 - (wkd - base_wkd + 7) % 7;
-            pd->dd -= 7 * (val - 1);
-            break;
-            
-         case PR_AFTER:
-         case PR_NEAREST_AFTER:
-         case PR_ON_AFTER:
-            if (prep != PR_ON_AFTER || wkd != base_wkd) pd->dd += (wkd - base_wkd + 6) % 7 + 1;
-            pd->dd += 7 * (val - 1);
-            break;
-            
-         case PR_NEAREST:
-            /* use closer of previous and next */
-            val = wkd - base_wkd;
-            pd->dd += (val > 3) ? (val - 7) : (val < -3) ? (val + 7) : val;
-            break;
+/* ---------------------------------------------------------------------------
 
-         case PR_ON:
-            /*
-              The 'on' preposition is a special case.  When the conditions it
-              specifies are not matched, we really need to actually _remove_
-              this entry from the 'candidate dates' array.
-              
-              However, for now, it's easier to just set the 'year' ('yy')
-              field in the 'candidate dates' array to -1, as a flag to ignore
-              this date entry entirely when later adding events to the big
-              linked list based on entries from this 'candidate dates' array.
-            */
-            if (wkd != base_wkd) {
-               pd->yy = -1;  /* invalidate this 'candidate date' entry... */
-            }
-            break;
+   mark_span_days
 
-         default:
-            return PARSE_INVLINE;
-            break;
+   Notes:
+
+      This routine brings everything which depends on the specified span up
+      to date after it has been entered or had its holiday flag set, or (if
+      'recalc' is non-zero) after it has been deleted.  Its cost depends on
+      the number of months printed and years involved, not on the number of
+      days covered:
+
+      - each printed month within the span gets a month_info node (so that
+        the output routines will look for the span's text), whose holiday
+        flags are set or - when recalculating - rebuilt for the days
+        covered;
+
+      - each year touched by a holiday span gets a year_info node (so that
+        wildcards such as "workday" consult its holidays, cf.
+        'wild_bitmap()'), and the holiday bitmaps already built for those
+        years are updated.
+
+      A day remains a holiday after a span is deleted if any of its own
+      entries or any other span covering it is a holiday.
+
+*/
+static void mark_span_days (span_info *ps, int recalc)
+{
+   date_str d1, d2, date;
+   month_info *pmonth;
+   day_bitmaps *pb;
+   int m, last, from, to, yy;
+
+   serial_to_date(ps->first, &d1);
+   serial_to_date(ps->last, &d2);
+
+   /* printed months */
+   m = MONTH_INDEX(d1.mm, d1.yy) > window_first ? MONTH_INDEX(d1.mm, d1.yy) : window_first;
+   last = MONTH_INDEX(d2.mm, d2.yy) < window_last ? MONTH_INDEX(d2.mm, d2.yy) : window_last;
+   for ( ; m <= last; m++) {
+      date.mm = m % 12 + 1, date.yy = m / 12;
+      pmonth = get_month_info(date.mm, date.yy);
+      if (! ps->is_holiday) continue;
+
+      from = m == MONTH_INDEX(d1.mm, d1.yy) ? d1.dd : 1;
+      to = m == MONTH_INDEX(d2.mm, d2.yy) ? d2.dd : LENGTH_OF(date.mm, date.yy);
+      for (date.dd = from; date.dd <= to; date.dd++) {
+         if (! recalc || pmonth->nholidays[date.dd-1] > 0 || span_holiday(day_serial(&date))) {
+            pmonth->holidays |= (1L << (date.dd-1));
          }
-         
-         normalize(pd);   /* adjust for month/year crossing */
+         else pmonth->holidays &= ~(1L << (date.dd-1));
       }
    }
-   
+
+   if (! ps->is_holiday) return;
+
+   /* years with holiday bitmaps */
+   for (yy = d1.yy > MIN_YR ? d1.yy : MIN_YR; yy <= d2.yy && yy <= MAX_YR; yy++) {
+      if (! recalc) (void) find_year(yy, TRUE);
+      if ((pb = day_maps[yy - MIN_YR]) == NULL) continue;
+      if (recalc) fill_holiday_map(yy, pb->holiday);
+      else add_span_holidays(yy, pb->holiday, ps);
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   eval_span_date
+
+   Notes:
+
+      This routine evaluates rule 'rule' - one endpoint of a span event -
+      for the current year and copies the resulting date to 'pdate'.  It
+      returns 'PARSE_NOMATCH' if the rule yields no date, 'PARSE_INVSPAN'
+      if it yields more than one, 'PARSE_OK' otherwise.
+
+*/
+static int eval_span_date (int rule, date_str *pdate)
+{
+   eval_date(rule);
+   if (candidate_dates[0].mm == 0) return PARSE_NOMATCH;
+   if (candidate_dates[1].mm != 0) return PARSE_INVSPAN;
+   *pdate = candidate_dates[0];
    return PARSE_OK;
 }
 
 /* ---------------------------------------------------------------------------
 
-   parse_date
+   span_endpoint_ok
 
    Notes:
 
-      This routine parses a date specification in any of its myriad forms.
+      This routine returns TRUE if rule 'rule' - a possible endpoint of a
+      span event (cf. 'parse_as_non_preproc()') - yields a single date
+      which exists (or is Feb 29) in the current year, or in any year of
+      the calendar under "year all".  The current year is left unchanged.
 
-      Upon return, array 'candidate_dates[]' will contain a list of all the
-      dates that matched, terminated by a null entry.  This routine also fills
-      in the date type (holiday/non- holiday) code and the pointer to the
-      first word of text and sets the flag 'curr_year_reset' if the date
-      specified (e.g., dd/mm/yy) explicitly reset the year.
+*/
+static int span_endpoint_ok (int rule)
+{
+   date_str date;
+   int yy, first, last, ok, sv_year = curr_year, sv_reset = curr_year_reset;
 
-      The first parameter is a pointer to the first word to parse.
+   first = last = curr_year;
+   if (curr_year == ALL_YEARS) first = init_year, last = final_year;
 
-      The second parameter is a pointer to the returned date type
-      (holiday/non-holiday).
+   for (ok = FALSE, yy = first; yy <= last && ! ok; yy++) {
+      curr_year = yy;
+      ok = eval_span_date(rule, &date) == PARSE_OK &&
+         (is_valid(date.mm, date.dd, date.yy) || (date.mm == FEB && date.dd == 29));
+      if (curr_year_reset) break;   /* explicit year */
+   }
 
-      The third parameter is a pointer to the returned first word of the event
-      text string from the line in the configuration file.
+   curr_year = sv_year;
+   curr_year_reset = sv_reset;
+
+   return ok;
+}
+
+/* ---------------------------------------------------------------------------
+
+   enter_span_info
+
+   Notes:
+
+      This routine enters (or, if 'delete_entry' is set, deletes) the text
+      for a span event: the days from the date of rule 'first' through the
+      date of rule 'last' inclusive (cf. 'parse_as_non_preproc()').  The
+      span is stored once, however many days it covers.
+
+      Either rule may be any date specification which yields a single date
+      in the current year (cf. 'span_endpoint_ok()').  If the last date has
+      no year, it falls in the same year as the first one, or the following
+      year if it is in an earlier month ("Dec 23 thru Jan 2").
+
+      It returns 'PARSE_NOMATCH' if either rule yields no date,
+      'PARSE_INVSPAN' if either yields more than one, 'PARSE_INVDATE' if
+      either date is invalid, 'PARSE_SPANORDER' if the last date precedes
+      the first ("Mar 10 thru Mar 8"), 'PARSE_OK' if OK.  If symbol
+      'FEB_29_OK' is non-zero (see 'pcaldefs.h'), a span starting or ending
+      on Feb 29 of a common year is silently ignored.
+
+      As with 'enter_day_info()', duplicates of an existing span are not
+      entered, a deleted span's holidays are recalculated, and a span which
+      is not a holiday and lies entirely outside the months to be printed is
+      not entered at all.
 
 */
-int parse_date (char **pword, int *ptype, char ***pptext)
+int enter_span_info (int first, int last, int text_type, char **pword)
 {
-   int mm, dd, yy;
-   int token, n, v, ord, val, wkd, rtn;
-   date_str *pdate;
-   char *cp;
-   
-   pdate = candidate_dates;
-   curr_year_reset = FALSE;   /* set below if date is dd/mm/yy */
-   
-   switch (token = date_type(*pword, &n, &v)) {
-      
-   case DT_MONTH:   /* <month> dd */
-      if (date_style != USA_DATES) return PARSE_INVLINE;
+   date_str d1, d2;
+   span_info *ps, *pdel;
+   int i, is_holiday = text_type == HOLIDAY_TEXT, reset, status, year;
+   unsigned long h;
+   char *text;
+
+   if ((status = eval_span_date(first, &d1)) != PARSE_OK) return status;
+   reset = curr_year_reset;
+   status = eval_span_date(last, &d2);
+   curr_year_reset |= reset;
+   if (status != PARSE_OK) return status;
+
+   if (! is_valid(d1.mm, d1.dd, d1.yy) || ! is_valid(d2.mm, d2.dd, d2.yy)) {
+      return (((d1.mm == FEB && d1.dd == 29) || (d2.mm == FEB && d2.dd == 29)) &&
+              FEB_29_OK) ? PARSE_OK : PARSE_INVDATE;
+   }
 
-      if ((cp = *++pword) == NULL) return PARSE_INVLINE;
-      
-      ADD_DATE(n, atoi(cp), curr_year);
-      TERM_DATES;
-      
-      break;
+   if (rule_year(last) == 0 && day_serial(&d2) < day_serial(&d1) &&
+       MONTH_INDEX(d2.mm, d2.yy) < MONTH_INDEX(d1.mm, d1.yy)) {
+      year = curr_year;   /* try again in the following year */
+      curr_year = d2.yy + 1;
+      status = eval_span_date(last, &d2);
+      curr_year = year;
+      if (status != PARSE_OK) return status;
+      if (! is_valid(d2.mm, d2.dd, d2.yy)) return FEB_29_OK ? PARSE_OK : PARSE_INVDATE;
+   }
+   if (day_serial(&d2) < day_serial(&d1)) return PARSE_SPANORDER;
 
-   case DT_DATE:   /* mm/dd{/yy} | dd/mm{/yy} */
-      n = split_date(*pword,
-                     date_style == USA_DATES ? &mm : &dd,
-                     date_style == USA_DATES ? &dd : &mm,
-                     &yy);
-      
-      if (n > 2) {   /* year present? */
-         if (yy < 100) yy += century();
-         curr_year = yy;   /* reset current year */
-         curr_year_reset = TRUE;
+   if (! is_holiday && ! delete_entry &&
+       (MONTH_INDEX(d2.mm, d2.yy) < window_first || MONTH_INDEX(d1.mm, d1.yy) > window_last)) {
+      return PARSE_OK;   /* not printed */
+   }
+
+   text = join_text(pword);   /* consolidate text from lbuf */
+
+   if (DEBUG(DEBUG_DATES)) {
+      char *p;
+      fprintf(stderr, "%s span: %02d/%02d/%d - %02d/%02d/%d%c '",
+              delete_entry ? "Deleting" : "Adding", d1.mm, d1.dd, d1.yy,
+              d2.mm, d2.dd, d2.yy, is_holiday ? '*' : ' ');
+      for (p = text; *p; p++) {
+         fprintf(stderr, isprint((int)*p) ? "%c" : "\\%03o", *p & CHAR_MSK);
       }
-      
-      ADD_DATE(mm, dd, curr_year);
-      TERM_DATES;
-      
-      break;
+      fprintf(stderr, "'\n");
+   }
 
-   case DT_EURDATE:   /* dd [ <month> | "all" ] */
-      if (date_style != EUR_DATES) return PARSE_INVLINE;
-      
-      dd = atoi(*pword);
-      
-      if (get_keywd(*++pword) == DT_ALL) {
-         for (mm = JAN; mm <= DEC; mm++) {   /* wildcard */
-            ADD_DATE(mm, dd, curr_year);
-         }
+   /* find the most recent identical span, ignoring differences in only
+      spacing and capitalization */
+   for (i = nspans - 1, pdel = NULL; i >= 0 && pdel == NULL; i--) {
+      ps = &span_pool[i];
+      if (! ps->deleted && ps->first == day_serial(&d1) && ps->last == day_serial(&d2) &&
+          ci_strcmp(ps->text, text) == 0) {
+         pdel = ps;
       }
-      else {   /* one month */
-         if ((mm = get_month(*pword, TRUE, FALSE)) == NOT_MONTH) return PARSE_INVLINE;
+   }
 
-         ADD_DATE(mm, dd, curr_year);
+   if (delete_entry) {
+      if (pdel) {
+         pdel->deleted = TRUE;
+         nindexed = -1;   /* rebuild index */
+         if (pdel->is_holiday) mark_span_days(pdel, TRUE);
       }
-      
-      TERM_DATES;
-      break;
-      
-   case DT_ALL:   
-      /* "all" <weekday> "in" [ <month> | "all" ] or "all" <day>" */
-      if ((cp = *(pword+1)) && (*(cp += strspn(cp, DIGITS)) == '\0' || *cp == '*')) {
-         dd = atoi(*++pword);   /* "all" <day> */
-         for (mm = JAN; mm <= DEC; mm++) ADD_DATE(mm, dd, curr_year);
-         TERM_DATES;
-         break;   /* leave switch */
+      return PARSE_OK;
+   }
+
+   if (pdel) {   /* duplicate - just update holiday flag */
+      if (is_holiday && ! pdel->is_holiday) {
+         pdel->is_holiday = TRUE;
+         mark_span_days(pdel, FALSE);
       }
-      
-      n = ORD_ALL;   /* "all" <weekday> ... */
-      v = 0;
-      /* fall through */
-      
-   case DT_ORDINAL:   
-      /* 
-         <ordinal> <weekday> in [ <month> | "all" ] 
-            or 
-         <ordinal> <weekday> <prep> <date> 
-      */
-      ord = n;
-      val = v;
+      return PARSE_OK;
+   }
 
-      /* disambiguate above cases based on preposition */
-      if (ord == ORD_POSNUM && pword[1] && (get_prep(pword[2]) != PR_OTHER)) {
-         if ((wkd = get_weekday(pword[1], TRUE)) == NOT_WEEKDAY) return PARSE_INVLINE;
-         return parse_rel(val, wkd, pword += 2, ptype, pptext);
+   if (nspans == max_spans) {
+      max_spans = max_spans ? 2 * max_spans : 16;
+      if ((span_pool = (span_info *) realloc(span_pool, max_spans * sizeof(span_info))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
       }
-      if ((rtn = parse_ord(ord, val, pword + 1)) != PARSE_OK) return rtn;
-      
-      pword += 3;   /* last word of date */
-      break;
-      
-   case DT_WEEKDAY:   /* <weekday> <prep> <date> */
-      wkd = n;
-      /* parse_rel() calls parse_date() recursively */
-      return parse_rel(1, wkd, ++pword, ptype, pptext);
-      break;
-      
-   case DT_PREDEF_EVENT:   /* predefined event */
-      /*
-         predefined events will either have a redefinition string or a
-         dispatch function - never both (cf. pcallang.h)
-      */
-      if (predef_events[n].pfcn == NULL) {
-         char redef[STRSIZ], *rwords[20], **pdum;
-         int rtn, idum;
+   }
 
-         /* tokenize local copy of redefinition string */
-         strcpy(redef, predef_events[n].def);
-         (void) loadwords(rwords, redef);
+   ps = &span_pool[nspans++];
+   ps->first = day_serial(&d1);
+   ps->last = day_serial(&d2);
+   ps->text = store_text(text, &h);
+   ps->is_holiday = is_holiday;
+   ps->deleted = FALSE;
+   if (nindexed >= 0) {
+      grow_span_index();
+      index_span(nspans - 1);
+   }
+   mark_span_days(ps, FALSE);
 
-         /* call parse_date() recursively to parse the redefinition - if OK,
-            drop through to fill in real ptype and pptext from original string
-            (this works basically because the holiday is always the last token
-            before the text)
-         */
-         if ((rtn = parse_date(rwords, &idum, &pdum)) != PARSE_OK) return rtn;
-      } 
-      else {
-         /* predefined event has a dispatch function - use it */
-         pdate += (*predef_events[n].pfcn)(pdate);
-         TERM_DATES;
-      }
-      break;
-      
-   default:
-      return PARSE_INVLINE;
-      break;
+   return PARSE_OK;
+}
+
+/* ---------------------------------------------------------------------------
+
+   find_span_info
+
+   Notes:
+
+      This routine returns the next span event (after 'prev', or the first
+      one if 'prev' is NULL) which covers the specified date, in order of
+      entry; it returns NULL if there are no more.
+
+*/
+span_info *find_span_info (int mm, int dd, int yy, span_info *prev)
+{
+   date_str date;
+   int i, n;
+
+   if (nspans == 0 || dd > LENGTH_OF(mm, yy)) return NULL;
+
+   date.mm = mm, date.dd = dd, date.yy = yy;
+   n = find_spans(day_serial(&date));
+
+   for (i = 0; i < n; i++) {
+      if (prev == NULL || span_hits[i] > prev - span_pool) return &span_pool[span_hits[i]];
    }
+   return NULL;
+}
 
-   /* at this point, pword points to the last component of the date; fill in
-      type code and pointer to following word (start of text)
-   */
-   *ptype = LASTCHAR(*pword) == '*' ? HOLIDAY_TEXT : DAY_TEXT;
-   *pptext = ++pword;
+/* ---------------------------------------------------------------------------
+
+   enter_note
+
+   Notes:
+
+      This routine acts as a wrapper around 'enter_day_info()' for entering
+      note text.
+
+*/
+int enter_note (int mm, char **pword, int n)
+{
+   int valid;
    
-   return PARSE_OK;
+   /* expand "note all" into all twelve months */
+   if (mm == ALL_MONTHS || mm == ENTIRE_YEAR) {
+      valid = FALSE;   /* is at least one note box valid? */
+      for (mm = JAN; mm <= DEC; mm++) {
+         valid |= enter_day_info(mm,
+                                 note_day(mm, n, curr_year),
+                                 curr_year, NOTE_TEXT,
+                                 pword+1) == PARSE_OK;
+      }
+      return valid ? PARSE_OK : PARSE_NOMATCH;
+   }
+   
+   return enter_day_info(mm, note_day(mm, n, curr_year), curr_year, NOTE_TEXT, pword+1);
 }
 
 /* ---------------------------------------------------------------------------
 
-   parse_as_non_preproc
+   process_event_specification
 
    Notes:
 
-      This routine parses a single non-preprocessor line from the
-      configuration file.
-    
-      This includes the "year", "opt", "note", "delete", and (most frequently)
-      event specification entries in the configuration file.
+      This routine adds or deletes events (including the specific date and its
+      associated text) to/from the big linked list structure (described in
+      greater detail in 'pcaldefs.h').
 
-      For event specifications (and event deletions), this routine calls
-      'process_event_specification()' to parse the date specification and to
-      enter the matching event date(s) in the global array
-      'candidate_dates[]'.
+      The first parameter is the index of the compiled date specification
+      (from 'parse_date()'), which is evaluated for the current year.
 
-      Note: Pre-processor ('cpp'-like) directives (e.g. "include") from the
-      configuration file are handled in 'read_datefile()'.
+      The second parameter is the list of matching dates if they have
+      already been found (cf. 'expand_events()'), NULL if not.
 
-      The first parameter is a pointer to the first word to parse.
+      The third parameter is the text type (holiday/non-holiday).
 
-      The second parameter is the name of the configuration file (for error
-      messages).
+      The fourth parameter is a pointer to the first word of text.
 
 */
-int parse_as_non_preproc (char **pword, char *filename)
+int process_event_specification (int rule, date_str *dates, int text_type, char **ptext)
 {
-   register char *cp;
-   char **ptext;
-   int mm, yy;
-   int text_type, n, v, match;
-   int token;
+   int match;
+   date_str *pd;
    
-   /*
-      Get first field and call date_type() to decode it
-   */
-   cp = *pword;
+   /* evaluate date spec (unless done already) and enter information for
+      each match */
+   if (dates == NULL) {
+      eval_date(rule);
+      dates = candidate_dates;
+   }
+   else curr_year_reset = FALSE;   /* (dates with years aren't expanded early) */
 
-   switch (token = date_type(cp, &n, &v)) {
+   match = FALSE;
+   for (pd = dates; pd->mm; pd++) {
 
-   case DT_YEAR:
-      if ((cp = *++pword) != NULL && (yy = atoi(cp)) > 0) {
-         if (yy < 100) yy += century();
-         curr_year = yy;
-         return PARSE_OK;
+      if (pd->yy == -1) {
+         if (DEBUG(DEBUG_DATES)) {
+            fprintf(stderr, "Bypassing invalidated candidate date: yyyy-%02d-%02d.\n", pd->mm, pd->dd);
+         }
       }
-      if (strcmp(cp, ALL) == 0 || strcmp(cp, "*") == 0) {
-         curr_year = ALL_YEARS;
+      else {
+         if (DEBUG(DEBUG_DATES)) {
+            fprintf(stderr, "Processing candidate date: %4d-%02d-%02d\n", pd->yy, pd->mm, pd->dd);
+         }
+         
+         if (delete_entry) {
+            match |= delete_day_info(pd->mm, pd->dd, pd->yy, text_type, ptext) == PARSE_OK;
+         }
+         else {
+            match |= enter_day_info(pd->mm, pd->dd, pd->yy, text_type, ptext) == PARSE_OK;
+         }
+      }
+   }
+   return match ? PARSE_OK : PARSE_NOMATCH;
+}
+
+/*
+ * Date parsing routines:
+ */
+
+/* ---------------------------------------------------------------------------
+
+   new_rule
+
+   Notes:
+
+      This routine allocates a node in the pool of compiled date
+      specifications, growing the pool as necessary.
+
+      It returns the index of the new (zeroed) node.  Since the pool may move
+      when it grows, callers must not hold pointers to nodes across calls to
+      this routine.
+
+*/
+int new_rule (int kind)
+{
+   event_rule *pr;
+
+   if (nrules == max_rules) {
+      max_rules = max_rules ? 2 * max_rules : 16;
+      if ((rule_pool = (event_rule *) realloc(rule_pool, max_rules * sizeof(event_rule))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   pr = &rule_pool[nrules];
+   memset(pr, 0, sizeof(event_rule));
+   pr->kind = kind;
+   pr->base = NO_RULE;
+   
+   return nrules++;
+}
+
+/* ---------------------------------------------------------------------------
+
+   parse_ord
+
+   Notes:
+
+      This routine parses an ordinal date specification (e.g. "first Monday in
+      September", "every Sunday in October", "last workday in all").
+
+      It returns 'PARSE_OK' if line syntax is valid, 'PARSE_INVLINE' if not.  
+
+      It compiles the specification into the rule node whose index is
+      returned through the last parameter; 'eval_ord()' later writes the
+      matching dates to 'candidate_dates[]'.
+
+      The first parameter is a valid ordinal code (from 'get_ordinal()').
+
+      The second parameter is the ordinal value (also from 'get_ordinal()').
+
+      The third parameter is a pointer to the word after the ordinal.
+
+      The fourth parameter is a pointer to the returned rule index.
+
+*/
+int parse_ord (int ord, int val, char **pword, int *prule)
+{
+   int wkd, mon;
+   event_rule *pr;
+   
+   if ((wkd = get_weekday(*pword, TRUE)) == NOT_WEEKDAY ||   /* weekday */
+       *++pword == NULL ||   /* any word */
+       (mon = get_month(*++pword, FALSE, TRUE)) == NOT_MONTH) {   /* month */
+      return PARSE_INVLINE;
+   }
+
+   *prule = new_rule(RULE_ORDINAL);
+   pr = &rule_pool[*prule];
+   pr->ord = ord;
+   pr->val = val;
+   pr->wkd = wkd;
+   pr->mon = mon;
+
+   return PARSE_OK;
+}
+
+/* ---------------------------------------------------------------------------
+
+   reserve_dates
+
+   Notes:
+
+      This routine makes sure that 'candidate_dates[]' has room for 'n' more
+      dates (plus the terminating null entry) beyond the 'used' entries
+      already present, growing it as necessary.
+
+      It returns a pointer to the first unused entry.  Note that growing the
+      array may move it, so callers must not hold on to older pointers into
+      it (cf. the predefined-event dispatch in 'eval_date()').
+
+*/
+static date_str *reserve_dates (int used, int n)
+{
+   if (used + n >= max_dates) {
+      if (max_dates == 0) max_dates = DATES_INIT;
+      while (used + n >= max_dates) max_dates *= 2;
+      if ((candidate_dates = (date_str *) realloc(candidate_dates, max_dates * sizeof(date_str))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   return candidate_dates + used;
+}
+
+/* ---------------------------------------------------------------------------
+
+   eval_ord
+
+   Notes:
+
+      This routine evaluates a compiled ordinal date specification (cf.
+      'parse_ord()') for the current year.
+
+      It writes all matching dates (if any) to the global array
+      'candidate_dates[]'.  It terminates the date list with a null entry.
+
+*/
+void eval_ord (event_rule *pr)
+{
+   int ord = pr->ord, val = pr->val, wkd = pr->wkd, mon = pr->mon;
+   int mm, dd, len, doit, (*pfcn) (int, int, int);
+   int val_first, val_last, val_incr, mon_first, mon_last;
+   int i, first, have_map;
+   unsigned long map[DAY_WORDS], w;
+   date_str *pdate, date;
+   
+   /* set up loop boundaries for month loop */
+   mon_first = mon == ALL_MONTHS || mon == ENTIRE_YEAR ? JAN : mon;
+   mon_last  = mon == ALL_MONTHS || mon == ENTIRE_YEAR ? DEC : mon;
+   
+   pdate = reserve_dates(0, 0);   /* start of 'candidate_dates[]' array */
+
+   /* special case of "all|odd|even <wildcard> in <month>|all|year" */
+
+   if ((ord == ORD_ALL || ord == ORD_EVEN || ord == ORD_ODD) && IS_WILD(wkd)) {
+      pfcn = pdatefcn[wkd - WILD_FIRST];
+      have_map = wild_bitmap(wkd, curr_year, map);
+      doit = ord != ORD_EVEN;
+      for (mm = mon_first; mm <= mon_last; mm++) {
+         len = LENGTH_OF(mm, curr_year);
+         if (mon != ENTIRE_YEAR) doit = ord != ORD_EVEN;
+         if (have_map) {   /* visit the matching days only */
+            first = DAY_OF_YEAR(mm, 1, curr_year);
+            for (i = (first - 1) / WORD_BITS; i <= (first + len - 2) / WORD_BITS; i++) {
+               for (w = map[i] & day_range_mask(i, first, first + len - 1); w; w &= w - 1) {
+                  if (doit) ADD_DATE(mm, i * WORD_BITS + LOW_BIT(w) + 2 - first, curr_year);
+                  if (ord != ORD_ALL) doit = ! doit;
+               }
+            }
+            continue;
+         }
+         for (dd = 1; dd <= len; dd++) {
+            if ((*pfcn)(mm, dd, curr_year)) {
+               if (doit) ADD_DATE(mm, dd, curr_year);
+               if (ord != ORD_ALL) doit = ! doit;
+            }
+         }
+      }
+   }
+
+   /* special case of "odd|even <weekday> in year" */
+
+   else if ((ord == ORD_EVEN || ord == ORD_ODD) && mon == ENTIRE_YEAR) {
+      date.mm = JAN;   /* starting date */
+      date.dd = calc_day(ord == ORD_EVEN ? 2 : 1, wkd, JAN);
+      date.yy = curr_year;
+      do {   /* alternates throughout year */
+         ADD_DATE(date.mm, date.dd, date.yy);
+         date.dd += 14;
+         normalize(&date);
+      } while (date.yy == curr_year);
+   }
+   
+   /* special case of "<ordinal>|last <weekday>|<wildcard> in year" */
+   
+   else if ((ord == ORD_NEGNUM || ord == ORD_POSNUM) && mon == ENTIRE_YEAR) {
+      if (calc_year_day(val, wkd, &date)) ADD_DATE(date.mm, date.dd, date.yy);
+   }
+   
+   /* all other combinations of ordinal and day */
+   
+   else {
+      /* set up loop boundaries for "wildcard" ordinals */
+      
+      val_first = ord == ORD_ALL || ord == ORD_ODD ? 1 : ord == ORD_EVEN ? 2 : val;
+      val_last  = ord == ORD_ALL || ord == ORD_ODD ? 5 : ord == ORD_EVEN ? 4 : val;
+      val_incr  = ord == ORD_ODD || ord == ORD_EVEN ? 2 : 1;
+      
+      for (mm = mon_first; mm <= mon_last; mm++) {
+         for (val = val_first; val <= val_last; val += val_incr) {
+            if ((dd = calc_day(val, wkd, mm)) != 0) ADD_DATE(mm, dd, curr_year);
+         }
+      }
+   }
+   
+   TERM_DATES;   /* terminate array with null entry */
+}
+
+/* ---------------------------------------------------------------------------
+
+   parse_rel
+
+   Notes:
+
+      This routine parses a relative date specification (e.g. "Friday after
+      fourth Thursday in November", "2nd Saturday after first Friday in all").
+
+      It returns 'PARSE_OK' if the line syntax valid, 'PARSE_INVLINE' if not.  
+
+      It calls 'parse_date()' recursively in order to handle cases such as
+      "Friday after Tuesday before last day in all".
+
+      The first parameter is a valid (positive) ordinal value.
+
+      The second parameter is a valid weekday code (from 'get_weekday()').
+
+      The third parameter is a pointer to the word after the weekday.
+
+      The fourth parameter is a pointer to the returned text type
+      (holiday/non-holiday).
+
+      The fifth parameter is a pointer to the returned first word of text.
+
+      The sixth parameter is a pointer to the returned rule index.
+
+*/
+int parse_rel (int val, int wkd, char **pword, int *ptype, char ***pptext, int *prule)
+{
+   int prep, rtn, base;
+   event_rule *pr;
+   
+   /* we have the weekday - now look for the preposition */
+   if ((prep = get_prep(*pword++)) == PR_OTHER) return PARSE_INVLINE;
+
+   /* get the base date */
+   if ((rtn = parse_date(pword, ptype, pptext, &base)) != PARSE_OK) return rtn;
+
+   *prule = new_rule(RULE_RELATIVE);
+   pr = &rule_pool[*prule];
+   pr->val = val;
+   pr->wkd = wkd;
+   pr->prep = prep;
+   pr->base = base;
+
+   return PARSE_OK;
+}
+
+/* ---------------------------------------------------------------------------
+
+   eval_rel
+
+   Notes:
+
+      This routine evaluates a compiled relative date specification (cf.
+      'parse_rel()') for the current year.
+
+      It evaluates the base date and then transforms all dates that match it
+      to the appropriate day, month, and year.
+
+*/
+void eval_rel (event_rule *pr)
+{
+   int val = pr->val, wkd = pr->wkd, prep = pr->prep;
+   int n, base_wkd, incr = 1, probes, (*pfcn) (int, int, int);
+   date_str *pd;
+   
+   /* get the base date */
+   eval_date(pr->base);
+
+   /* transform 'candidate_dates' array in place - note that the relative date may not
+      be in the same month or even year */
+   
+   if (IS_WILD(wkd)) {   /* wildcard for weekday name? */
+      pfcn = pdatefcn[wkd - WILD_FIRST];
+      
+      for (pd = candidate_dates; pd->mm; pd++) {
+         
+         if (pd->yy == -1) continue;   /* base date invalidated */
+
+         /* search for nearest matching date */
+         
+         switch (prep) {
+         case PR_BEFORE:
+            pd->dd -= 1;   /* start with previous date */
+            normalize(pd);
+            /* fall through */
+         case PR_ON_BEFORE:
+            incr = -1;   /* search backwards */
+            break;
+            
+         case PR_AFTER:
+            pd->dd += 1;   /* start with following date */
+            normalize(pd);
+            /* fall through */
+         case PR_ON_AFTER:
+            incr = 1;   /* search forward */
+            break;
+            
+         case PR_NEAREST:
+            /* If NEAREST_INCR (cf. pcaldefs.h) is 1, pcal will disambiguate
+               "nearest" in favor of the later date; if -1, in favor of the
+               earlier.  "incr" will take the values 1, -2, 3, -4, ... or -1,
+               2, -3, 4 ...  respectively during the search loop below.
+              
+               ("nearest_before" and "nearest_after" were added to v4.6 to
+               allow the user to specify disambiguation of two equally near
+               dates.)
+            */
+            incr = NEAREST_INCR;
+            val = 1;   /* ordinals meaningless here */
+            break;
+            
+         case PR_NEAREST_BEFORE:
+            incr = -1;   /* start searching backward */
+            val = 1;   /* ordinals meaningless here */
+            break;
+
+         case PR_NEAREST_AFTER:
+            incr = 1;   /* start searching forward */
+            val = 1;   /* ordinals meaningless here */
+            break;
+         }
+         
+         /* use the wildcard bitmaps if possible; the day-by-day search
+            below remains for dates they don't cover, but gives up after
+            MAX_SEARCH_DAYS probes.  A date with no match is invalidated
+            (and reported if no date matched - cf. 'parse_as_non_preproc()')
+            rather than searched for indefinitely.
+         */
+         if (is_valid(pd->mm, pd->dd, pd->yy) && pd->yy >= MIN_YR && pd->yy <= MAX_YR) {
+            if (prep == PR_NEAREST || prep == PR_NEAREST_BEFORE || prep == PR_NEAREST_AFTER) {
+               if (! wild_nearest(wkd, pd, incr)) pd->yy = -1;
+            }
+            else if (! wild_search(wkd, pd, val, incr)) pd->yy = -1;
+            continue;
+         }
+
+         n = val;
+         for (probes = 0; !((*pfcn)(pd->mm, pd->dd, pd->yy) && --n == 0); probes++) {
+            if (probes == MAX_SEARCH_DAYS) {
+               pd->yy = -1;   /* invalidate this 'candidate date' entry */
+               break;
+            }
+            pd->dd += incr;
+            normalize(pd);
+            /* if searching for "nearest" date, invert sign and bump magnitude
+               of 'incr' on each pass
+            */
+            if (prep == PR_NEAREST || prep == PR_NEAREST_BEFORE || prep == PR_NEAREST_AFTER) {
+               incr -= (incr > 0) ? (2 * incr + 1) : (2 * incr - 1);
+            }
+         }
+      }
+
+   }
+   else  {   /* explicit weekday name */
+      for (pd = candidate_dates; pd->mm; pd++) {
+         
+         if (pd->yy == -1) continue;   /* base date invalidated */
+
+         /* calculate nearest matching weekday - note that "nearest_before"
+           and "nearest_after" are synonyms for "before" and "after"
+         */
+
+         base_wkd = calc_weekday(pd->mm, pd->dd, pd->yy);
+         switch (prep) {
+         case PR_BEFORE:
+         case PR_NEAREST_BEFORE:
+         case PR_ON_BEFORE:
+            if (prep != PR_ON_BEFORE || wkd != base_wkd) pd->dd -= 7 - (wkd - base_wkd + 7) % 7;
+            pd->dd -= 7 * (val - 1);
+            break;
+            
+         case PR_AFTER:
+         case PR_NEAREST_AFTER:
+         case PR_ON_AFTER:
+            if (prep != PR_ON_AFTER || wkd != base_wkd) pd->dd += (wkd - base_wkd + 6) % 7 + 1;
+            pd->dd += 7 * (val - 1);
+            break;
+            
+         case PR_NEAREST:
+            /* use closer of previous and next */
+            val = wkd - base_wkd;
+            pd->dd += (val > 3) ? (val - 7) : (val < -3) ? (val + 7) : val;
+            break;
+
+         case PR_ON:
+            /*
+              The 'on' preposition is a special case.  When the conditions it
+              specifies are not matched, we really need to actually _remove_
+              this entry from the 'candidate dates' array.
+              
+              However, for now, it's easier to just set the 'year' ('yy')
+              field in the 'candidate dates' array to -1, as a flag to ignore
+              this date entry entirely when later adding events to the big
+              linked list based on entries from this 'candidate dates' array.
+            */
+            if (wkd != base_wkd) {
+               pd->yy = -1;  /* invalidate this 'candidate date' entry... */
+            }
+            break;
+         }
+         
+         normalize(pd);   /* adjust for month/year crossing */
+      }
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   parse_date
+
+   Notes:
+
+      This routine parses a date specification in any of its myriad forms.
+
+      It compiles the specification into one or more rule nodes (cf.
+      'event_rule' in 'pcaldefs.h') and returns the index of the top-level
+      node; 'eval_date()' evaluates it for a given year.  This routine also
+      fills in the date type (holiday/non- holiday) code and the pointer to
+      the first word of text.
+
+      The first parameter is a pointer to the first word to parse.
+
+      The second parameter is a pointer to the returned date type
+      (holiday/non-holiday).
+
+      The third parameter is a pointer to the returned first word of the event
+      text string from the line in the configuration file.
+
+      The fourth parameter is a pointer to the returned rule index.
+
+*/
+int parse_date (char **pword, int *ptype, char ***pptext, int *prule)
+{
+   int mm, dd, yy;
+   int token, n, v, ord, val, wkd, rtn;
+   event_rule *pr;
+   char *cp;
+
+   if (*pword == NULL) return PARSE_INVLINE;   /* e.g. "Monday after" */
+   
+   switch (token = date_type(*pword, &n, &v)) {
+      
+   case DT_MONTH:   /* <month> dd */
+      if (date_style != USA_DATES) return PARSE_INVLINE;
+
+      if ((cp = *++pword) == NULL) return PARSE_INVLINE;
+      
+      *prule = new_rule(RULE_DATE);
+      pr = &rule_pool[*prule];
+      pr->mm = n;
+      pr->dd = atoi(cp);
+      
+      break;
+
+   case DT_DATE:   /* mm/dd{/yy} | dd/mm{/yy} */
+      n = split_date(*pword,
+                     date_style == USA_DATES ? &mm : &dd,
+                     date_style == USA_DATES ? &dd : &mm,
+                     &yy);
+      
+      *prule = new_rule(RULE_DATE);
+      pr = &rule_pool[*prule];
+      pr->mm = mm;
+      pr->dd = dd;
+
+      if (n > 2) {   /* year present? */
+         if (yy < 100) yy += century();
+         pr->yy = yy;   /* resets current year (cf. eval_date()) */
+      }
+      
+      break;
+
+   case DT_EURDATE:   /* dd [ <month> | "all" ] */
+      if (date_style != EUR_DATES) return PARSE_INVLINE;
+      
+      dd = atoi(*pword);
+      
+      if (get_keywd(*++pword) == DT_ALL) {
+         *prule = new_rule(RULE_ALL_MONTHS);   /* wildcard */
+         pr = &rule_pool[*prule];
+         pr->dd = dd;
+      }
+      else {   /* one month */
+         if ((mm = get_month(*pword, TRUE, FALSE)) == NOT_MONTH) return PARSE_INVLINE;
+
+         *prule = new_rule(RULE_DATE);
+         pr = &rule_pool[*prule];
+         pr->mm = mm;
+         pr->dd = dd;
+      }
+      
+      break;
+      
+   case DT_ALL:   
+      /* "all" <weekday> "in" [ <month> | "all" ] or "all" <day>" */
+      if ((cp = *(pword+1)) && (*(cp += strspn(cp, DIGITS)) == '\0' || *cp == '*')) {
+         *prule = new_rule(RULE_ALL_MONTHS);   /* "all" <day> */
+         pr = &rule_pool[*prule];
+         pr->dd = atoi(*++pword);
+         break;   /* leave switch */
+      }
+      
+      n = ORD_ALL;   /* "all" <weekday> ... */
+      v = 0;
+      /* fall through */
+      
+   case DT_ORDINAL:   
+      /* 
+         <ordinal> <weekday> in [ <month> | "all" ] 
+            or 
+         <ordinal> <weekday> <prep> <date> 
+      */
+      ord = n;
+      val = v;
+
+      /* disambiguate above cases based on preposition */
+      if (ord == ORD_POSNUM && pword[1] && (get_prep(pword[2]) != PR_OTHER)) {
+         if ((wkd = get_weekday(pword[1], TRUE)) == NOT_WEEKDAY) return PARSE_INVLINE;
+         return parse_rel(val, wkd, pword += 2, ptype, pptext, prule);
+      }
+      if ((rtn = parse_ord(ord, val, pword + 1, prule)) != PARSE_OK) return rtn;
+      
+      pword += 3;   /* last word of date */
+      break;
+      
+   case DT_WEEKDAY:   /* <weekday> <prep> <date> */
+      wkd = n;
+      /* parse_rel() calls parse_date() recursively */
+      return parse_rel(1, wkd, ++pword, ptype, pptext, prule);
+      break;
+      
+   case DT_PREDEF_EVENT:   /* predefined event */
+      /*
+         predefined events will either have a redefinition string or a
+         dispatch function - never both (cf. pcallang.h)
+      */
+      if (predef_events[n].pfcn == NULL) {
+         char *redef, **rwords = NULL, **pdum;
+         int rtn, idum, base, max_rwords = 0;
+
+         /* tokenize local copy of redefinition string */
+         redef = alloc((int) strlen(predef_events[n].def) + 1);
+         strcpy(redef, predef_events[n].def);
+         (void) loadwords(&rwords, &max_rwords, redef);
+
+         /* call parse_date() recursively to parse the redefinition - if OK,
+            drop through to fill in real ptype and pptext from original string
+            (this works basically because the holiday is always the last token
+            before the text)
+         */
+         rtn = parse_date(rwords, &idum, &pdum, &base);
+         free(rwords);
+         free(redef);
+         if (rtn != PARSE_OK) return rtn;
+
+         *prule = new_rule(RULE_PREDEF);
+         pr = &rule_pool[*prule];
+         pr->base = base;
+      } 
+      else {
+         /* predefined event has a dispatch function - use it */
+         *prule = new_rule(RULE_PREDEF);
+         pr = &rule_pool[*prule];
+         pr->pfcn = predef_events[n].pfcn;
+      }
+      break;
+      
+   default:
+      return PARSE_INVLINE;
+      break;
+   }
+
+   /* at this point, pword points to the last component of the date; fill in
+      type code and pointer to following word (start of text)
+   */
+   *ptype = LASTCHAR(*pword) == '*' ? HOLIDAY_TEXT : DAY_TEXT;
+   *pptext = ++pword;
+   
+   return PARSE_OK;
+}
+
+/* ---------------------------------------------------------------------------
+
+   eval_date
+
+   Notes:
+
+      This routine evaluates a compiled date specification (cf.
+      'parse_date()') for the current year.
+
+      Upon return, array 'candidate_dates[]' will contain a list of all the
+      dates that matched, terminated by a null entry.  This routine also sets
+      the flag 'curr_year_reset' if the date specified (e.g., dd/mm/yy)
+      explicitly reset the year.
+
+      The parameter is the index of the rule to evaluate.
+
+*/
+void eval_date (int rule)
+{
+   int mm;
+   event_rule *pr = &rule_pool[rule];
+   date_str *pdate;
+   
+   pdate = reserve_dates(0, 0);
+   curr_year_reset = FALSE;   /* set below if date is dd/mm/yy */
+
+   switch (pr->kind) {
+
+   case RULE_DATE:   /* <month> dd | mm/dd{/yy} | dd/mm{/yy} | dd <month> */
+      if (pr->yy) {   /* year present? */
+         curr_year = pr->yy;   /* reset current year */
+         curr_year_reset = TRUE;
+      }
+      
+      ADD_DATE(pr->mm, pr->dd, curr_year);
+      TERM_DATES;
+      break;
+
+   case RULE_ALL_MONTHS:   /* "all" <day> | dd "all" */
+      for (mm = JAN; mm <= DEC; mm++) ADD_DATE(mm, pr->dd, curr_year);
+      TERM_DATES;
+      break;
+
+   case RULE_ORDINAL:
+      eval_ord(pr);
+      break;
+
+   case RULE_RELATIVE:
+      eval_rel(pr);
+      break;
+
+   case RULE_PREDEF:
+      if (pr->base != NO_RULE) eval_date(pr->base);   /* redefinition */
+      else {
+         /* dispatch function - the handful of dates it may add must not
+            move the array out from under it (cf. reserve_dates()) */
+         pdate = reserve_dates(0, PREDEF_MAX_DATES);
+         pdate += (*pr->pfcn)(pdate);
+         TERM_DATES;
+      }
+      break;
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   parse_as_non_preproc
+
+   Notes:
+
+      This routine parses a single non-preprocessor line from the
+      configuration file.
+    
+      This includes the "year", "opt", "note", "delete", and (most frequently)
+      event specification entries in the configuration file.
+
+      For event specifications (and event deletions), this routine calls
+      'process_event_specification()' to parse the date specification and to
+      enter the matching event date(s) in the global array
+      'candidate_dates[]'.
+
+      Note: Pre-processor ('cpp'-like) directives (e.g. "include") from the
+      configuration file are handled in 'read_datefile()'.
+
+      The first parameter is a pointer to the first word to parse.
+
+      The second parameter is the name of the configuration file and the
+      third the line number (for error messages).
+
+      When several threads are available, event specifications are queued
+      (cf. 'queue_event()') rather than entered immediately; any other line
+      which involves the data structure enters the pending events first.
+
+*/
+int parse_as_non_preproc (char **pword, char *filename, int line)
+{
+   register char *cp;
+   char **ptext, **pspan;
+   int mm, yy;
+   int text_type, n, v, match, rule, span;
+   int token;
+   
+   /*
+      Get first field and call date_type() to decode it
+   */
+   cp = *pword;
+
+   switch (token = date_type(cp, &n, &v)) {
+
+   case DT_YEAR:
+      if ((cp = *++pword) != NULL && (yy = atoi(cp)) > 0) {
+         if (yy < 100) yy += century();
+         curr_year = yy;
+         return PARSE_OK;
+      }
+      if (strcmp(cp, ALL) == 0 || strcmp(cp, "*") == 0) {
+         curr_year = ALL_YEARS;
          return PARSE_OK;
       }
-      return PARSE_INVLINE;   /* year missing or non-numeric */
-      break;
+      return PARSE_INVLINE;   /* year missing or non-numeric */
+      break;
+
+   case DT_OPT:
+      expand_events();   /* options may affect pending events */
+      if (caching) {   /* save a copy for the cache (cf. write_cache()) */
+         opt_line *po = (opt_line *) alloc(sizeof(opt_line));
+         for (n = 0; pword[n]; n++)
+            ;
+         po->nwords = n;
+         po->words = (char **) alloc((n + 1) * sizeof(char *));
+         for (n = 0; n < po->nwords; n++) {
+            strcpy(po->words[n] = alloc(strlen(pword[n]) + 1), pword[n]);
+         }
+         po->words[n] = NULL;
+         strcpy(po->where = alloc(strlen(filename) + 1), filename);
+         po->next = NULL;
+         *opt_tail = po;
+         opt_tail = &po->next;
+      }
+      if (!get_args(pword, P_OPT, filename, FALSE)) {
+         display_usage(stderr, FALSE);
+         exit(EXIT_FAILURE);
+      }
+      return PARSE_OK;
+      break;
+      
+   case DT_INPUT_LANGUAGE:
+      pword++;  /* point to 2-letter 'language code' string */
+      if (*pword) {
+         int i;
+         for (i = 0; i < NUM_LANGUAGES; i++) {
+            if (ci_strncmp(lang_id[i], *pword, MIN_LANG_LEN) == 0) {
+               input_language = i;
+               return PARSE_OK;
+            }
+         }
+      }
+      return PARSE_INVLINE;
+      break;
+
+   case DT_NOTE:
+      expand_events();   /* keep notes in order with events */
+
+      /* look for optional "/<n>" following keyword */
+      n = (cp = strrchr(cp, '/')) ? atoi(++cp) : 0;
+      
+      if ((mm = get_month(*++pword, TRUE, TRUE)) == NOT_MONTH) return PARSE_INVLINE;
+      
+      /* if "year all" in effect, wildcard all applicable years */
+      if (curr_year == ALL_YEARS) {
+         match = FALSE;
+         for (curr_year = init_year; curr_year <= final_year; curr_year++) {
+            match |= enter_note(mm, pword, n) == PARSE_OK;
+         }
+         curr_year = ALL_YEARS;   /* reset to wildcard */
+         return match ? PARSE_OK : PARSE_NOMATCH;
+      } 
+      else return enter_note(mm, pword, n);
+      break;
+
+   case DT_OTHER:   /* unrecognized token */
+      return PARSE_INVLINE;
+      break;
+      
+   case DT_DELETE:   /* fall through to actually delete event entry */
+      pword++;
+      delete_entry = TRUE;
+      
+   default:
+      /* At this point, we assume that the configuration file line is an event
+         specification... */
+
+      /* If the current year is a wildcard ("all" or "*" - see above), enter
+         the date for each year covered at least partially by the calendar.
+         Note that a "mm/dd/yy" date spec explicitly resets curr_year;
+         parse_date() sets the 'curr_year_reset' flag when this happens so
+         that we can quit immediately.
+      */
+
+      /* The date specification is compiled just once, here; only the
+         compiled rule is evaluated for each year.  A syntax error under "year
+         all" has always been reported as a failure to match (since each
+         year's attempt failed).
+      */
+      if (npending == 0) nrules = 0;   /* recycle rule pool */
+      if ((match = parse_date(pword, &text_type, &ptext, &rule)) != PARSE_OK) {
+         delete_entry = FALSE;
+         return curr_year == ALL_YEARS ? PARSE_NOMATCH : match;
+      }
+
+      /* "<date_spec> thru <date_spec>" introduces a span event, stored once
+         (cf. enter_span_info()), but only if both dates are single days
+         which exist; otherwise "thru" just starts the text ("May 1 through
+         May Day party")
+      */
+      if (*ptext &&
+          (ci_strcmp(*ptext, THRU) == 0 || ci_strcmp(*ptext, THROUGH) == 0) &&
+          parse_date(ptext + 1, &n, &pspan, &span) == PARSE_OK &&
+          span_endpoint_ok(rule) && span_endpoint_ok(span)) {
+         if (n == HOLIDAY_TEXT) text_type = HOLIDAY_TEXT;
+         ptext = pspan;
+      }
+      else span = NO_RULE;
+
+      if (batching) return queue_event(rule, span, text_type, ptext, filename, line);
+
+      return enter_event(rule, span, text_type, ptext, NULL);
+      break;
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   enter_event
+
+   Notes:
+
+      This routine enters (or deletes) the event whose date was compiled
+      into rule 'rule' (and rule 'span', if a span event) for the current
+      year, or for each year of the calendar if "year all" is in effect.
+
+      'dates', if non-NULL, holds the dates already found for each year
+      (cf. 'expand_events()').
+
+      It returns 'PARSE_OK' if any date matched.
+
+*/
+static int enter_event (int rule, int span, int text_type, char **ptext, date_str **dates)
+{
+   int match, status, i;
+
+   if (curr_year == ALL_YEARS) {
+      match = FALSE;
+      /* loop over each applicable year */
+      for (curr_year = init_year, i = 0; curr_year <= final_year; curr_year++, i++) {
+         status = span == NO_RULE ?
+            process_event_specification(rule, dates ? dates[i] : NULL, text_type, ptext) :
+            enter_span_info(rule, span, text_type, ptext);
+         if (status == PARSE_INVSPAN) {   /* same in every year */
+            curr_year = ALL_YEARS;
+            delete_entry = FALSE;
+            return status;
+         }
+         match |= status == PARSE_OK;
+         if (curr_year_reset) {   /* quit if year reset */
+            return match ? PARSE_OK : PARSE_NOMATCH;
+         }
+      }
+      
+      /* restore year to wildcard for next time */
+      curr_year = ALL_YEARS;
+      delete_entry = FALSE;
+      return match ? PARSE_OK : PARSE_NOMATCH;
+   }
+
+   match = span == NO_RULE ?
+      process_event_specification(rule, dates ? dates[0] : NULL, text_type, ptext) :
+      enter_span_info(rule, span, text_type, ptext);
+   delete_entry = FALSE;
+   return match;
+}
+
+/*
+ * Routines to expand event dates in parallel
+ */
+
+/* ---------------------------------------------------------------------------
+
+   queue_event
+
+   Notes:
+
+      This routine saves an event specification (cf. 'enter_event()') to
+      be entered later by 'expand_events()', along with its text and the
+      file name and line number for error messages.  Its compiled rules stay
+      in the rule pool until then.
+
+      It leaves the current year and the "delete" flag as entering the event
+      would have: a date with an explicit year resets the current year (cf.
+      'eval_date()').
+
+      It returns 'PARSE_OK'; errors are reported when the event is entered.
+
+*/
+static int queue_event (int rule, int span, int text_type, char **ptext, char *filename, int line)
+{
+   event_spec *pe;
+   char *text;
+   int yy;
+
+   if (npending == max_pending) {
+      max_pending = max_pending ? 2 * max_pending : 64;
+      if ((pending = (event_spec *) realloc(pending, max_pending * sizeof(event_spec))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   pe = &pending[npending];
+   pe->rule = rule;
+   pe->span = span;
+   pe->text_type = text_type;
+   pe->del = delete_entry;
+   pe->year = curr_year;
+   text = join_text(ptext);
+   strcpy(pe->text = alloc(strlen(text) + 1), text);
+   pe->font = fontstyle[0];
+   pe->line = line;
+   pe->dates = NULL;
+
+   /* share the file name with the previous event where possible */
+   if (npending > 0 && strcmp(pending[npending - 1].filename, filename) == 0) {
+      pe->filename = pending[npending - 1].filename;
+   }
+   else strcpy(pe->filename = alloc(strlen(filename) + 1), filename);
+
+   npending++;
+
+   if ((yy = span != NO_RULE && rule_year(span) ? rule_year(span) : rule_year(rule)) != 0) {
+      if (curr_year != ALL_YEARS) delete_entry = FALSE;
+      curr_year = yy;
+   }
+   else delete_entry = FALSE;
+
+   return PARSE_OK;
+}
+
+/* ---------------------------------------------------------------------------
+
+   rule_year
+
+   Notes:
+
+      This routine returns the explicit year of the date underlying the
+      compiled date specification 'rule', or 0 if there is none.
+
+*/
+static int rule_year (int rule)
+{
+   for ( ; rule != NO_RULE; rule = rule_pool[rule].base) {
+      if (rule_pool[rule].kind == RULE_DATE) return rule_pool[rule].yy;
+   }
+
+   return 0;
+}
+
+#ifdef USE_PTHREADS
+/* ---------------------------------------------------------------------------
+
+   uses_entries
+
+   Notes:
+
+      This routine determines whether the dates matched by the compiled
+      date specification 'rule' may depend on the events entered before it
+      (i.e., on the holidays), or on data shared by the moon phase
+      routines.  Such events are expanded only as they are entered.
+
+*/
+static int uses_entries (int rule)
+{
+   event_rule *pr;
+
+   for ( ; rule != NO_RULE; rule = pr->base) {
+      pr = &rule_pool[rule];
+      if ((pr->kind == RULE_ORDINAL || pr->kind == RULE_RELATIVE) &&
+          (USES_HOLIDAYS(pr->wkd) || (pr->wkd >= WILD_FIRST_MOON && pr->wkd <= WILD_LAST_MOON))) {
+         return TRUE;
+      }
+   }
+
+   return FALSE;
+}
+#endif
+
+/* ---------------------------------------------------------------------------
+
+   expand_events
+
+   Notes:
+
+      This routine enters the events queued by 'queue_event()', in the
+      order they were read, and reports any errors.
+
+      First, the dates of each (event, year) pair which depends neither on
+      the preceding entries nor on the current year (cf. 'uses_entries()',
+      'rule_year()') are found in parallel; the dates of the rest - span
+      events, and those involving holidays - are found as they are entered,
+      so that they see exactly the holidays they would have if each event
+      had been entered as soon as it was read.
+
+*/
+void expand_events (void)
+{
+   event_spec *pe;
+   char *ptext[2], *msg, sv_font;
+   int sv_year, sv_delete, i, n;
+
+   if (npending == 0) return;
+
+#ifdef USE_PTHREADS
+   expand_in_threads();
+#endif
+
+   sv_year = curr_year;
+   sv_delete = delete_entry;
+   sv_font = fontstyle[0];
+
+   for (pe = pending; pe < pending + npending; pe++) {
+      curr_year = pe->year;
+      delete_entry = pe->del;
+      fontstyle[0] = pe->font;
+      ptext[0] = pe->text;
+      ptext[1] = NULL;
+
+      switch (enter_event(pe->rule, pe->span, pe->text_type, ptext, pe->dates)) {
+      case PARSE_INVDATE:
+         msg = E_INV_DATE;
+         break;
+      case PARSE_NOMATCH:
+         msg = E_NO_MATCH;
+         break;
+      case PARSE_INVSPAN:
+         msg = E_INV_SPAN;
+         break;
+      case PARSE_SPANORDER:
+         msg = E_SPAN_ORDER;
+         break;
+      default:
+         msg = NULL;
+         break;
+      }
+      if (msg) fprintf(stderr, E_ILL_LINE, progname, msg, pe->filename, pe->line);
+
+      if (pe->dates) {
+         n = pe->year == ALL_YEARS ? final_year - init_year + 1 : 1;
+         for (i = 0; i < n; i++) free(pe->dates[i]);
+         free(pe->dates);
+      }
+      if (pe + 1 == pending + npending || pe[1].filename != pe->filename) free(pe->filename);
+      free(pe->text);
+   }
+
+   npending = 0;
+   nrules = 0;   /* recycle rule pool */
+
+   curr_year = sv_year;
+   delete_entry = sv_delete;
+   fontstyle[0] = sv_font;
+
+   return;
+}
+
+#ifdef USE_PTHREADS
+
+/* work shared among the threads of 'expand_in_threads()' */
+static struct {
+   pthread_mutex_t lock;
+   int next;   /* next (event, year) pair to expand */
+   int n;   /* number of pairs */
+   int *event, *year;   /* event index and year of each pair */
+} par_work = { PTHREAD_MUTEX_INITIALIZER, 0, 0, NULL, NULL };
+
+/* ---------------------------------------------------------------------------
+
+   expand_dates
+
+   Notes:
+
+      This routine finds the dates of (event, year) pairs from 'par_work'
+      until there are none left.  It runs in each thread; the date
+      evaluation state (the current year and the candidate date list) is
+      kept per thread (cf. 'THREAD_LOCAL').  'worker' is non-NULL in the
+      threads started for the purpose, which free their date list when done.
+
+*/
+static void *expand_dates (void *worker)
+{
+   event_spec *pe;
+   date_str *pd;
+   int first, last, i, n;
+
+   for (;;) {
+      pthread_mutex_lock(&par_work.lock);
+      first = par_work.next;
+      last = par_work.next = first + PAR_BATCH < par_work.n ? first + PAR_BATCH : par_work.n;
+      pthread_mutex_unlock(&par_work.lock);
+      if (first == last) break;
+
+      for (i = first; i < last; i++) {
+         pe = &pending[par_work.event[i]];
+         curr_year = par_work.year[i];
+         eval_date(pe->rule);
+         for (pd = candidate_dates; pd->mm; pd++)
+            ;
+         n = pd - candidate_dates + 1;   /* including terminator */
+         pe->dates[pe->year == ALL_YEARS ? curr_year - init_year : 0] =
+            (date_str *) memcpy(alloc(n * sizeof(date_str)), candidate_dates, n * sizeof(date_str));
+      }
+   }
+
+   if (worker) {
+      free(candidate_dates);
+      candidate_dates = NULL;
+      max_dates = 0;
+      free(jump_tabs);
+      jump_tabs = NULL;
+   }
+
+   return NULL;
+}
+
+/* ---------------------------------------------------------------------------
+
+   expand_in_threads
+
+   Notes:
+
+      This routine finds the dates of the pending events which can be
+      expanded ahead of their entry (cf. 'expand_events()'), dividing the
+      (event, year) pairs among 'nthreads' threads including this one.  It
+      does nothing if there are too few pairs to be worth it.
+
+*/
+static void expand_in_threads (void)
+{
+   pthread_t threads[MAX_THREADS];
+   event_spec *pe;
+   int i, n, nyears, yy, started, sv_year;
+
+   /* count the pairs */
+   nyears = final_year - init_year + 1;
+   for (pe = pending, n = 0; pe < pending + npending; pe++) {
+      if (pe->span == NO_RULE && ! rule_year(pe->rule) && ! uses_entries(pe->rule)) {
+         n += pe->year == ALL_YEARS ? nyears : 1;
+      }
+   }
+   if (n < MIN_PAR_DATES) return;
+
+   par_work.event = (int *) alloc(n * sizeof(int));
+   par_work.year = (int *) alloc(n * sizeof(int));
+   par_work.n = n;
+   par_work.next = 0;
+
+   for (pe = pending, n = 0; pe < pending + npending; pe++) {
+      if (pe->span == NO_RULE && ! rule_year(pe->rule) && ! uses_entries(pe->rule)) {
+         pe->dates = (date_str **) alloc((pe->year == ALL_YEARS ? nyears : 1) * sizeof(date_str *));
+         for (yy = pe->year == ALL_YEARS ? init_year : pe->year;
+              yy <= (pe->year == ALL_YEARS ? final_year : pe->year); yy++, n++) {
+            par_work.event[n] = pe - pending;
+            par_work.year[n] = yy;
+         }
+      }
+   }
+
+   /* the day-of-week bitmaps are created on first use - do so now for
+      every type of year (all of which occur in a 400-year cycle) */
+   for (yy = MIN_YR; yy < MIN_YR + 400; yy++) (void) get_year_type_bitmaps(yy);
+
+   sv_year = curr_year;
+   for (started = 0; started < nthreads - 1; started++) {
+      if (pthread_create(&threads[started], NULL, expand_dates, &par_work) != 0) break;
+   }
+   (void) expand_dates(NULL);   /* this thread helps too */
+   for (i = 0; i < started; i++) pthread_join(threads[i], NULL);
+   curr_year = sv_year;
+
+   free(par_work.event);
+   free(par_work.year);
+   par_work.event = par_work.year = NULL;
+
+   return;
+}
+
+#endif /* USE_PTHREADS */
+
+
+/*
+ * Routines for the date file cache
+ */
+
+#ifdef CACHE_OK
+
+/* ---------------------------------------------------------------------------
+
+   add_to_key
+
+   Notes:
+
+      This routine appends 'prefix' and 's', followed by a newline, to the
+      cache key (cf. make_cache_key()).
+
+*/
+static void add_to_key (char *prefix, char *s)
+{
+   int len = (int) strlen(cache_key);
+
+   grow_buf(&cache_key, &cache_key_size, len + (int) (strlen(prefix) + strlen(s)) + 2);
+   sprintf(cache_key + len, "%s%s\n", prefix, s);
+}
+
+/* ---------------------------------------------------------------------------
+
+   make_cache_key
+
+   Notes:
+
+      This routine describes everything besides the contents of the input
+      files which determines the result of reading the date file
+      'filename': the program version, the range of years, the settings
+      consulted while parsing, and the preprocessor symbols defined so far
+      (by -D and -U, and by the flags which define symbols of their own).  A
+      cache file is used only if its key is identical (cf. 'read_cache()'),
+      so any setting the parser comes to depend on must be added here.
+
+      It also notes the modification time and size of the date file, so
+      that 'write_cache()' can tell if it changes while being read.
+
+*/
+static void make_cache_key (char *filename)
+{
+   char tmp[STRSIZ];
+   struct stat st;
+   int i;
+
+   grow_buf(&cache_key, &cache_key_size, LINSIZ);
+   *cache_key = '\0';
+
+   sprintf(tmp, "%s %d", version, CACHE_VERSION);
+   add_to_key("version ", tmp);
+   add_to_key("file ", filename);
+   sprintf(tmp, "%d/%d %d/%d", init_month, init_year, final_month, final_year);
+   add_to_key("months ", tmp);
+   sprintf(tmp, "%d %d %d %d %d", date_style, output_type, input_language, output_language,
+           fontstyle[0]);
+   add_to_key("style ", tmp);
+   sprintf(tmp, "%d %d %d %d %d %d %d %d", day_color[0], day_color[1], day_color[2],
+           day_color[3], day_color[4], day_color[5], day_color[6], weekday_color);
+   add_to_key("colors ", tmp);
+   add_to_key("zone ", time_zone);
+
+   for (i = 0; i < n_pp_syms; i++) {
+      if (pp_syms[i].defined) {
+         add_to_key("define ", pp_syms[i].name);
+         if (pp_syms[i].val) add_to_key("value ", pp_syms[i].val);
+      }
+   }
 
-   case DT_OPT:
-      if (!get_args(pword, P_OPT, filename, FALSE)) {
-         display_usage(stderr, FALSE);
-         exit(EXIT_FAILURE);
+   cache_mtime = cache_size = -1;
+   if (stat(filename, &st) == 0 && S_ISREG(st.st_mode)) {
+      cache_mtime = (long) st.st_mtime;
+      cache_size = (long) st.st_size;
+   }
+}
+
+/* ---------------------------------------------------------------------------
+
+   hash_bytes
+
+   Notes:
+
+      This routine adds 'n' bytes at 'p' to the FNV-1a hash 'h' (start with
+      'FNV_BASIS') and returns the result.
+
+*/
+static unsigned long hash_bytes (unsigned long h, char *p, long n)
+{
+   while (n-- > 0) h = (h ^ (*p++ & CHAR_MSK)) * 16777619UL;
+   return h;
+}
+
+/* ---------------------------------------------------------------------------
+
+   hash_file
+
+   Notes:
+
+      This routine returns a hash of the contents of the file 'path', and its
+      size via 'psize'.  The size is -1 if the file is not a regular file or
+      cannot be read.
+
+*/
+static unsigned long hash_file (char *path, long *psize)
+{
+   struct stat st;
+   FILE *fp;
+   char buf[BUFSIZ];
+   unsigned long h = FNV_BASIS;
+   size_t n;
+
+   *psize = -1;
+   if (stat(path, &st) != 0 || ! S_ISREG(st.st_mode) || (fp = fopen(path, "rb")) == NULL) {
+      return 0;
+   }
+
+   *psize = 0;
+   while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+      h = hash_bytes(h, buf, (long) n);
+      *psize += (long) n;
+   }
+   fclose(fp);
+
+   return h;
+}
+
+/* ---------------------------------------------------------------------------
+
+   put_bytes, put_long, put_str
+
+   Notes:
+
+      These routines write raw data, a number, or a string (its length
+      followed by its characters and the terminating null) to the cache
+      file, adding what they write to the checksum 'cache_sum' (cf.
+      'write_cache()').  Numbers are written in the machine's own format; a
+      cache file written on another kind of machine is simply not used.
+
+*/
+static unsigned long cache_sum;
+
+static void put_bytes (FILE *fp, char *p, long n)
+{
+   fwrite(p, 1, (size_t) n, fp);
+   cache_sum = hash_bytes(cache_sum, p, n);
+}
+
+static void put_long (FILE *fp, long n)
+{
+   put_bytes(fp, (char *) &n, (long) sizeof(long));
+}
+
+static void put_str (FILE *fp, char *s)
+{
+   long len = (long) strlen(s);
+
+   put_long(fp, len);
+   put_bytes(fp, s, len + 1);
+}
+
+/* ---------------------------------------------------------------------------
+
+   get_long, get_str
+
+   Notes:
+
+      These routines read a number or a string written by 'put_long()' or
+      'put_str()' from the cache file contents.  The strings are returned in
+      place.  Both clear 'pc->ok' (and return 0 or "") if the data is
+      exhausted or malformed.
+
+*/
+static long get_long (cache_reader *pc)
+{
+   long n;
+
+   if (! pc->ok || pc->end - pc->p < (long) sizeof(long)) {
+      pc->ok = FALSE;
+      return 0;
+   }
+
+   memcpy((char *) &n, pc->p, sizeof(long));
+   pc->p += sizeof(long);
+
+   return n;
+}
+
+static char *get_str (cache_reader *pc)
+{
+   long len = get_long(pc);
+   char *s;
+
+   if (! pc->ok || len < 0 || pc->end - pc->p <= len || pc->p[len] != '\0') {
+      pc->ok = FALSE;
+      return "";
+   }
+
+   s = pc->p;
+   pc->p += len + 1;
+
+   return s;
+}
+
+/* ---------------------------------------------------------------------------
+
+   read_cache
+
+   Notes:
+
+      This routine loads the data structure built from the date file from
+      the cache file 'cachefile' instead of reading the date file, if the
+      cache file was written by this version of Pcal on this kind of
+      machine, is intact (its checksum matches its contents), has the same
+      key (cf. 'make_cache_key()'), and every file read in building it - the
+      date file and its included files - is unchanged.  An optional included
+      file which was missing must still be missing.
+
+      The settings made by "opt" lines are restored by processing them
+      again, and the symbol table and input language are restored as they
+      were at the end of the date file.
+
+      The event text is left in the cache file contents, which are mapped
+      into memory where possible and kept until 'cleanup()'.
+
+      It returns TRUE if the data structure was loaded, FALSE if the date
+      file must be read instead.  Note that diagnostics issued while reading
+      the date file are not repeated.
+
+*/
+static int read_cache (char *cachefile)
+{
+   cache_reader cr, *pc = &cr;
+   struct stat st;
+   FILE *fp;
+   char **texts = NULL, *opt_pos, *sym_pos, *path, *val, **argv;
+   unsigned long *hashes = NULL, h;
+   long n, i, j, k, ntexts, nyears, nmonths, nevents, size, mm, day, idx, sv_year, sv_lang;
+   year_info *py;
+   month_info *pm;
+   day_info *pe;
+   span_info *ps;
+
+   if (cache_mtime < 0) return FALSE;   /* date file not a regular file */
+
+   /* get the contents of the cache file */
+
+   if ((fp = fopen(cachefile, "rb")) == NULL) return FALSE;
+   if (fstat(fileno(fp), &st) != 0 || ! S_ISREG(st.st_mode) ||
+       (long) st.st_size < (long) (strlen(CACHE_MAGIC) + 5 * sizeof(long))) {
+      fclose(fp);
+      return FALSE;
+   }
+   cache_len = (long) st.st_size;
+
+#ifdef BUILD_ENV_UNIX
+   {
+      void *p;
+
+      if ((p = mmap(NULL, (size_t) cache_len, PROT_READ, MAP_PRIVATE, fileno(fp), 0)) != MAP_FAILED) {
+         cache_data = (char *) p;
+         cache_mapped = TRUE;
       }
-      return PARSE_OK;
-      break;
-      
-   case DT_INPUT_LANGUAGE:
-      pword++;  /* point to 2-letter 'language code' string */
-      if (*pword) {
-         int i;
-         for (i = 0; i < NUM_LANGUAGES; i++) {
-            if (ci_strncmp(lang_id[i], *pword, MIN_LANG_LEN) == 0) {
-               input_language = i;
-               return PARSE_OK;
+   }
+#endif
+
+   if (! cache_data) {
+      cache_data = alloc((int) cache_len);
+      if ((long) fread(cache_data, 1, (size_t) cache_len, fp) != cache_len) {
+         fclose(fp);
+         goto reject;
+      }
+   }
+   fclose(fp);
+
+   /* check the header, trailer, checksum, key, and input files */
+
+   cr.p = cache_data + cache_len - 2 * sizeof(long);   /* checksum */
+   cr.end = cache_data + cache_len - sizeof(long);   /* trailer */
+   cr.ok = TRUE;
+
+   if (memcmp(cache_data, CACHE_MAGIC, strlen(CACHE_MAGIC)) != 0 ||
+       memcmp(cr.end, CACHE_MAGIC, sizeof(long)) != 0 ||
+       (unsigned long) get_long(pc) != hash_bytes(FNV_BASIS, cache_data, cache_len - 2 * sizeof(long))) {
+      goto reject;
+   }
+
+   cr.p = cache_data + strlen(CACHE_MAGIC);
+   cr.end = cache_data + cache_len - 2 * sizeof(long);
+
+   if (get_long(pc) != CACHE_VERSION || get_long(pc) != 0x01020304L ||
+       strcmp(get_str(pc), cache_key) != 0) {
+      goto reject;
+   }
+
+   for (n = get_long(pc); pc->ok && n > 0; n--) {
+      path = get_str(pc);
+      size = get_long(pc);
+      h = (unsigned long) get_long(pc);
+      if (! pc->ok || hash_file(path, &i) != h || i != size) goto reject;
+   }
+
+   /* skip the "opt" lines and symbols for now (cf. below) */
+
+   opt_pos = pc->p;
+   for (n = get_long(pc); pc->ok && n > 0; n--) {
+      (void) get_str(pc);
+      for (i = get_long(pc); pc->ok && i > 0; i--) (void) get_str(pc);
+   }
+
+   sym_pos = pc->p;
+   for (n = get_long(pc); pc->ok && n > 0; n--) {
+      (void) get_str(pc);
+      (void) get_str(pc);
+   }
+
+   sv_year = get_long(pc);
+   sv_lang = get_long(pc);
+   if (sv_lang < 0 || sv_lang >= NUM_LANGUAGES) pc->ok = FALSE;
+
+   /* event text */
+
+   ntexts = get_long(pc);
+   if (! pc->ok || ntexts < 0 || ntexts > cache_len) goto reject;
+   texts = (char **) alloc((int) ((ntexts + 1) * sizeof(char *)));
+   hashes = (unsigned long *) alloc((int) ((ntexts + 1) * sizeof(unsigned long)));
+   for (i = 0; i < ntexts; i++) {
+      hashes[i] = (unsigned long) get_long(pc);
+      texts[i] = get_str(pc);
+   }
+
+   /* years, months, and events (sorted by day) */
+
+   nyears = get_long(pc);
+   for (n = 0; pc->ok && n < nyears; n++) {
+      py = find_year((int) get_long(pc), TRUE);
+      nmonths = get_long(pc);
+      for (i = 0; pc->ok && i < nmonths; i++) {
+         mm = get_long(pc);
+         if (mm < 0 || mm > 11 || py->month[mm]) goto reject;
+         pm = py->month[mm] = (month_info *) arena_alloc((int) sizeof(month_info));
+         pm->holidays = (unsigned long) get_long(pc);
+         nevents = get_long(pc);
+         if (! pc->ok || nevents < 0 || nevents > cache_len) goto reject;
+         if (nevents) pm->event = (day_info *) arena_alloc((int) (nevents * sizeof(day_info)));
+         pm->nevents = pm->max_events = (int) nevents;
+         for (j = 0, pe = pm->event, day = 0; j < nevents; j++, pe++) {
+            k = day;
+            day = get_long(pc);
+            pe->is_holiday = get_long(pc) != 0;
+            idx = get_long(pc);
+            if (! pc->ok || day < k || day >= LAST_NOTE_DAY || idx < 0 || idx >= ntexts) {
+               goto reject;
             }
+            pe->day = (unsigned char) day;
+            pe->text = texts[idx];
+            pe->hash = hashes[idx];
+            pe->hnext = -1;
+            pm->ntext[day]++;
+            if (pe->is_holiday) pm->nholidays[day]++;
+         }
+         for (day = 0, k = 0; day < LAST_NOTE_DAY; day++) {
+            pm->first[day] = (int) k;
+            k += pm->ntext[day];
          }
+         pm->first[LAST_NOTE_DAY] = (int) k;
       }
-      return PARSE_INVLINE;
-      break;
+   }
 
-   case DT_NOTE:
-      /* look for optional "/<n>" following keyword */
-      n = (cp = strrchr(cp, '/')) ? atoi(++cp) : 0;
-      
-      if ((mm = get_month(*++pword, TRUE, TRUE)) == NOT_MONTH) return PARSE_INVLINE;
-      
-      /* if "year all" in effect, wildcard all applicable years */
-      if (curr_year == ALL_YEARS) {
-         match = FALSE;
-         for (curr_year = init_year; curr_year <= final_year; curr_year++) {
-            match |= enter_note(mm, pword, n) == PARSE_OK;
+   /* span events */
+
+   n = get_long(pc);
+   if (! pc->ok || n < 0 || n > cache_len) goto reject;
+   if (n > max_spans) {
+      max_spans = (int) n;
+      if ((span_pool = (span_info *) realloc(span_pool, max_spans * sizeof(span_info))) == NULL) {
+         fprintf(stderr, E_ALLOC_ERR, progname);
+         exit(EXIT_FAILURE);
+      }
+   }
+   nindexed = -1;
+   for (nspans = 0; nspans < n; nspans++) {
+      ps = &span_pool[nspans];
+      ps->first = get_long(pc);
+      ps->last = get_long(pc);
+      idx = get_long(pc);
+      ps->is_holiday = get_long(pc) != 0;
+      ps->deleted = FALSE;
+      if (! pc->ok || idx < 0 || idx >= ntexts) goto reject;
+      ps->text = texts[idx];
+   }
+
+   if (! pc->ok || pc->p != pc->end) goto reject;
+
+   free(texts);
+   free((char *) hashes);
+
+   /* the data structure is good; redo the "opt" lines (with private copies
+      of their words) and restore the symbol table */
+
+   cr.p = opt_pos;
+   for (n = get_long(pc); n > 0; n--) {
+      path = get_str(pc);
+      k = get_long(pc);
+      argv = (char **) alloc((int) ((k + 1) * sizeof(char *)));
+      for (i = 0; i < k; i++) {
+         char *w = get_str(pc);
+         strcpy(argv[i] = alloc((int) strlen(w) + 1), w);
+      }
+      argv[k] = NULL;
+      if (! get_args(argv, P_OPT, path, FALSE)) {
+         display_usage(stderr, FALSE);
+         exit(EXIT_FAILURE);
+      }
+      for (i = 0; i < k; i++) free(argv[i]);
+      free((char *) argv);
+   }
+
+   clear_syms();
+   cr.p = sym_pos;
+   for (n = get_long(pc); n > 0; n--) {
+      path = get_str(pc);
+      val = get_str(pc);   /* "=value", or "" if none */
+      do_define(path);
+      if (*val) do_define_sym_val(path, val + 1);
+   }
+
+   curr_year = (int) sv_year;
+   input_language = (int) sv_lang;
+
+   return TRUE;
+
+ reject:
+   /* discard whatever was loaded */
+   if (texts) free(texts);
+   if (hashes) free((char *) hashes);
+   clear_tree();
+
+#ifdef BUILD_ENV_UNIX
+   if (cache_mapped) munmap(cache_data, (size_t) cache_len);
+   else
+#endif
+   free(cache_data);
+   cache_data = NULL;
+   cache_len = 0;
+   cache_mapped = FALSE;
+
+   return FALSE;
+}
+
+/* ---------------------------------------------------------------------------
+
+   write_cache
+
+   Notes:
+
+      This routine writes the data structure just built from the date file
+      'filename' (cf. 'read_cache()') to the cache file 'cachefile', along
+      with the key, the files read, the "opt" lines, and the symbol table.
+
+      The file is written under a temporary name and then renamed, so that
+      concurrent runs never see a partial cache file.  Nothing is written if
+      any of the files read is not a regular file or has changed while being
+      read.
+
+*/
+static void write_cache (char *cachefile, char *filename)
+{
+   FILE *fp;
+   struct stat st;
+   include_file *pinc;
+   opt_line *po;
+   year_info *py;
+   month_info *pm;
+   day_info *pe;
+   text_entry *pt;
+   char *tmpfile;
+   long size, n;
+   unsigned long h;
+   int i, m, ok;
+
+   /* make sure the date file and included files are unchanged */
+
+   if (cache_mtime < 0 || stat(filename, &st) != 0 ||
+       (long) st.st_mtime != cache_mtime || (long) st.st_size != cache_size) {
+      return;
+   }
+   for (pinc = include_files; pinc; pinc = pinc->next) {
+      if (stat(pinc->path, &st) != 0 || ! S_ISREG(st.st_mode) ||
+          (long) st.st_mtime != pinc->mtime || (long) st.st_size != pinc->size) {
+         return;
+      }
+   }
+
+   tmpfile = alloc((int) strlen(cachefile) + 24);
+   sprintf(tmpfile, "%s.%ld", cachefile, (long) getpid());
+   if ((fp = fopen(tmpfile, "wb")) == NULL) {
+      fprintf(stderr, E_FOPEN_ERR, progname, tmpfile);
+      free(tmpfile);
+      return;
+   }
+
+   /* header, key, and files read (with the hashes of their contents) */
+
+   cache_sum = FNV_BASIS;
+   put_bytes(fp, CACHE_MAGIC, (long) strlen(CACHE_MAGIC));
+   put_long(fp, CACHE_VERSION);
+   put_long(fp, 0x01020304L);
+   put_str(fp, cache_key);
+
+   for (n = 1, pinc = include_files; pinc; pinc = pinc->next) n++;
+   put_long(fp, n + n_missing);
+
+   h = hash_file(filename, &size);
+   ok = size >= 0;
+   put_str(fp, filename);
+   put_long(fp, size);
+   put_long(fp, (long) h);
+
+   for (pinc = include_files; pinc; pinc = pinc->next) {
+      h = hash_file(pinc->path, &size);
+      ok &= size >= 0;
+      put_str(fp, pinc->path);
+      put_long(fp, size);
+      put_long(fp, (long) h);
+   }
+
+   for (i = 0; i < n_missing; i++) {
+      put_str(fp, missing_files[i]);
+      put_long(fp, -1L);
+      put_long(fp, 0L);
+   }
+
+   /* "opt" lines, symbol table, and other state */
+
+   for (n = 0, po = opt_lines; po; po = po->next) n++;
+   put_long(fp, n);
+   for (po = opt_lines; po; po = po->next) {
+      put_str(fp, po->where);
+      put_long(fp, (long) po->nwords);
+      for (i = 0; i < po->nwords; i++) put_str(fp, po->words[i]);
+   }
+
+   put_long(fp, (long) pp_nsyms);
+   for (i = 0; i < n_pp_syms; i++) {
+      if (pp_syms[i].defined) {
+         put_str(fp, pp_syms[i].name);
+         if (pp_syms[i].val) {
+            put_long(fp, (long) strlen(pp_syms[i].val) + 1);
+            put_bytes(fp, "=", 1L);
+            put_bytes(fp, pp_syms[i].val, (long) strlen(pp_syms[i].val) + 1);
          }
-         curr_year = ALL_YEARS;   /* reset to wildcard */
-         return match ? PARSE_OK : PARSE_NOMATCH;
-      } 
-      else return enter_note(mm, pword, n);
-      break;
+         else put_str(fp, "");
+      }
+   }
 
-   case DT_OTHER:   /* unrecognized token */
-      return PARSE_INVLINE;
-      break;
-      
-   case DT_DELETE:   /* fall through to actually delete event entry */
-      pword++;
-      delete_entry = TRUE;
-      
-   default:
-      /* At this point, we assume that the configuration file line is an event
-         specification... */
+   put_long(fp, (long) curr_year);
+   put_long(fp, (long) input_language);
 
-      /* If the current year is a wildcard ("all" or "*" - see above), enter
-         the date for each year covered at least partially by the calendar.
-         Note that a "mm/dd/yy" date spec explicitly resets curr_year;
-         parse_date() sets the 'curr_year_reset' flag when this happens so
-         that we can quit immediately.
-      */
-      if (curr_year == ALL_YEARS) {
-         match = FALSE;
-         /* loop over each applicable year */
-         for (curr_year = init_year; curr_year <= final_year; curr_year++) {
-            match |= process_event_specification(pword, &text_type, &ptext) == PARSE_OK;
-            if (curr_year_reset) {   /* quit if year reset */
-               return match ? PARSE_OK : PARSE_NOMATCH;
-            }
+   /* event text (numbering each entry for reference below) */
+
+   put_long(fp, (long) text_count);
+   for (i = 0, n = 0; i < text_tab_size; i++) {
+      for (pt = text_tab[i]; pt; pt = pt->next) {
+         pt->cache_index = n++;
+         put_long(fp, (long) pt->ci_hash);
+         put_str(fp, (char *) (pt + 1));
+      }
+   }
+
+#define TEXT_INDEX(_p)   (((text_entry *) (_p) - 1)->cache_index)
+
+   /* years, months, and events (sorted by day, dropping deleted ones) */
+
+   for (n = 0, py = head; py; py = py->next) n++;
+   put_long(fp, n);
+   for (py = head; py; py = py->next) {
+      put_long(fp, (long) py->year);
+      for (n = 0, m = 0; m < 12; m++) n += py->month[m] != NULL;
+      put_long(fp, n);
+      for (m = 0; m < 12; m++) {
+         if ((pm = py->month[m]) == NULL) continue;
+         if (pm->unsorted) sort_day_info(pm);
+         put_long(fp, (long) m);
+         put_long(fp, (long) pm->holidays);
+         put_long(fp, (long) pm->nevents);
+         for (i = 0, pe = pm->event; i < pm->nevents; i++, pe++) {
+            put_long(fp, (long) pe->day);
+            put_long(fp, (long) pe->is_holiday);
+            put_long(fp, TEXT_INDEX(pe->text));
          }
-         
-         /* restore year to wildcard for next time */
-         curr_year = ALL_YEARS;
-         delete_entry = FALSE;
-         return match ? PARSE_OK : PARSE_NOMATCH;
       }
+   }
 
-      match = process_event_specification(pword, &text_type, &ptext);
-      delete_entry = FALSE;
-      return match;
-      
-      break;
+   /* span events (dropping deleted ones) */
+
+   for (n = 0, i = 0; i < nspans; i++) n += ! span_pool[i].deleted;
+   put_long(fp, n);
+   for (i = 0; i < nspans; i++) {
+      if (span_pool[i].deleted) continue;
+      put_long(fp, span_pool[i].first);
+      put_long(fp, span_pool[i].last);
+      put_long(fp, TEXT_INDEX(span_pool[i].text));
+      put_long(fp, (long) span_pool[i].is_holiday);
    }
+
+#undef TEXT_INDEX
+
+   n = (long) cache_sum;   /* checksum of all the above */
+   put_long(fp, n);
+   fwrite(CACHE_MAGIC, 1, sizeof(long), fp);   /* trailer */
+
+   ok &= ! ferror(fp);
+   ok &= fclose(fp) == 0;
+
+#ifdef BUILD_ENV_DJGPP
+   if (ok) (void) remove(cachefile);   /* rename() won't replace it */
+#endif
+
+   if (! ok || rename(tmpfile, cachefile) != 0) (void) remove(tmpfile);
+   free(tmpfile);
+
+   return;
 }
+
+#endif   /* CACHE_OK */
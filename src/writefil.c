@@ -311,23 +311,23 @@
 #define ADDFONT(name, size, font, isarray)   do {			\
 	char *p = alloc(strlen(name) + strlen(size) + 2);		\
 	sprintf(allfonts[nfonts++] = p, "%s_%s", name, size);		\
-	printf("/%s { %sfontsize ", p, font);				\
-	if (isarray) printf("%s get ", size);				\
-	printf("%sfont FontFind } def\n", font);			\
+	out_printf("/%s { %sfontsize ", p, font);			\
+	if (isarray) out_printf("%s get ", size);			\
+	out_printf("%sfont FontFind } def\n", font);			\
 } while (0)
 
 /* print PostScript string definition */
 #define PRINT_DEF(name, value)   do {					\
-	printf("/%s ", name);						\
+	out_printf("/%s ", name);					\
 	print_word(value);						\
-	printf(" def\n");						\
+	OUT_LIT(" def\n");						\
 } while (0)
 
 /* add specified number of blank lines to HTML table entry */
 #define BLANKLINES(n)  do {						\
 	int i;								\
 	for (i = 0; i < n; i++)						\
-		printf("<br>&nbsp;");					\
+		OUT_LIT("<br>&nbsp;");					\
 } while(0)
 
 #define FOOTSTRINGS()   (lfoot[0] || cfoot[0] || rfoot[0])
@@ -337,12 +337,11 @@
    work_month = this_month, work_day = this_day, work_year = this_year
 
 /* 'clean' output */
-#define PUTCHAR_CLEAN(_fc, _c, _fp) \
-        fprintf((_fp), "%c", (_c) & CHAR_MSK)
+#define OUT_PUTCHAR_CLEAN(_fc, _c) \
+        out_char((_c) & CHAR_MSK)
 
-#define PUTSTR_CLEAN(_fc, _s, _fp) \
-   do { char *_p; for (_p = (_s); *_p; _p++) \
-   PUTCHAR_CLEAN(_fc, *_p, _fp); } while (0)
+#define OUT_PUTSTR_CLEAN(_fc, _s) \
+        out_str(_s)
 
 /* ---------------------------------------------------------------------------
 
@@ -359,6 +358,890 @@ static char *kw_note, *kw_opt, *kw_year;   /* keywords for -c output */
 
 static int debug_text;   /* generate debug output */
 
+/* kinds of text (and images) on the single-month calendars being printed,
+   which determine the PostScript procedures needed (cf. find_text_usage()) */
+static int use_daytext, use_holidaytext, use_notetext, use_images;
+
+/* 8-bit characters appearing in the text to be printed, which determine the
+   entries needed in the encoding vector for -r (cf. find_text_usage()) */
+static char used_chars[CHAR_MSK + 1];
+
+/* ---------------------------------------------------------------------------
+
+   PostScript Boilerplate
+
+*/
+
+/* Fixed PostScript procedures and definitions, written verbatim by
+   write_psfile(); the options affecting the prolog merely select among
+   them (or interleave a few formatted lines) */
+
+static const char ps_prtday_gray[] =
+   "% print 'day' in 'color' (black, gray, outline, or outline-gray; cf. pcaldefs.h)\n"
+   "% using single value in 'dategray' as gray shade\n"
+   "%\n"
+   "/prtday {					% black and white version\n"
+   "	gsave\n"
+   "	day 3 string cvs			% convert day to string\n"
+   "	[\n"
+   "		{ show }				% black (0)\n"
+   "		{ dategray setgray show }		% gray (1)\n"
+   "		{ true charpath stroke }		% outline (2)\n"
+   "		{ true charpath gsave			% outline-gray (3)\n"
+   "		  dategray setgray fill\n"
+   "		  grestore stroke }\n"
+   "	] color get exec			% execute operators for color\n"
+   "	grestore\n"
+   "} bind def\n\n";
+
+static const char ps_remap_font[] =
+   "/alt_dict 20 dict def			% Local storage\n"
+   "\n"
+   "% <oldfont> <newfont> remap_font => --\n"
+   "%\n"
+   "% create remapped font using one of the above 8-bit character remapping tables\n"
+   "%\n"
+   "/remap_font {\n"
+   "	alt_dict begin\n"
+   "		/newName exch def\n"
+   "		/oldName exch def\n"
+   "		/oldDict oldName findfont def\n"
+   "		/newDict oldDict maxlength dict def\n"
+   "		oldDict {\n"
+   "			exch dup /FID ne {\n"
+   "				dup /Encoding eq {\n"
+   "					exch dup length array copy\n"
+   "					newDict 3 1 roll put\n"
+   "				} {\n"
+   "					exch newDict 3 1 roll put\n"
+   "				} ifelse\n"
+   "			} {\n"
+   "				pop pop\n"
+   "			} ifelse\n"
+   "		} forall\n"
+   "		newDict /FontName newName put\n"
+   "		0 2 alt_mappings length 1 sub {\n"
+   "			dup\n"
+   "			alt_mappings exch get\n"
+   "			exch 1 add alt_mappings exch get\n"
+   "			newDict /Encoding get 3 1 roll put\n"
+   "		} for\n"
+   "		newName newDict definefont pop\n"
+   "	end\n"
+   "} bind def\n\n";
+
+static const char ps_grid_defs[] =
+   "/Y0 0 def				% Y-coordinate of calendar grid origin\n"
+   "\n"
+   "/gridwidth daywidth 7 mul def\n"
+   "/gridheight dayheight 6 mul def\n"
+   "/negdaywidth daywidth neg def\n"
+   "/negdayheight dayheight neg def\n"
+   "/neggridwidth gridwidth neg def\n"
+   "/neggridheight gridheight neg def\n"
+   "\n"
+   "/textmargin 2 def			% left/right margin for text\n"
+   "/notemargin 4 def			% left/right margin for notes\n"
+   "/charlinewidth 0.1 def			% width of outline characters\n"
+   "\n"
+   "/datewidth 2 array def			% for aligning holiday text\n"
+   "\n";
+
+static const char ps_moon_defs[] =
+   "/halfperiod 0.5 def			% scale factors, etc. used by 'domoon'\n"
+   "/quartperiod 0.25 def\n"
+   "/offset radius datemargin 0 get add def\n"
+   "/rect radius 2 sqrt mul quartperiod div def\n"
+   "\n";
+
+static const char ps_text_defs[] =
+   "/ROMAN 0 def				% font types for text in boxes\n"
+   "/BOLD 1 def\n"
+   "/ITALIC 2 def\n"
+   "/currfonttype ROMAN def\n"
+   "/boldoffset 0.5 def			% offset for overstriking bold text\n"
+   "\n"
+   "% simulate Italic text by slanting Roman text - note that this is properly\n"
+   "% called 'Oblique'\n"
+   "\n"
+   "/italicangle 12 def			% angle for slanting Italic text\n"
+   "/italicmatrix				% Italic font matrix\n"
+   " [notesfontsize 0 notesfontsize italicangle dup sin exch cos div mul\n"
+   " notesfontsize 0 0] def\n"
+   "\n"
+   "/hangingindent (   ) def		% for indenting continued text lines\n"
+   "\n";
+
+static const char ps_duplex[] =
+   "% disable duplex mode (if supported)\n"
+   "statusdict (duplexmode) known { statusdict begin false setduplexmode end } if\n"
+   "\n";
+
+static const char ps_fontset[] =
+   "%\n"
+   "% Utility functions:\n"
+   "%\n"
+   "\n"
+   "% <fontposition> FontSet => --\n"
+   "%\n"
+   "% set current font to element <fontposition> of 'allfonts' array\n"
+   "%\n"
+   "/FontSet {\n"
+   "	allfonts exch\n"
+   "	userdict /CurrentFontSet 2 index put\n"
+   "	get setfont\n"
+   "} bind def\n\n";
+
+static const char ps_fontset_sizes[] =
+   "% <size> *FontSet => --\n"
+   "%\n"
+   "% fetch pre-scaled font (of desired calendar size) from 'allfonts' array\n"
+   "%\n"
+   "/TitleFontSet {TF add FontSet} bind def\n"
+   "\n"
+   "/DateFontSet {DF add FontSet} bind def\n"
+   "\n"
+   "% -- *FontSet => --\n"
+   "%\n"
+   "% fetch pre-scaled font (of constant size) from 'allfonts' array\n"
+   "%\n"
+   "/WeekdayFontSet {WF FontSet} bind def\n"
+   "\n";
+
+static const char ps_center[] =
+   "% <string> <width> center => --\n"
+   "%\n"
+   "% display <string> centered horizontally in <width>\n"
+   "%\n"
+   "/center {\n"
+   "	1 index stringwidth pop sub 2 div 0 rmoveto show\n"
+   "} bind def\n\n";
+
+/* These 2 routines ('left' and 'right') were added to support the '-W'
+   option (horizontal alignment of title on monthly-format calendar). */
+static const char ps_left[] =
+   "% <string> <width> left => --\n"
+   "%\n"
+   "% display <string> justified left in <width>\n"
+   "%\n"
+   "/left {\n"
+   "   1 index show\n"
+   "} bind def\n\n";
+
+static const char ps_right[] =
+   "% <string> <width> right => --\n"
+   "%\n"
+   "% display <string> justified right in <width>\n"
+   "%\n"
+   "/right {\n"
+   "   1 index stringwidth pop sub 0 rmoveto show\n"
+   "} bind def\n\n";
+
+static const char ps_strcat[] =
+   "% <str1> <str2> strcat => <string>\n"
+   "%\n"
+   "% concatenate <str1> and <str2>; push result onto stack\n"
+   "%\n"
+   "/strcat {\n"
+   "	2 copy\n"
+   "	length exch length\n"
+   "	dup 3 -1 roll add\n"
+   "	string\n"
+   "	dup 0 6 -1 roll putinterval\n"
+   "	dup 3 -1 roll 4 -1 roll putinterval\n"
+   "} bind def\n\n";
+
+static const char ps_nextbox[] =
+   "% -- nextbox => --\n"
+   "%\n"
+   "% move to same relative position within following day's box\n"
+   "%\n"
+   "/nextbox {\n"
+   "	day startbox add 7 mod 0 eq			% end of week?\n"
+   "		{ neggridwidth daywidth add negdayheight rmoveto }  % next row\n"
+   "		{ daywidth 0 rmoveto }				    % next col\n"
+   "	ifelse\n"
+   "} bind def\n\n";
+
+static const char ps_boxpos[] =
+   "% <box> boxpos => <x> <y>\n"
+   "%\n"
+   "% calculate and push coordinates of upper-left corner of <box> (0..41)\n"
+   "%\n"
+   "/boxpos {\n"
+   "	dup 7 mod daywidth mul					% x-coord\n"
+   "	exch 7 idiv negdayheight mul Y0 add			% y-coord\n"
+   "} bind def\n\n";
+
+static const char ps_datepos[] =
+   "% <day> datepos => <x> <y>\n"
+   "%\n"
+   "% calculate and push coordinates of upper-left corner of box for <day>\n"
+   "%\n"
+   "/datepos {\n"
+   "	startbox add 1 sub dup 7 mod daywidth mul		% x-coord\n"
+   "	exch 7 idiv negdayheight mul Y0 add			% y-coord\n"
+   "} bind def\n\n";
+
+/* first part of drawtitle{}; the title alignment (-W) follows */
+static const char ps_drawtitle[] =
+   "%\n"
+   "% Functions for drawing components of calendar:\n"
+   "%\n"
+   "% The point size of a PostScript font includes the descenders on [gjpqy],\n"
+   "% but the Y-origin for printing text starts above any descenders (at the\n"
+   "% bottom of the upper-case characters).  The following code - and other\n"
+   "% code concerned with vertical spacing - assumes that the descenders\n"
+   "% occupy 1/4 of the overall point size.\n\n"
+   "% -- drawtitle => --\n"
+   "%\n"
+   "% print month/year title centered at top of calendar\n"
+   "%\n"
+   "/drawtitle {\n"
+   "	/fontsize titlefontsize calsize get def\n"
+   "	calsize TitleFontSet\n"
+   "	/month_name month_names month 1 sub get def\n"
+   "	/yearstring year 10 string cvs def\n"
+   "	0 Y0 fontsize 0.25 mul add\n"
+   "	  calsize small eq { 4 } { weekdayfontsize } ifelse\n"
+   "	  1.15 mul add moveto\n";
+
+static const char ps_drawdaynames[] =
+   "% -- drawdaynames => --\n"
+   "%\n"
+   "% print weekday names centered above respective columns\n"
+   "%\n"
+   "/drawdaynames {	\n"
+   "	WeekdayFontSet\n"
+   "	0 1 6 {\n"
+   "		/i exch def\n"
+   "		i daywidth mul Y0 weekdayfontsize 0.4 mul add moveto\n"
+   "		day_names i get\n"
+   "		daywidth center\n"
+   "	} for\n"
+   "} bind def\n\n";
+
+static const char ps_drawgrid[] =
+   "% -- drawgrid => --\n"
+   "%\n"
+   "% draw the grid (6 rows x 7 columns) for the calendar\n"
+   "%\n"
+   "/drawgrid {\n"
+   "	gridlinewidth calsize get setlinewidth\n"
+   "\n"
+   "	1 1 6 {					% inner vertical lines\n"
+   "		daywidth mul Y0 moveto\n"
+   "		0 neggridheight rlineto\n"
+   "		stroke\n"
+   "	} for\n"
+   "\n"
+   "	1 1 5 {					% inner horizontal lines\n"
+   "		0 exch negdayheight mul Y0 add moveto\n"
+   "		gridwidth 0 rlineto\n"
+   "		stroke\n"
+   "	} for\n"
+   "\n"
+   "	newpath					% border (w/mitered corners)\n"
+   "	0 Y0 moveto\n"
+   "	gridwidth 0 rlineto\n"
+   "	0 neggridheight rlineto\n"
+   "	neggridwidth 0 rlineto\n"
+   "	closepath\n"
+   "	stroke\n"
+   "} bind def\n\n";
+
+static const char ps_drawnums[] =
+   "% -- drawnums => --\n"
+   "%\n"
+   "% print dates in appropriate boxes of calendar\n"
+   "%\n"
+   "/drawnums {\n"
+   "	/fontsize datefontsize calsize get def\n"
+   "	/margin datemargin calsize get def\n"
+   "	calsize DateFontSet\n"
+   "	charlinewidth setlinewidth\n"
+   "	1 datepos fontsize 0.75 mul margin add sub exch margin add exch moveto\n"
+   "\n"
+   "	% calculate date widths for 'holidaytext' to use; use '2' for all\n"
+   "	% single-digit dates and '22' for all double-digit dates\n"
+   "	calsize large eq {\n"
+   "		datewidth 0 (2) stringwidth pop margin 2 mul add put\n"
+   "		datewidth 1 (22) stringwidth pop margin 2 mul add put\n"
+   "	} if\n"
+   "\n"
+   "	calsize small eq {\n"
+   "		/color 0 def		% small calendar dates (all black)\n"
+   "		1 1 ndays {\n"
+   "			/day exch def\n"
+   "			prtday\n"
+   "			nextbox\n"
+   "		} for\n"
+   "	} {\n"
+   "		1 1 ndays {		% medium/large calendar dates\n"
+   "			/day exch def\n"
+   "			/color date_color day get def\n"
+   "			prtday\n"
+   "			nextbox\n"
+   "		} for\n"
+   "	} ifelse\n"
+   "} bind def\n\n";
+
+static const char ps_startpage[] =
+   "% -- startpage => --\n"
+   "%\n"
+   "% initialize new physical page\n"
+   "%\n"
+   "/startpage {\n"
+   "	rval rotate\n"
+   "	xsval ysval scale\n"
+   "	xtval ytval translate\n"
+   "} bind def\n\n";
+
+/* first part of calendar{}; the rest depends on the calendar format and on
+   the features used */
+static const char ps_calendar[] =
+   "% -- calendar => --\n"
+   "%\n"
+   "% draw calendar for 'month'/'year', with various features enabled/disabled\n"
+   "% according to 'calsize'\n"
+   "%\n"
+   "/calendar {\n"
+   "	drawtitle					% month/year\n"
+   "	calsize small ne { drawdaynames } if		% weekday names\n";
+
+#ifdef OUTLINE_BLACK
+/* with OUTLINE_BLACK, outlined dates (-O) are drawn in black rather than the
+   specified color */
+static const char ps_prtday_color[] =
+   "% print 'day' in 'color' (black, gray, outline, or outline-gray; cf. pcaldefs.h)\n"
+   "% using three values in 'dategray' as red/green/blue levels; 'gray' will\n"
+   "% print as solid color, 'outline' as black outline; 'outline-gray' as black\n"
+   "% outline filled with color\n"
+   "%\n"
+   "/prtday {					% color version\n"
+   "	gsave\n"
+   "	day 3 string cvs			% convert day to string\n"
+   "	[\n"
+   "		{ show }				% black (0)\n"
+   "		{ dategray aload pop setrgbcolor show }	% gray (1)\n"
+   "		{ true charpath stroke }		% outline (2; black)\n"
+   "		{ true charpath gsave			% outline-gray (3)\n"
+   "		  dategray aload pop setrgbcolor\n"
+   "		  fill grestore stroke }\n"
+   "	] color get exec			% execute operators for color\n"
+   "	grestore\n"
+   "} bind def\n\n";
+#else
+
+static const char ps_prtday_color[] =
+   "% print 'day' in 'color' (black, gray, outline, or outline-gray; cf. pcaldefs.h)\n"
+   "% using three values in 'dategray' as red/green/blue levels; 'gray' will\n"
+   "% print as solid color, 'outline' as color outline; 'outline-gray' as black\n"
+   "% outline filled with color\n"
+   "%\n"
+   "/prtday {					% color version\n"
+   "	gsave\n"
+   "	day 3 string cvs			% convert day to string\n"
+   "	[\n"
+   "		{ show }				% black (0)\n"
+   "		{ dategray aload pop setrgbcolor show }	% gray (1)\n"
+   "		{ dategray aload pop setrgbcolor	% outline (2; color)\n"
+   "		  true charpath stroke }\n"
+   "		{ true charpath gsave			% outline-gray (3)\n"
+   "		  dategray aload pop setrgbcolor\n"
+   "		  fill grestore stroke }\n"
+   "	] color get exec			% execute operators for color\n"
+   "	grestore\n"
+   "} bind def\n\n";
+#endif
+
+static const char ps_setfill_color[] =
+   "% set fill box color using three values in 'fillgray' as red/green/blue levels\n"
+   "%\n"
+   "/setfill {					% color version\n"
+   "	fillgray aload pop setrgbcolor\n"
+   "} def\n\n";
+
+static const char ps_setfill_gray[] =
+   "% set fill box shading using single value in 'fillgray'\n"
+   "%\n"
+   "/setfill {					% black and white version\n"
+   "	fillgray setgray\n"
+   "} def\n\n";
+
+static const char ps_footstrings[] =
+   "% -- footstrings => --\n"
+   "%\n"
+   "% print foot strings ([LCR]footstring) at bottom of page\n"
+   "%\n"
+   "/footstrings {\n"
+   "	FootFontSet\n"
+   "%	/yfoot { Y0 neggridheight add footfontsize 1.25 mul sub } bind def\n"
+   "	/yfoot { neggridheight 15 sub } bind def\n"
+   "	0 yfoot moveto\n"
+   "	Lfootstring show\n"
+   "	gridwidth Rfootstring stringwidth pop sub yfoot moveto\n"
+   "	Rfootstring show\n"
+   "	0 yfoot moveto\n"
+   "	Cfootstring gridwidth center\n"
+   "} bind def\n\n";
+
+static const char ps_fillboxes[] =
+   "% <first> <last> fillboxes => --\n"
+   "%\n"
+   "% fill empty calendar boxes in range <first>..<last> (0..41)\n"
+   "%\n"
+   "/fillboxes {\n"
+   "	/last exch def\n"
+   "	/first exch def\n"
+   "\n"
+   "	first 1 last {		% loop through range of boxes\n"
+   "		/box exch def\n"
+   "		/fillit true def\n"
+   "		calsize large eq {	% skip note and small calendar boxes\n"
+   "			noteboxes { box eq { /fillit false def } if } forall\n"
+   "			box prev_small_cal eq box next_small_cal eq or {\n"
+   "				/fillit false def\n"
+   "			} if\n"
+   "		} if\n"
+   "		fillit {		% move to position and fill the box\n"
+   "			box boxpos moveto\n"
+   "			gsave\n"
+   "			setfill\n"
+   "			daywidth 0 rlineto\n"
+   "			0 negdayheight rlineto\n"
+   "			negdaywidth 0 rlineto\n"
+   "			closepath fill\n"
+   "			grestore\n"
+   "		} if\n"
+   "	} for\n"
+   "} bind def\n\n";
+
+static const char ps_drawfill[] =
+   "% -- drawfill => --\n"
+   "%\n"
+   "% fill in unused boxes before and after calendar dates\n"
+   "%\n"
+   "/drawfill {\n"
+   "	0 startbox 1 sub fillboxes		% fill boxes before calendar\n"
+   "	startbox ndays add 41 fillboxes		% fill boxes after calendar\n"
+   "} bind def\n\n";
+
+static const char ps_printmonth_landscape[] =
+   "/hspace gridwidth daywidth add def	% one date box space between calendars\n"
+   "/hscale 0.2258 def			% 1 / (4 + 3/7)\n"
+   "/vspace gridheight ytop add 135 add neg def % vertical spacing\n"
+   "/vscale .25 def 			% beats me how this was calculated\n"
+   "\n"
+   "/printmonth {\n"
+   "	/calsize medium def\n"
+   "\n"
+   "	posn 0 eq {		% assume first month printed on page is posn 0\n"
+   "		startpage\n"
+   "		footstrings\n"
+   "	} if\n"
+   "\n"
+   "	gsave			% draw medium calendar at selected position\n"
+   "	hscale vscale scale	% landscape mode - 3 rows, 4 cols\n"
+   "	posn 4 mod hspace mul\n"
+   "	posn 4 idiv vspace mul 45 add\n"
+   "	translate\n"
+   "	calendar\n"
+   "	grestore\n"
+   "} bind def\n\n";
+
+static const char ps_printmonth_portrait[] =
+   "/hspace gridwidth daywidth add def	% one date box space between calendars\n"
+   "/hscale 0.3043 def			% 1 / (3 + 2/7)\n"
+   "/vspace gridheight ytop add 135 add neg def % vertical spacing\n"
+   "/vscale .194 def			% beats me how this was calculated\n"
+   "\n"
+   "/printmonth {	\n"
+   "	/calsize medium def\n"
+   "\n"
+   "	posn 0 eq {		% assume first month printed on page is posn 0\n"
+   "		gsave		% print foot strings at original scale\n"
+   "		startpage\n"
+   "		0 25 translate  % reposition footstrings slightly higher\n"
+   "		footstrings\n"
+   "		grestore\n"
+   "\n"
+   "		/sv_ysval ysval def	% re-scale Y axis to full page height\n"
+   "		/ysval xsval pageheight pagewidth div dup mul mul def\n"
+   "		startpage\n"
+   "		/ysval sv_ysval def\n"
+   "	} if\n"
+   "\n"
+   "	gsave			% draw medium calendar at selected position\n"
+   "	hscale vscale scale	% portrait mode - 4 rows, 3 cols\n"
+   "	posn 3 mod hspace mul\n"
+   "	posn 3 idiv vspace mul 155 add\n"
+   "	translate\n"
+   "	calendar\n"
+   "	grestore\n"
+   "} bind def\n\n";
+
+static const char ps_text_header[] =
+   "%\n"
+   "% Functions for printing text (and/or images) inside boxes:\n"
+   "%\n"
+   "\n";
+
+static const char ps_daytext[] =
+   "% <day> <text> daytext => --\n"
+   "%\n"
+   "% print <text> in <day> box (below date)\n"
+   "%\n"
+   "/daytext {\n"
+   "	/mytext exch def /day exch def\n"
+   "	NotesFontSet\n"
+   "	day datepos datefontsize large get 0.75 mul datemargin large get\n"
+   "	  2 mul add notesfontsize 0.75 mul add sub dup\n"
+   "	  /ypos exch def exch textmargin add exch moveto\n"
+   "	currentpoint pop /LM exch def\n"
+   "	/RM LM daywidth textmargin 2 mul sub add def\n"
+   "	showtext\n"
+   "} bind def\n\n";
+
+static const char ps_holidaytext[] =
+   "% <day> <text> holidaytext => --\n"
+   "%\n"
+   "% print <text> in <day> box (to right of date)\n"
+   "%\n"
+   "/holidaytext {\n"
+   "	/mytext exch def /day exch def\n"
+   "\n"
+   "	/datesize datefontsize large get def \n"
+   "	/margin datemargin large get def\n"
+   "	/dwidth datewidth day 10 lt { 0 } { 1 } ifelse get def\n"
+   "\n"
+   "	% display the text between the date and the moon icon (if any)\n"
+   "	NotesFontSet\n"
+   "	day datepos margin notesfontsize 0.75 mul add sub dup\n"
+   "	/ypos exch def exch dwidth add exch moveto\n"
+   "	currentpoint pop /LM exch def\n"
+   "	/mwidth do-moon-p {offset radius add} {0} ifelse def	% moon width\n"
+   "	/RM LM daywidth textmargin sub dwidth mwidth add sub add def\n"
+   "	showtext\n"
+   "} bind def\n\n";
+
+static const char ps_notetext[] =
+   "% <box> <text> notetext => --\n"
+   "%\n"
+   "% print notes heading (if any) and <text> in <box> (0..41)\n"
+   "%\n"
+   "/notetext {\n"
+   "	/mytext exch def /box exch def\n"
+   "\n"
+   "	% skip notes box heading if null\n"
+   "	notesheading () eq {\n"
+   "		box boxpos notemargin notesfontsize 0.75 mul add sub dup\n"
+   "	} {\n"
+   "		box boxpos notemargin headingfontsize 0.75 mul add sub exch\n"
+   "		  notemargin add exch moveto\n"
+   "		HeadingFontSet\n"
+   "		notesheading show\n"
+   "		box boxpos notemargin headingfontsize add\n"
+   "		  notesfontsize add sub dup\n"
+   "	} ifelse\n"
+   "	/ypos exch def exch notemargin add exch moveto\n"
+   "\n"
+   "	% display the notes text\n"
+   "	NotesFontSet\n"
+   "	/LM currentpoint pop def\n"
+   "	/RM LM daywidth notemargin 2 mul sub add def\n"
+   "	showtext\n"
+   "} bind def\n\n";
+
+static const char ps_crlf[] =
+   "% -- crlf => --\n"
+   "%\n"
+   "% simulate carriage return/line feed sequence\n"
+   "%\n"
+   "/crlf {\n"
+   "	ypos notesfontsize sub /ypos exch def LM ypos moveto\n"
+   "} bind def\n\n";
+
+static const char ps_prstr[] =
+   "% <string> prstr => --\n"
+   "%\n"
+   "% print <string> on current line if possible; otherwise print on next line\n"
+   "%\n"
+   "/prstr {\n"
+   "	gsave				% in case rescaling is necessary\n"
+   "	dup stringwidth pop currentpoint pop add RM gt {	% too wide?\n"
+   "		% move to the next line (unless this is the initial word)\n"
+   "		currentpoint pop LM ne {\n"
+   "			crlf hangingindent show\n"
+   "		} if\n"
+   "		% rescale in X dimension as necessary to make word fit\n"
+   "		dup stringwidth pop RM currentpoint pop sub gt {\n"
+   "			dup stringwidth pop RM currentpoint pop sub exch div 1\n"
+   "			scale\n"
+   "		} if\n"
+   "	} if\n"
+   "	currfonttype BOLD eq\n"
+   "		{ dup currentpoint 2 index show exch 0.5 add exch moveto show }\n"
+   "		{ show }\n"
+   "	ifelse\n"
+   "	currentpoint grestore moveto	% grestore alone would reset position\n"
+   "} bind def\n\n";
+
+static const char ps_showtext[] =
+   "% -- showtext => --\n"
+   "%\n"
+   "% print words in 'mytext', inserting line breaks where necessary (or requested)\n"
+   "%\n"
+   "/showtext {\n"
+   "	mytext {\n"
+   "		/word exch def\n"
+   "		/i 1 def\n"
+   "		/n 0 def\n"
+   "\n"
+   "		% look up current word in list of special formatting strings\n"
+   "		[ linesep boldfont italicfont romanfont ] {\n"
+   "			word eq {\n"
+   "				/n i def\n"
+   "			} if\n"
+   "			/i i 1 add def\n"
+   "		} forall\n"
+   "	\n"
+   "		% n will be 0 if current word is an ordinary word, 1..4 if it\n"
+   "		% is a formatting string; execute corresponding block of code\n"
+   "		[\n"
+   "			{ word prstr ( ) show }		% ordinary word\n"
+   "\n"
+   "			{ crlf				% line separator (.p)\n"
+   "			  NotesFontSet }		% reset font type\n"
+   "\n"
+   "			{ NotesFontSet			% font => bold (.b)\n"
+   "			  /currfonttype BOLD def }\n"
+   "\n"
+   "			{ /currfonttype ITALIC def	% font => italic (.i)\n"
+   "			  notesfont findfont italicmatrix makefont setfont }\n"
+   "\n"
+   "			{ NotesFontSet }		% font => roman (.r)\n"
+   "		] n get exec\n"
+   "	} forall\n"
+   "} bind def\n\n";
+
+static const char ps_epsimage[] =
+   "% <day> <text> <EPS-image-filename> <x-scaling> <y-scaling> <x-offset> <y-offset> epsimage => --\n"
+   "%\n"
+   "% print image <EPS-image-filename> in <day> box (below date)\n"
+   "%\n"
+   "/epsimage {\n"
+   "	/yoffset exch def /xoffset exch def\n"
+   "	/yscale exch def /xscale exch def\n"
+   "	/myimage exch def /mytext exch def /day exch def\n"
+   "	NotesFontSet\n"
+   "	day datepos datefontsize large get 0.75 mul datemargin large get\n"
+   "	2 mul add\n"
+   "	sub dup\n"
+   "	/ypos exch def exch textmargin add exch\n"
+   "	moveto\n"
+   "	currentpoint\n"
+   "	\n"
+   "	gsave\n"
+   "	yoffset add exch xoffset add exch  % add the X,Y offsets\n"
+   "	translate\n"
+   "	xscale yscale scale\n"
+   "\n"
+   "	% \n"
+   "	% Temporarily redefine the 'showpage' operator to null so that it's\n"
+   "	% ignored when the EPS image file is processed...\n"
+   "	%\n"
+   "	1 dict begin /showpage { } bind def\n"
+   "	myimage run\n"
+   "	end\n"
+   "        \n"
+   "	grestore\n"
+   "} bind def\n\n";
+
+/* first part of printmonth{} (single-month calendars) */
+static const char ps_printmonth[] =
+   "% -- printmonth => --\n"
+   "%\n"
+   "% print full-size calendar for 'month'/'year' on single page\n"
+   "%\n"
+   "/printmonth {\n"
+   "	/calsize large def\n"
+   "	startpage\n"
+   "	calendar\n";
+
+static const char ps_printsmallcals[] =
+   "% scale factor (slightly < 1/7) and offset for printing small calendars\n"
+   "/scscale .138 def\n"
+   "/scoffset gridwidth gridwidth scscale 7 mul mul sub 2.0 div def\n"
+   "\n"
+   "% -- printsmallcals => --\n"
+   "%\n"
+   "% print small calendars in boxes 'prev_small_cal' and 'next_small_cal'\n"
+   "%\n"
+   "/printsmallcals {\n"
+   "	/calsize small def\n"
+   "	/sv_startbox startbox def\n"
+   "\n"
+   "	prev_small_cal 0 ge {			% previous month/year\n"
+   "		/year p_year def\n"
+   "		/month p_month def\n"
+   "		/startbox p_startbox def\n"
+   "		/ndays p_ndays def\n"
+   "		gsave\n"
+   "		prev_small_cal boxpos translate\n"
+   "		scscale dup scale\n"
+   "		scoffset ytop neg translate\n"
+   "		calendar\n"
+   "		grestore\n"
+   "	} if\n"
+   "\n"
+   "	next_small_cal 0 ge {			% next month/year\n"
+   "		/year n_year def\n"
+   "		/month n_month def\n"
+   "		/startbox n_startbox def\n"
+   "		/ndays n_ndays def\n"
+   "		gsave\n"
+   "		next_small_cal boxpos translate\n"
+   "		scscale dup scale\n"
+   "		scoffset ytop neg translate\n"
+   "		calendar\n"
+   "		grestore\n"
+   "	} if\n"
+   "\n"
+   "	/startbox sv_startbox def		% required for text boxes\n"
+   "} bind def\n\n";
+
+static const char ps_drawjnums[] =
+   "% -- drawjnums => --\n"
+   "%\n"
+   "% print day-of-year (and, optionally, days remaining) for each date\n"
+   "%\n"
+   "/drawjnums {\n"
+   "	NotesFontSet\n"
+   "	1 datepos dayheight 3 sub sub exch daywidth 3 sub add exch moveto\n"
+   "\n"
+   "	1 1 ndays {\n"
+   "		/day exch def\n"
+   "		/jday jdstart day add 1 sub def\n"
+   "		/str jday 3 string cvs def\n"
+   "		julian-dates true eq {		% print days left in year?\n"
+   "			/str str ( \\050) strcat yearlen jday sub 3 string cvs\n"
+   "				strcat (\\051) strcat def\n"
+   "		} if\n"
+   "		gsave\n"
+   "		str dup stringwidth pop 0 exch sub 0 rmoveto show\n"
+   "		grestore\n"
+   "		nextbox\n"
+   "	} for\n"
+   "} bind def\n\n";
+
+static const char ps_domoon[] =
+   "%\n"
+   "% Moon-drawing functions:\n"
+   "%\n\n"
+   "% <phase> domoon => --\n"
+   "%\n"
+   "% draw icon showing moon at <phase> (0 = new; .25 = fq; .5 = full; .75 = lq)\n"
+   "%\n"
+   "/domoon {\n"
+   "	/phase exch def\n"
+   "\n"
+   "	gsave\n"
+   "	currentpoint translate\n"
+   "	newpath\n"
+   "\n"
+   "	% if moon is full, just draw unfilled circle\n"
+   "\n"
+   "	phase halfperiod .01 sub ge phase halfperiod .01 add le and {\n"
+   "		0 0 radius\n"
+   "		0 360 arc stroke\n"
+   "	}\n"
+   "	{\n"
+   "		% draw the line arc now; prepare (but don't draw) the fill arc\n"
+   "\n"
+   "		0 0 radius			% for line and fill arcs\n"
+   "		0 0 radius \n"
+   "		phase halfperiod lt {		% phase between new and full\n"
+   "			270 90 arc stroke	% (line on right, fill on left)\n"
+   "			0 radius neg moveto\n"
+   "			270 90 arcn \n"
+   "		}\n"
+   "		{				% phase between full and new\n"
+   "			90 270 arc stroke	% (line on left, fill on right)\n"
+   "			0 radius neg moveto\n"
+   "			270 90 arc \n"
+   "			/phase phase halfperiod sub def\n"
+   "		} ifelse\n"
+   "\n"
+   "		% curveto uses (x0,y0) [current point], (x1,y1), (x2,y2),\n"
+   "		% and (x3,y3) as the control points for drawing a Bezier\n"
+   "		% cubic section, used here as the curve dividing the moon\n"
+   "		% icon into dark and light sections.  x1 is in the range\n"
+   "		% -R*sqrt(2) <= x1 <= R*sqrt(2) and y1 is in the range\n"
+   "		% 0 <= y1 <= R; note that except in the degenerate case\n"
+   "		% where x1 = y1 = x2 = y2 = 0, the curve does not actually\n"
+   "		% pass through (x1,y1) or (x2,y2).\n"
+   "\n"
+   "		/x1 quartperiod phase sub rect mul def\n"
+   "		/y1 x1 abs 2 sqrt div def\n"
+   "\n"
+   "		% push control points for curveto\n"
+   "\n"
+   "					% x0 = 0   (current\n"
+   "					% y0 = R    point)\n"
+   "		x1			% x1\n"
+   "		y1			% y1\n"
+   "		x1			% x2 = x1\n"
+   "		y1 neg			% y2 = -y1\n"
+   "		0			% x3 = 0\n"
+   "		radius neg		% y3 = -R\n"
+   "\n"
+   "		% draw Bezier curve; fill area between curve and fill arc\n"
+   "\n"
+   "		curveto\n"
+   "		fill\n"
+   "	} ifelse\n"
+   "\n"
+   "	grestore\n"
+   "} bind def\n\n";
+
+static const char ps_do_moon_p[] =
+   "% -- do-moon-p => <bool>\n"
+   "%\n"
+   "% determine whether or not moon icon is to be drawn on 'day'; push result\n"
+   "%\n"
+   "/do-moon-p {\n"
+   "	draw-moons (some) eq {		% printing quarter moons?  look up day\n"
+   "		/p false def\n"
+   "		quarter_moons { day eq { /p true def } if } forall\n"
+   "		p\n"
+   "	}\n"
+   "	{\n"
+   "		draw-moons		% all moons or no moons\n"
+   "	} ifelse\n"
+   "} bind def\n\n";
+
+static const char ps_drawmoons[] =
+   "% -- drawmoons => --\n"
+   "%\n"
+   "% main routine to draw moon icons on calendar\n"
+   "%\n"
+   "/drawmoons {\n"
+   "	gsave\n"
+   "	moonlinewidth setlinewidth\n"
+   "	1 datepos offset sub exch daywidth add offset sub exch moveto\n"
+   "	/n 0 def			% index into moon_phases\n"
+   "	1 1 ndays {\n"
+   "		/day exch def\n"
+   "		do-moon-p {		% draw a moon today?\n"
+   "			moon_phases n get domoon\n"
+   "			/n n 1 add def\n"
+   "		} if\n"
+   "		nextbox\n"
+   "	} for\n"
+   "	grestore\n"
+   "} bind def\n\n";
+
 /* ---------------------------------------------------------------------------
 
    External Routine References & Function Prototypes
@@ -367,31 +1250,75 @@ static int debug_text;   /* generate debug output */
 
 /* ---------------------------------------------------------------------------
 
-   ps_prtday_bw
+   note_used_chars
+
+   Notes:
+
+      This routine flags (in 'used_chars[]') each 8-bit character in the
+      specified string, so that write_psfile() can limit the encoding vector
+      for -r to the characters actually printed.
+
+      Any format specifiers in the string expand only to digits and to month
+      and day names, which write_psfile() flags separately.
+
+*/
+static void note_used_chars (const char *p)
+{
+   for (; *p; p++) {
+      if (*p & 0200) used_chars[*p & CHAR_MSK] = TRUE;
+   }
+
+   return;
+}
+
+/* ---------------------------------------------------------------------------
+
+   find_text_usage
 
    Notes:
 
-      none
+      This routine notes which kinds of text (day, holiday, and notes text)
+      and EPS images will be printed on the calendars, so that write_psfile()
+      can omit the PostScript procedures for the others.
+
+      It walks the text for each month just as find_daytext() and
+      find_images() will.  Whole-year calendars print no text.
+
+      It also notes the 8-bit characters in that text (cf. note_used_chars()).
 
 */
-void ps_prtday_bw (void)
+static void find_text_usage (void)
 {
-   printf("%% print 'day' in 'color' (black, gray, outline, or outline-gray; cf. pcaldefs.h)\n");
-   printf("%% using single value in 'dategray' as gray shade\n");
-   printf("%%\n");
-   printf("/prtday {					%% black and white version\n");
-   printf("	gsave\n");
-   printf("	day 3 string cvs			%% convert day to string\n");
-   printf("	[\n");
-   printf("		{ show }				%% black (0)\n");
-   printf("		{ dategray setgray show }		%% gray (1)\n");
-   printf("		{ true charpath stroke }		%% outline (2)\n");
-   printf("		{ true charpath gsave			%% outline-gray (3)\n");
-   printf("		  dategray setgray fill\n");
-   printf("		  grestore stroke }\n");
-   printf("	] color get exec			%% execute operators for color\n");
-   printf("	grestore\n");
-   printf("} bind def\n\n");
+   int i, day, month, year, hol;
+   month_info *pm;
+   day_info *pd;
+   span_info *ps;
+   char *text;
+
+   use_daytext = use_holidaytext = use_notetext = use_images = FALSE;
+   memset(used_chars, FALSE, sizeof(used_chars));
+
+   if (do_whole_year) return;
+
+   for (i = 0, month = init_month, year = init_year;
+        i < nmonths;
+        i++, BUMP_MONTH_AND_YEAR(month, year)) {
+
+      if ((pm = find_month_info(month, year)) == NULL) continue;
+
+      for (day = 1; day <= LAST_NOTE_DAY; day++) {
+         for (pd = NULL, ps = NULL;
+              (text = next_day_text(pm, month, day, year, &pd, &ps, &hol)) != NULL;
+              ) {
+            note_used_chars(text);
+            if (ci_strncmp(text, "image:", 6) == 0) use_images = TRUE;
+            else if (day >= FIRST_NOTE_DAY) use_notetext = TRUE;
+            else if (hol) use_holidaytext = TRUE;
+            else use_daytext = TRUE;
+         }
+      }
+   }
+
    return;
 }
 
@@ -414,6 +1341,7 @@ void ps_prtday_bw (void)
 void write_psfile (void)
 {
    int i, nfonts, nfsize, copies, dfltsize, color_dates, color_fill;
+   int use_text, use_notesfont, use_heading;
    char *p, tmp[STRSIZ], *allfonts[MAXFONT];
    char time_str[50];
    time_t curr_tyme;
@@ -432,13 +1360,21 @@ void write_psfile (void)
    
    debug_text = DEBUG(DEBUG_TEXT);   /* debug text output? */
    
+   /* determine which of the optional PostScript procedures are needed */
+   find_text_usage();
+   use_text = use_daytext || use_holidaytext || use_notetext;
+   use_notesfont = use_text || use_images || julian_dates != NO_JULIANS;
+   use_heading = use_notetext && notes_hdr[0];
+
    /*
     * Write out PostScript prolog (including version/datefile stamp)
     */
    
    /* comment block at top */
    
-   printf("%%!%s\n", PS_RELEASE);   /* PostScript release */
+   /* PostScript release; -Q output requires Level 2, which is declared by a
+      DSC 3.0 comment (below) */
+   out_printf("%%!%s\n", compress_ps ? PS_RELEASE_L2 : PS_RELEASE);
 
    
    /* Get the current date/time so that we can write it into the output file
@@ -454,21 +1390,21 @@ void write_psfile (void)
    strftime(time_str, sizeof(time_str), "%d %b %Y (%a) %I:%M:%S%P", localtime(&curr_tyme));
 #endif
    
-   printf("%%%%CreationDate: %s\n", time_str);
+   out_printf("%%%%CreationDate: %s\n", time_str);
 
-   printf("%%%%Creator: Generated by %s %s (%s)\n", progname, version, PCAL_WEBSITE);
+   out_printf("%%%%Creator: Generated by %s %s (%s)\n", progname, version, PCAL_WEBSITE);
 
    /* Generate "For" and "Routing" comments if user name is known... */
 
 #if defined (BUILD_ENV_UNIX) || defined (BUILD_ENV_DJGPP)
    if ((pw = getpwuid(getuid())) != NULL && strcmp(pw->pw_name, "nobody" /* anonymous account */) != 0) {
-      printf("%%%%For: %s\n", pw->pw_name);
+      out_printf("%%%%For: %s\n", pw->pw_name);
 #ifdef BUILD_ENV_UNIX
       /* The 'pw->pw_gecos' element ('real' user name) is not available in
          MS-DOS or DOS+DJGPP build environments... */
       strcpy(tmp, pw->pw_gecos);
       if ((p = strchr(tmp, ',')) != NULL) *p = '\0';
-      printf("%%%%Routing: %s\n", tmp);
+      out_printf("%%%%Routing: %s\n", tmp);
 #endif
    }
 #endif
@@ -479,33 +1415,37 @@ void write_psfile (void)
    /* Identify the output (month/year range and input file) */
    
    if (do_whole_year && init_month == JAN) {
-      printf("%%%%Title: calendar for %d", init_year);
-      if (final_year > init_year) printf(" - %d", final_year);
+      out_printf("%%%%Title: calendar for %d", init_year);
+      if (final_year > init_year) out_printf(" - %d", final_year);
    } 
    else {
       char c = date_style == EUR_DATES ? '.' : '/';
-      printf("%%%%Title: calendar for %02d%c%02d", init_month, c, init_year);
-      if (nmonths > 1) printf(" - %02d%c%02d", final_month, c, final_year);
+      out_printf("%%%%Title: calendar for %02d%c%02d", init_month, c, init_year);
+      if (nmonths > 1) out_printf(" - %02d%c%02d", final_month, c, final_year);
    }
 
    /* If a configuration file was used, show the file's name... */
-   if (*datefile) printf(" (from %s)", datefile);
+   if (*datefile) out_printf(" (from %s)", datefile);
 
-   printf("\n");
+   OUT_LIT("\n");
 
    /* Miscellaneous other identification */
    
-   printf("%%%%Orientation: %s\n", rotate == LANDSCAPE ? "Landscape" : "Portrait");
-   printf("%%%%Pages: %d\n", do_whole_year ? nmonths / 12 : nmonths);
-   printf("%%%%PageOrder: Ascend\n");
-   printf("%%%%BoundingBox: 0 0 %d %d\n", page_dim_short_axis_pts, page_dim_long_axis_pts);
-   printf("%%%%DocumentPaperSizes: %s\n", paper_info[paper_size].name);
-   printf("%%%%ProofMode: NotifyMe\n");
-   printf("%%%%EndComments\n\n");
+   out_printf("%%%%Orientation: %s\n", rotate == LANDSCAPE ? "Landscape" : "Portrait");
+   out_printf("%%%%Pages: %d\n", do_whole_year ? nmonths / 12 : nmonths);
+   OUT_LIT("%%PageOrder: Ascend\n");
+   out_printf("%%%%BoundingBox: 0 0 %d %d\n", page_dim_short_axis_pts, page_dim_long_axis_pts);
+   out_printf("%%%%DocumentPaperSizes: %s\n", paper_info[paper_size].name);
+   OUT_LIT("%%ProofMode: NotifyMe\n");
+   if (compress_ps) OUT_LIT("%%LanguageLevel: 2\n");
+   OUT_LIT("%%EndComments\n\n");
+
+   /* -Q: compress the prolog (i.e. everything up to the first page) */
+   if (compress_ps) out_compress_begin();
    
    /* number of copies (from -#<n> flag) */
    if ((copies = ncopy) > MAXCOPY) copies = MAXCOPY;
-   if (copies > 1) printf("/#copies %d def\n", copies);
+   if (copies > 1) out_printf("/#copies %d def\n", copies);
    
    /* paper size (force appropriate tray if known) */
 
@@ -520,7 +1460,7 @@ void write_psfile (void)
 #if 1
    strcpy(tmp, paper_info[paper_size].name);
    tmp[0] = tolower(tmp[0]);
-   printf("statusdict /%stray known { statusdict begin %stray end } if\n", tmp, tmp);
+   out_printf("statusdict /%stray known { statusdict begin %stray end } if\n", tmp, tmp);
 #endif
 
    /* calendar sizes: to minimize number of pre-scaled fonts, whole- year
@@ -530,7 +1470,7 @@ void write_psfile (void)
     */
    
    for (i = SMALL; i <= LARGE; i++) {
-      printf("/%s %d def\n", calsize[i], do_whole_year ? (i == MEDIUM ? 0 : -1) :
+      out_printf("/%s %d def\n", calsize[i], do_whole_year ? (i == MEDIUM ? 0 : -1) :
              (i == MEDIUM ? -1 : i == SMALL));
    }
    
@@ -553,99 +1493,59 @@ void write_psfile (void)
 
    if (mapfonts != ENC_NONE) {
 
-      /* include desired mapping */
-      
-      switch (mapfonts) {
-
-      case ENC_LATIN_1: encvec_iso8859_1(); break;
-      case ENC_LATIN_2: encvec_iso8859_2(); break;
-      case ENC_LATIN_3: encvec_iso8859_3(); break;
-      case ENC_LATIN_4: encvec_iso8859_4(); break;
-      case ENC_CYRILLIC: encvec_iso8859_5(); break;
-      case ENC_ARABIC: encvec_iso8859_6(); break;
-      case ENC_GREEK: encvec_iso8859_7(); break;
-      case ENC_HEBREW: encvec_iso8859_8(); break;
-      case ENC_LATIN_5: encvec_iso8859_9(); break;
-      case ENC_LATIN_6: encvec_iso8859_10(); break;
-      case ENC_THAI: encvec_iso8859_11(); break;
-      case ENC_LATIN_7: encvec_iso8859_13(); break;
-      case ENC_LATIN_8: encvec_iso8859_14(); break;
-      case ENC_LATIN_9: encvec_iso8859_15(); break;
-      case ENC_LATIN_10: encvec_iso8859_16(); break;
-      case ENC_KOI8_R: encvec_koi8_r(); break;
-      case ENC_KOI8_U: encvec_koi8_u(); break;
-      case ENC_ROMAN8: encvec_roman8(); break;
-         
-      default: 
+      /* flag the characters in the month and day names, footer strings,
+         and ordinal suffixes (event text was already noted by
+         find_text_usage()) */
+
+      for (i = 0; i < 12; i++) note_used_chars(months_ml[output_language][i]);
+      for (i = 0; i < 7; i++) {
+         note_used_chars(days_ml[output_language][i]);
+         note_used_chars(days_ml_short[output_language][i]);
+      }
+      note_used_chars(lfoot);
+      note_used_chars(cfoot);
+      note_used_chars(rfoot);
+      note_used_chars(notes_hdr);
+      for (i = 0; ord_suffix[i]; i++) note_used_chars(ord_suffix[i]);
+
+      /* include desired mapping, limited to those characters */
+
+      if (!print_encvec(mapfonts, used_chars)) {
          fprintf(stderr, "Unknown language encoding (%d) encountered!\n", mapfonts); 
-         break;
       }
       
       /* Boilerplate PostScript code to remap for 8-bit fonts... */
 
-      printf("/alt_dict 20 dict def			%% Local storage\n");
-      printf("\n");
-      printf("%% <oldfont> <newfont> remap_font => --\n");
-      printf("%%\n");
-      printf("%% create remapped font using one of the above 8-bit character remapping tables\n");
-      printf("%%\n");
-      printf("/remap_font {\n");
-      printf("	alt_dict begin\n");
-      printf("		/newName exch def\n");
-      printf("		/oldName exch def\n");
-      printf("		/oldDict oldName findfont def\n");
-      printf("		/newDict oldDict maxlength dict def\n");
-      printf("		oldDict {\n");
-      printf("			exch dup /FID ne {\n");
-      printf("				dup /Encoding eq {\n");
-      printf("					exch dup length array copy\n");
-      printf("					newDict 3 1 roll put\n");
-      printf("				} {\n");
-      printf("					exch newDict 3 1 roll put\n");
-      printf("				} ifelse\n");
-      printf("			} {\n");
-      printf("				pop pop\n");
-      printf("			} ifelse\n");
-      printf("		} forall\n");
-      printf("		newDict /FontName newName put\n");
-      printf("		0 2 alt_mappings length 1 sub {\n");
-      printf("			dup\n");
-      printf("			alt_mappings exch get\n");
-      printf("			exch 1 add alt_mappings exch get\n");
-      printf("			newDict /Encoding get 3 1 roll put\n");
-      printf("		} for\n");
-      printf("		newName newDict definefont pop\n");
-      printf("	end\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_remap_font);
 
       /* always generate code to remap title font */
-      printf("/%s /%s%s remap_font\n", titlefont, titlefont, NEWFONT);
+      out_printf("/%s /%s%s remap_font\n", titlefont, titlefont, NEWFONT);
       strcat(titlefont, NEWFONT);
       
 #if MAP_DATEFONT   /* any text printed in date font (cf. pcaldefs.h)? */
       /* generate code to remap date font if necessary */
-      printf("FontDirectory /%s%s known not {\n", datefont, NEWFONT);
-      printf("/%s /%s%s remap_font\n", datefont, datefont, NEWFONT);
-      printf("} if\n");
+      out_printf("FontDirectory /%s%s known not {\n", datefont, NEWFONT);
+      out_printf("/%s /%s%s remap_font\n", datefont, datefont, NEWFONT);
+      OUT_LIT("} if\n");
       strcat(datefont, NEWFONT);
 #endif
 
       /* generate code to remap notes font if necessary */
-      printf("FontDirectory /%s%s known not {\n", notesfont, NEWFONT);
-      printf("/%s /%s%s remap_font\n", notesfont, notesfont, NEWFONT);
-      printf("} if\n");
+      out_printf("FontDirectory /%s%s known not {\n", notesfont, NEWFONT);
+      out_printf("/%s /%s%s remap_font\n", notesfont, notesfont, NEWFONT);
+      OUT_LIT("} if\n");
       strcat(notesfont, NEWFONT);
    }
    
    /* define title, notes, and date fonts */
-   printf("/titlefont /%s def\n", titlefont);
-   printf("/datefont /%s def\n", datefont);
-   printf("/notesfont /%s def\n", notesfont);
+   out_printf("/titlefont /%s def\n", titlefont);
+   out_printf("/datefont /%s def\n", datefont);
+   out_printf("/notesfont /%s def\n", notesfont);
         
    /* typically defined in terms of above fonts - must define last */
-   printf("/weekdayfont %s def\n", WEEKDAYFONT);
-   printf("/footfont %s def\n", FOOTFONT);
-   printf("/headingfont %s def\n", HEADINGFONT);
+   out_printf("/weekdayfont %s def\n", WEEKDAYFONT);
+   out_printf("/footfont %s def\n", FOOTFONT);
+   out_printf("/headingfont %s def\n", HEADINGFONT);
    
    /* print various font sizes and line/margin widths as PostScript arrays:
       one element for whole-year calendars; two (large, small) for single-
@@ -653,84 +1553,91 @@ void write_psfile (void)
    */
 
    if (do_whole_year) {
-      printf("/datemargin [ %d ] def\n", dmargin[MEDIUM]);
-      printf("/gridlinewidth [ %.1f ] def\n", gwidth[MEDIUM]);
-      printf("/titlefontsize [ %d ] def\n", tsize[MEDIUM]);
-      printf("/datefontsize [ %d ] def\n", dsize[MEDIUM]);
+      out_printf("/datemargin [ %d ] def\n", dmargin[MEDIUM]);
+      out_printf("/gridlinewidth [ %.1f ] def\n", gwidth[MEDIUM]);
+      out_printf("/titlefontsize [ %d ] def\n", tsize[MEDIUM]);
+      out_printf("/datefontsize [ %d ] def\n", dsize[MEDIUM]);
    } else {
-      printf("/datemargin [ %d %d ] def\n", dmargin[LARGE], dmargin[SMALL]);
-      printf("/gridlinewidth [ %.1f %.1f ] def\n", gwidth[LARGE], gwidth[SMALL]);
-      printf("/titlefontsize [ %d %d ] def\n", tsize[LARGE], tsize[SMALL]);
-      printf("/datefontsize [ %d %d ] def\n", dsize[LARGE], dsize[SMALL]);
+      out_printf("/datemargin [ %d %d ] def\n", dmargin[LARGE], dmargin[SMALL]);
+      out_printf("/gridlinewidth [ %.1f %.1f ] def\n", gwidth[LARGE], gwidth[SMALL]);
+      out_printf("/titlefontsize [ %d %d ] def\n", tsize[LARGE], tsize[SMALL]);
+      out_printf("/datefontsize [ %d %d ] def\n", dsize[LARGE], dsize[SMALL]);
    }
    
    dfltsize = do_whole_year ? MEDIUM : LARGE;
    
-   printf("/weekdayfontsize %d def\n", wsize[dfltsize]);
-   printf("/footfontsize %d def\n", fsize[dfltsize]);
+   out_printf("/weekdayfontsize %d def\n", wsize[dfltsize]);
+   out_printf("/footfontsize %d def\n", fsize[dfltsize]);
 
    /* Now that we allow Julian dates to be displayed on yearly-format
       calendars, we must tweak the font size of the 'notes font' accordingly,
       since that font is also used to display the Julian dates (if enabled by
       the user)...
    */ 
-   printf("/notesfontsize %d def\n", do_whole_year ? 24 : nfsize);
+   out_printf("/notesfontsize %d def\n", do_whole_year ? 24 : nfsize);
 
-   printf("/headingfontsize %d def\n", HEADINGFONTSIZE);
+   out_printf("/headingfontsize %d def\n", HEADINGFONTSIZE);
    
    /* pre-scale all fonts used by PostScript code; try to be smart about
       skipping those that we know (at this point) won't be needed (whole-year
       calendars use either 3 or 4 fonts, while single-month calendars can use
       anywhere from 3 to 8).  "FF" et. al. are indices into the font array (cf
-      pcalinit.ps) for the different font types.
+      pcalinit.ps) for the different font types.  Fonts for footers, the notes
+      heading, and text (or Julian dates) are omitted if not used.
    */
 
-   printf("/FontFind { findfont exch scalefont } def\n");
+   OUT_LIT("/FontFind { findfont exch scalefont } def\n");
 
    nfonts = 0;
 
-   printf("/FF %d def\n", nfonts);   /* footers */
-   if (FOOTSTRINGS()) ADDFONT("ff", calsize[dfltsize], "foot", FALSE);
+   if (FOOTSTRINGS()) {
+      out_printf("/FF %d def\n", nfonts);   /* footers */
+      ADDFONT("ff", calsize[dfltsize], "foot", FALSE);
+   }
 
    if (do_whole_year) {
-      printf("/TF %d def\n", nfonts);   /* month/year title */
+      out_printf("/TF %d def\n", nfonts);   /* month/year title */
       ADDFONT("tf", calsize[MEDIUM], "title", TRUE);
       
-      printf("/DF %d def\n", nfonts);   /* dates */
+      out_printf("/DF %d def\n", nfonts);   /* dates */
       ADDFONT("df", calsize[MEDIUM], "date", TRUE);
    } 
    else {
-      printf("/HF %d def\n", nfonts);   /* 'Notes' heading */
-      if (notes_hdr[0]) ADDFONT("hf", calsize[LARGE], "heading", FALSE);
+      if (use_heading) {
+         out_printf("/HF %d def\n", nfonts);   /* 'Notes' heading */
+         ADDFONT("hf", calsize[LARGE], "heading", FALSE);
+      }
 
       /* large/small (if used) scalings of the same font must be
        * contiguous and appear in that order
        */
       
-      printf("/TF %d def\n", nfonts);   /* large/small title */
+      out_printf("/TF %d def\n", nfonts);   /* large/small title */
       ADDFONT("tf", calsize[LARGE], "title", TRUE);
       if (small_cal_pos != SC_NONE) ADDFONT("tf", calsize[SMALL], "title", TRUE);
 
-      printf("/DF %d def\n", nfonts);   /* large/small dates */
+      out_printf("/DF %d def\n", nfonts);   /* large/small dates */
       ADDFONT("df", calsize[LARGE], "date", TRUE);
       if (small_cal_pos != SC_NONE) ADDFONT("df", calsize[SMALL], "date", TRUE);
    }
 
-   printf("/NF %d def\n", nfonts);   /* text for note-boxes and/or Julian dates */
-   ADDFONT("nf", calsize[LARGE], "notes", FALSE);
+   if (use_notesfont) {
+      out_printf("/NF %d def\n", nfonts);   /* text for note-boxes and/or Julian dates */
+      ADDFONT("nf", calsize[LARGE], "notes", FALSE);
+   }
 
 
-   printf("/WF %d def\n", nfonts);   /* weekdays */
+   out_printf("/WF %d def\n", nfonts);   /* weekdays */
    ADDFONT("wf", calsize[dfltsize], "weekday", FALSE);
    
    /* generate the font array (automatically in sync with above) */
    
-   printf("/allfonts [\n\t");
+   OUT_LIT("/allfonts [\n\t");
    for (i = 0; i < nfonts; i++) {
-      printf("%s ", allfonts[i]);
+      out_printf("%s ", allfonts[i]);
       free(allfonts[i]);
    }
-   printf("\n] def\n");
+   OUT_LIT("\n] def\n");
    
    /*
       Define various strings and numeric values used by Pcal
@@ -738,18 +1645,18 @@ void write_psfile (void)
    
    /* month names */
 
-   printf("/month_names [");
+   OUT_LIT("/month_names [");
    for (i = JAN; i <= DEC; i++) {
-      printf(i % 6 == 1 ? "\n\t" : " ");
+      out_printf(i % 6 == 1 ? "\n\t" : " ");
       (void) print_word(months_ml[output_language][i-1]);
    }
-   printf(" ] def\n");
+   OUT_LIT(" ] def\n");
    
    /* day names - abbreviate if printing entire year on page */
    
-   printf("/day_names [");
+   OUT_LIT("/day_names [");
    for (i = SUN; i <= SAT; i++) {
-      printf((i % 6 == 0 && !do_whole_year) ? "\n\t" : " ");
+      out_printf((i % 6 == 0 && !do_whole_year) ? "\n\t" : " ");
       if (do_whole_year) {
          strcpy(tmp, days_ml_short[output_language][(i + first_day_of_week) % 7]);
       }
@@ -758,7 +1665,7 @@ void write_psfile (void)
       }
       (void) print_word(tmp);
    }
-   printf(" ] def\n");
+   OUT_LIT(" ] def\n");
    
    /* line separator and font change strings */
    
@@ -769,316 +1676,87 @@ void write_psfile (void)
    
    /* page width and height (always referenced to 'portrait' mode) */
    
-   printf("/pagewidth %d def\n", page_dim_short_axis_pts);
-   printf("/pageheight %d def\n", page_dim_long_axis_pts);
+   out_printf("/pagewidth %d def\n", page_dim_short_axis_pts);
+   out_printf("/pageheight %d def\n", page_dim_long_axis_pts);
    
    /* rotation, scaling, and translation factors */
    
-   printf("/rval %d def\n", rotate);
-   printf("/xsval %.3f def\n/ysval %.3f def\n", xsval_pgm * xsval_user, ysval_pgm * ysval_user);
-   printf("/xtval %d def\n/ytval %d def\n", xtval_pgm + xtval_user, ytval_pgm + ytval_user);
-   printf("/ytop %d def\n", -TOP_OF_CAL_BOXES_PTS);
+   out_printf("/rval %d def\n", rotate);
+   out_printf("/xsval %.3f def\n/ysval %.3f def\n", xsval_pgm * xsval_user, ysval_pgm * ysval_user);
+   out_printf("/xtval %d def\n/ytval %d def\n", xtval_pgm + xtval_user, ytval_pgm + ytval_user);
+   out_printf("/ytop %d def\n", -TOP_OF_CAL_BOXES_PTS);
    
    /* date box dimensions */
    
-   printf("/daywidth %d def\n", daybox_width_pts);
-   printf("/dayheight %d def\n", daybox_height_pts);
+   out_printf("/daywidth %d def\n", daybox_width_pts);
+   out_printf("/dayheight %d def\n", daybox_height_pts);
    
    /* moon, Julian date, and box fill flags */
    
-   printf("/draw-moons %s def\n", cond[draw_moons]);
-   printf("/julian-dates %s def\n", cond[julian_dates]);
-   printf("/fill-boxes %s def\n", cond[! blank_boxes]);
+   out_printf("/draw-moons %s def\n", cond[draw_moons]);
+   out_printf("/julian-dates %s def\n", cond[julian_dates]);
+   out_printf("/fill-boxes %s def\n", cond[! blank_boxes]);
    
    /* position of small calendars */
    
-   printf("/prev_small_cal %d def\n", prev_cal_box[small_cal_pos]);
-   printf("/next_small_cal %d def\n", next_cal_box[small_cal_pos]);
+   out_printf("/prev_small_cal %d def\n", prev_cal_box[small_cal_pos]);
+   out_printf("/next_small_cal %d def\n", next_cal_box[small_cal_pos]);
    
    /* date and fill box shading values */
    
    strcpy(tmp, shading);
    *(p = strchr(tmp, '/')) = '\0';
-   printf("/dategray %s def\n", set_rgb(tmp));
+   out_printf("/dategray %s def\n", set_rgb(tmp));
    color_dates = strchr(tmp, RGB_CHAR) != NULL;
-   printf("/fillgray %s def\n", set_rgb(++p));
+   out_printf("/fillgray %s def\n", set_rgb(++p));
    color_fill = strchr(p, RGB_CHAR) != NULL;
    
-   /* PostScript boilerplate (part 1 of 1) */
-
-   printf("/Y0 0 def				%% Y-coordinate of calendar grid origin\n");
-   printf("\n");
-   printf("/gridwidth daywidth 7 mul def\n");
-   printf("/gridheight dayheight 6 mul def\n");
-   printf("/negdaywidth daywidth neg def\n");
-   printf("/negdayheight dayheight neg def\n");
-   printf("/neggridwidth gridwidth neg def\n");
-   printf("/neggridheight gridheight neg def\n");
-   printf("\n");
-   printf("/textmargin 2 def			%% left/right margin for text\n");
-   printf("/notemargin 4 def			%% left/right margin for notes\n");
-   printf("/charlinewidth 0.1 def			%% width of outline characters\n");
-   printf("\n");
-   printf("/datewidth 2 array def			%% for aligning holiday text\n");
-   printf("\n");
-   printf("/moonlinewidth 0.1 def			%% width of moon icon line\n");
+   /* PostScript boilerplate: only the procedures (and definitions) which
+      this calendar will actually use are included */
 
-   /*
+   OUT_LIT(ps_grid_defs);
 
-     Moon icon radius is actually larger (due to scaling, I suppose) for a
-     yearly-format calendar...
+   if (draw_moons != NO_MOONS) {
+      OUT_LIT("/moonlinewidth 0.1 def			% width of moon icon line\n");
+
+      /*
+
+        Moon icon radius is actually larger (due to scaling, I suppose) for a
+        yearly-format calendar...
    
-   */ 
-   printf("/radius %d def				%% radius of moon icon\n", do_whole_year ? 12 : 6);
-
-   printf("/halfperiod 0.5 def			%% scale factors, etc. used by 'domoon'\n");
-   printf("/quartperiod 0.25 def\n");
-   printf("/offset radius datemargin 0 get add def\n");
-   printf("/rect radius 2 sqrt mul quartperiod div def\n");
-   printf("\n");
-   printf("/ROMAN 0 def				%% font types for text in boxes\n");
-   printf("/BOLD 1 def\n");
-   printf("/ITALIC 2 def\n");
-   printf("/currfonttype ROMAN def\n");
-   printf("/boldoffset 0.5 def			%% offset for overstriking bold text\n");
-   printf("\n");
-   printf("%% simulate Italic text by slanting Roman text - note that this is properly\n");
-   printf("%% called 'Oblique'\n");
-   printf("\n");
-   printf("/italicangle 12 def			%% angle for slanting Italic text\n");
-   printf("/italicmatrix				%% Italic font matrix\n");
-   printf(" [notesfontsize 0 notesfontsize italicangle dup sin exch cos div mul\n");
-   printf(" notesfontsize 0 0] def\n");
-   printf("\n");
-   printf("/hangingindent (   ) def		%% for indenting continued text lines\n");
-   printf("\n");
-   printf("%% disable duplex mode (if supported)\n");
-   printf("statusdict (duplexmode) known { statusdict begin false setduplexmode end } if\n");
-   printf("\n");
-   printf("%%\n");
-   printf("%% Utility functions:\n");
-   printf("%%\n");
-   printf("\n");
-   printf("%% <fontposition> FontSet => --\n");
-   printf("%%\n");
-   printf("%% set current font to element <fontposition> of 'allfonts' array\n");
-   printf("%%\n");
-   printf("/FontSet {\n");
-   printf("	allfonts exch\n");
-   printf("	userdict /CurrentFontSet 2 index put\n");
-   printf("	get setfont\n");
-   printf("} bind def\n\n");
-
-   printf("%% <size> *FontSet => --\n");
-   printf("%%\n");
-   printf("%% fetch pre-scaled font (of desired calendar size) from 'allfonts' array\n");
-   printf("%%\n");
-   printf("/TitleFontSet {TF add FontSet} bind def\n");
-   printf("\n");
-   printf("/DateFontSet {DF add FontSet} bind def\n");
-   printf("\n");
-   printf("%% -- *FontSet => --\n");
-   printf("%%\n");
-   printf("%% fetch pre-scaled font (of constant size) from 'allfonts' array\n");
-   printf("%%\n");
-   printf("/WeekdayFontSet {WF FontSet} bind def\n");
-   printf("\n");
-   printf("/FootFontSet {FF FontSet} bind def\n");
-   printf("\n");
-   printf("/NotesFontSet {NF FontSet /currfonttype ROMAN def} bind def\n");
-   printf("\n");
-   printf("/HeadingFontSet {HF FontSet} bind def\n");
-   printf("\n");
-   printf("%% <string> <width> center => --\n");
-   printf("%%\n");
-   printf("%% display <string> centered horizontally in <width>\n");
-   printf("%%\n");
-   printf("/center {\n");
-   printf("	1 index stringwidth pop sub 2 div 0 rmoveto show\n");
-   printf("} bind def\n\n");
-
-   /* These 2 routines ('left' and 'right') were added to support the '-W'
-      option (horizontal alignment of title on monthly-format calendar).
-   */ 
-   printf("%% <string> <width> left => --\n");
-   printf("%%\n");
-   printf("%% display <string> justified left in <width>\n");
-   printf("%%\n");
-   printf("/left {\n");
-   printf("   1 index show\n");
-   printf("} bind def\n\n");
-   printf("%% <string> <width> right => --\n");
-   printf("%%\n");
-   printf("%% display <string> justified right in <width>\n");
-   printf("%%\n");
-   printf("/right {\n");
-   printf("   1 index stringwidth pop sub 0 rmoveto show\n");
-   printf("} bind def\n\n");
-
-   printf("%% <str1> <str2> strcat => <string>\n");
-   printf("%%\n");
-   printf("%% concatenate <str1> and <str2>; push result onto stack\n");
-   printf("%%\n");
-   printf("/strcat {\n");
-   printf("	2 copy\n");
-   printf("	length exch length\n");
-   printf("	dup 3 -1 roll add\n");
-   printf("	string\n");
-   printf("	dup 0 6 -1 roll putinterval\n");
-   printf("	dup 3 -1 roll 4 -1 roll putinterval\n");
-   printf("} bind def\n\n");
-
-
-   printf("%% -- nextbox => --\n");
-   printf("%%\n");
-   printf("%% move to same relative position within following day's box\n");
-   printf("%%\n");
-   printf("/nextbox {\n");
-   printf("	day startbox add 7 mod 0 eq			%% end of week?\n");
-   printf("		{ neggridwidth daywidth add negdayheight rmoveto }  %% next row\n");
-   printf("		{ daywidth 0 rmoveto }				    %% next col\n");
-   printf("	ifelse\n");
-   printf("} bind def\n\n");
-
-   printf("%% <box> boxpos => <x> <y>\n");
-   printf("%%\n");
-   printf("%% calculate and push coordinates of upper-left corner of <box> (0..41)\n");
-   printf("%%\n");
-   printf("/boxpos {\n");
-   printf("	dup 7 mod daywidth mul					%% x-coord\n");
-   printf("	exch 7 idiv negdayheight mul Y0 add			%% y-coord\n");
-   printf("} bind def\n\n");
-
-   printf("%% <day> datepos => <x> <y>\n");
-   printf("%%\n");
-   printf("%% calculate and push coordinates of upper-left corner of box for <day>\n");
-   printf("%%\n");
-   printf("/datepos {\n");
-   printf("	startbox add 1 sub dup 7 mod daywidth mul		%% x-coord\n");
-   printf("	exch 7 idiv negdayheight mul Y0 add			%% y-coord\n");
-   printf("} bind def\n\n");
-
-   printf("%%\n");
-   printf("%% Functions for drawing components of calendar:\n");
-   printf("%%\n");
-   printf("%% The point size of a PostScript font includes the descenders on [gjpqy],\n");
-   printf("%% but the Y-origin for printing text starts above any descenders (at the\n");
-   printf("%% bottom of the upper-case characters).  The following code - and other\n");
-   printf("%% code concerned with vertical spacing - assumes that the descenders\n");
-   printf("%% occupy 1/4 of the overall point size.\n\n");
-
-   printf("%% -- drawtitle => --\n");
-   printf("%%\n");
-   printf("%% print month/year title centered at top of calendar\n");
-   printf("%%\n");
-   printf("/drawtitle {\n");
-   printf("	/fontsize titlefontsize calsize get def\n");
-   printf("	calsize TitleFontSet\n");
-   printf("	/month_name month_names month 1 sub get def\n");
-   printf("	/yearstring year 10 string cvs def\n");
-   printf("	0 Y0 fontsize 0.25 mul add\n");
-   printf("	  calsize small eq { 4 } { weekdayfontsize } ifelse\n");
-   printf("	  1.15 mul add moveto\n");
-   printf("   month_name (  ) strcat yearstring strcat gridwidth %s\n", title_align);
-   printf("} bind def\n\n");
-
-   printf("%% -- drawdaynames => --\n");
-   printf("%%\n");
-   printf("%% print weekday names centered above respective columns\n");
-   printf("%%\n");
-   printf("/drawdaynames {	\n");
-   printf("	WeekdayFontSet\n");
-   printf("	0 1 6 {\n");
-   printf("		/i exch def\n");
-   printf("		i daywidth mul Y0 weekdayfontsize 0.4 mul add moveto\n");
-   printf("		day_names i get\n");
-   printf("		daywidth center\n");
-   printf("	} for\n");
-   printf("} bind def\n\n");
-
-   printf("%% -- drawgrid => --\n");
-   printf("%%\n");
-   printf("%% draw the grid (6 rows x 7 columns) for the calendar\n");
-   printf("%%\n");
-   printf("/drawgrid {\n");
-   printf("	gridlinewidth calsize get setlinewidth\n");
-   printf("\n");
-   printf("	1 1 6 {					%% inner vertical lines\n");
-   printf("		daywidth mul Y0 moveto\n");
-   printf("		0 neggridheight rlineto\n");
-   printf("		stroke\n");
-   printf("	} for\n");
-   printf("\n");
-   printf("	1 1 5 {					%% inner horizontal lines\n");
-   printf("		0 exch negdayheight mul Y0 add moveto\n");
-   printf("		gridwidth 0 rlineto\n");
-   printf("		stroke\n");
-   printf("	} for\n");
-   printf("\n");
-   printf("	newpath					%% border (w/mitered corners)\n");
-   printf("	0 Y0 moveto\n");
-   printf("	gridwidth 0 rlineto\n");
-   printf("	0 neggridheight rlineto\n");
-   printf("	neggridwidth 0 rlineto\n");
-   printf("	closepath\n");
-   printf("	stroke\n");
-   printf("} bind def\n\n");
-
-   printf("%% -- drawnums => --\n");
-   printf("%%\n");
-   printf("%% print dates in appropriate boxes of calendar\n");
-   printf("%%\n");
-   printf("/drawnums {\n");
-   printf("	/fontsize datefontsize calsize get def\n");
-   printf("	/margin datemargin calsize get def\n");
-   printf("	calsize DateFontSet\n");
-   printf("	charlinewidth setlinewidth\n");
-   printf("	1 datepos fontsize 0.75 mul margin add sub exch margin add exch moveto\n");
-   printf("\n");
-   printf("	%% calculate date widths for 'holidaytext' to use; use '2' for all\n");
-   printf("	%% single-digit dates and '22' for all double-digit dates\n");
-   printf("	calsize large eq {\n");
-   printf("		datewidth 0 (2) stringwidth pop margin 2 mul add put\n");
-   printf("		datewidth 1 (22) stringwidth pop margin 2 mul add put\n");
-   printf("	} if\n");
-   printf("\n");
-   printf("	calsize small eq {\n");
-   printf("		/color 0 def		%% small calendar dates (all black)\n");
-   printf("		1 1 ndays {\n");
-   printf("			/day exch def\n");
-   printf("			prtday\n");
-   printf("			nextbox\n");
-   printf("		} for\n");
-   printf("	} {\n");
-   printf("		1 1 ndays {		%% medium/large calendar dates\n");
-   printf("			/day exch def\n");
-   printf("			/color date_color day get def\n");
-   printf("			prtday\n");
-   printf("			nextbox\n");
-   printf("		} for\n");
-   printf("	} ifelse\n");
-   printf("} bind def\n\n");
-
-   printf("%% -- startpage => --\n");
-   printf("%%\n");
-   printf("%% initialize new physical page\n");
-   printf("%%\n");
-   printf("/startpage {\n");
-   printf("	rval rotate\n");
-   printf("	xsval ysval scale\n");
-   printf("	xtval ytval translate\n");
-   printf("} bind def\n\n");
-
-   printf("%% -- calendar => --\n");
-   printf("%%\n");
-   printf("%% draw calendar for 'month'/'year', with various features enabled/disabled\n");
-   printf("%% according to 'calsize'\n");
-   printf("%%\n");
-   printf("/calendar {\n");
-   printf("	drawtitle					%% month/year\n");
-   printf("	calsize small ne { drawdaynames } if		%% weekday names\n");
-   printf("	calsize large eq { footstrings } if		%% footer strings\n");
-   printf("	drawnums					%% dates\n");
+      */ 
+      out_printf("/radius %d def				%% radius of moon icon\n", do_whole_year ? 12 : 6);
+      OUT_LIT(ps_moon_defs);
+   }
+
+   if (use_notesfont) OUT_LIT(ps_text_defs);
+   OUT_LIT(ps_duplex);
+   OUT_LIT(ps_fontset);
+   OUT_LIT(ps_fontset_sizes);
+   if (FOOTSTRINGS()) OUT_LIT("/FootFontSet {FF FontSet} bind def\n\n");
+   if (use_notesfont) OUT_LIT("/NotesFontSet {NF FontSet /currfonttype ROMAN def} bind def\n\n");
+   if (use_heading) OUT_LIT("/HeadingFontSet {HF FontSet} bind def\n\n");
+   OUT_LIT(ps_center);
+
+   if (strcmp(title_align, "left") == 0) OUT_LIT(ps_left);
+   if (strcmp(title_align, "right") == 0) OUT_LIT(ps_right);
+   OUT_LIT(ps_strcat);
+   OUT_LIT(ps_nextbox);
+   if (!blank_boxes || use_notetext || (!do_whole_year && small_cal_pos != SC_NONE)) {
+      OUT_LIT(ps_boxpos);
+   }
+   OUT_LIT(ps_datepos);
+   OUT_LIT(ps_drawtitle);
+   out_printf("   month_name (  ) strcat yearstring strcat gridwidth %s\n", title_align);
+   OUT_LIT("} bind def\n\n");
+
+   OUT_LIT(ps_drawdaynames);
+   OUT_LIT(ps_drawgrid);
+   OUT_LIT(ps_drawnums);
+   OUT_LIT(ps_startpage);
+   OUT_LIT(ps_calendar);
+   if (FOOTSTRINGS()) OUT_LIT("	calsize large eq { footstrings } if		% footer strings\n");
+   OUT_LIT("	drawnums					% dates\n");
 
    /*
 
@@ -1086,16 +1764,19 @@ void write_psfile (void)
      that Julian dates get drawn when enabled by user...
 
    */
-   if (do_whole_year) {
-      printf("	julian-dates false ne { drawjnums } if		%% Julian dates\n");
+   if (julian_dates == NO_JULIANS) {
+      /* no Julian dates */
+   }
+   else if (do_whole_year) {
+      OUT_LIT("	julian-dates false ne { drawjnums } if		% Julian dates\n");
    }
    else {
-      printf("	calsize large eq				%% Julian dates\n");
-      printf("	  julian-dates false ne and { drawjnums } if\n");
+      OUT_LIT("	calsize large eq				% Julian dates\n");
+      OUT_LIT("	  julian-dates false ne and { drawjnums } if\n");
    }
 
-   printf("	fill-boxes { drawfill } if			%% fill boxes\n");
-   printf("	drawgrid					%% grid\n");
+   if (!blank_boxes) OUT_LIT("	fill-boxes { drawfill } if			% fill boxes\n");
+   OUT_LIT("	drawgrid					% grid\n");
 
    /*
 
@@ -1103,600 +1784,110 @@ void write_psfile (void)
      that moon icons get drawn when enabled by user...
 
    */
-   if (do_whole_year) {
-      printf("	draw-moons false ne { drawmoons } if		%% moon icons\n");
+   if (draw_moons == NO_MOONS) {
+      /* no moons */
+   }
+   else if (do_whole_year) {
+      OUT_LIT("	draw-moons false ne { drawmoons } if		% moon icons\n");
    }
    else {
-      printf("	calsize large eq				%% moon icons\n");
-      printf("	  draw-moons false ne and { drawmoons } if   \n");
+      OUT_LIT("	calsize large eq				% moon icons\n");
+      OUT_LIT("	  draw-moons false ne and { drawmoons } if   \n");
    }
 
-   printf("	0 0 moveto\n");
-   printf("} bind def\n\n");
+   OUT_LIT("	0 0 moveto\n");
+   OUT_LIT("} bind def\n\n");
 
 
    /* Additional PostScript code tailored to this calendar */
 
-#ifdef OUTLINE_BLACK
-   /* if OUTLINE_BLACK is defined, include an alternate prtday{} which prints
-      outlined dates (-O) in black instead of the specified color; otherwise
-      use the standard prtday{}
-   */
-
-   if (color_dates) {
-      printf("%% print 'day' in 'color' (black, gray, outline, or outline-gray; cf. pcaldefs.h)\n");
-      printf("%% using three values in 'dategray' as red/green/blue levels; 'gray' will\n");
-      printf("%% print as solid color, 'outline' as black outline; 'outline-gray' as black\n");
-      printf("%% outline filled with color\n");
-      printf("%%\n");
-      printf("/prtday {					%% color version\n");
-      printf("	gsave\n");
-      printf("	day 3 string cvs			%% convert day to string\n");
-      printf("	[\n");
-      printf("		{ show }				%% black (0)\n");
-      printf("		{ dategray aload pop setrgbcolor show }	%% gray (1)\n");
-      printf("		{ true charpath stroke }		%% outline (2; black)\n");
-      printf("		{ true charpath gsave			%% outline-gray (3)\n");
-      printf("		  dategray aload pop setrgbcolor\n");
-      printf("		  fill grestore stroke }\n");
-      printf("	] color get exec			%% execute operators for color\n");
-      printf("	grestore\n");
-      printf("} bind def\n\n");
-   }
-   else {
-      ps_prtday_bw();
-   }
-   
-#else
-
    if (color_dates) {
-      printf("%% print 'day' in 'color' (black, gray, outline, or outline-gray; cf. pcaldefs.h)\n");
-      printf("%% using three values in 'dategray' as red/green/blue levels; 'gray' will\n");
-      printf("%% print as solid color, 'outline' as color outline; 'outline-gray' as black\n");
-      printf("%% outline filled with color\n");
-      printf("%%\n");
-      printf("/prtday {					%% color version\n");
-      printf("	gsave\n");
-      printf("	day 3 string cvs			%% convert day to string\n");
-      printf("	[\n");
-      printf("		{ show }				%% black (0)\n");
-      printf("		{ dategray aload pop setrgbcolor show }	%% gray (1)\n");
-      printf("		{ dategray aload pop setrgbcolor	%% outline (2; color)\n");
-      printf("		  true charpath stroke }\n");
-      printf("		{ true charpath gsave			%% outline-gray (3)\n");
-      printf("		  dategray aload pop setrgbcolor\n");
-      printf("		  fill grestore stroke }\n");
-      printf("	] color get exec			%% execute operators for color\n");
-      printf("	grestore\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_prtday_color);
    }
    else {
-      ps_prtday_bw();
+      OUT_LIT(ps_prtday_gray);
    }
-   
-#endif
-
-   /*
-      pcal will generate the appropriate flavor (B&W or color) of setfill{}
-      depending on the shading values (gray scale or RGB triple) specified by
-      the "-s" flag
-   */
-   if (color_fill) {
-      printf("%% set fill box color using three values in 'fillgray' as red/green/blue levels\n");
-      printf("%%\n");
-      printf("/setfill {					%% color version\n");
-      printf("	fillgray aload pop setrgbcolor\n");
-      printf("} def\n\n");
-   }
-   else {
-      printf("%% set fill box shading using single value in 'fillgray'\n");
-      printf("%%\n");
-      printf("/setfill {					%% black and white version\n");
-      printf("	fillgray setgray\n");
-      printf("} def\n\n");
-   }
-   
 
    if (FOOTSTRINGS()) {
       /* at least one foot string */
-      printf("%% -- footstrings => --\n");
-      printf("%%\n");
-      printf("%% print foot strings ([LCR]footstring) at bottom of page\n");
-      printf("%%\n");
-      printf("/footstrings {\n");
-      printf("	FootFontSet\n");
-      printf("%%	/yfoot { Y0 neggridheight add footfontsize 1.25 mul sub } bind def\n");
-      printf("	/yfoot { neggridheight 15 sub } bind def\n");
-      printf("	0 yfoot moveto\n");
-      printf("	Lfootstring show\n");
-      printf("	gridwidth Rfootstring stringwidth pop sub yfoot moveto\n");
-      printf("	Rfootstring show\n");
-      printf("	0 yfoot moveto\n");
-      printf("	Cfootstring gridwidth center\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_footstrings);
    }
-   else {
-      /* no foot strings */
-      printf("/footstrings {} bind def\n\n");
+   else if (do_whole_year) {
+      /* no foot strings (but printmonth{} still calls footstrings{}) */
+      OUT_LIT("/footstrings {} bind def\n\n");
    }
    
-   if (blank_boxes) {
-      /* blank fill boxes */
-      printf("/drawfill {} bind def\n\n");
-   }
-   else {
+   if (!blank_boxes) {
+      /*
+         pcal will generate the appropriate flavor (B&W or color) of setfill{}
+         depending on the shading values (gray scale or RGB triple) specified
+         by the "-s" flag
+      */
+      if (color_fill) {
+         OUT_LIT(ps_setfill_color);
+      }
+      else {
+         OUT_LIT(ps_setfill_gray);
+      }
+
       /* shaded fill boxes */
-      printf("%% <first> <last> fillboxes => --\n");
-      printf("%%\n");
-      printf("%% fill empty calendar boxes in range <first>..<last> (0..41)\n");
-      printf("%%\n");
-      printf("/fillboxes {\n");
-      printf("	/last exch def\n");
-      printf("	/first exch def\n");
-      printf("\n");
-      printf("	first 1 last {		%% loop through range of boxes\n");
-      printf("		/box exch def\n");
-      printf("		/fillit true def\n");
-      printf("		calsize large eq {	%% skip note and small calendar boxes\n");
-      printf("			noteboxes { box eq { /fillit false def } if } forall\n");
-      printf("			box prev_small_cal eq box next_small_cal eq or {\n");
-      printf("				/fillit false def\n");
-      printf("			} if\n");
-      printf("		} if\n");
-      printf("		fillit {		%% move to position and fill the box\n");
-      printf("			box boxpos moveto\n");
-      printf("			gsave\n");
-      printf("			setfill\n");
-      printf("			daywidth 0 rlineto\n");
-      printf("			0 negdayheight rlineto\n");
-      printf("			negdaywidth 0 rlineto\n");
-      printf("			closepath fill\n");
-      printf("			grestore\n");
-      printf("		} if\n");
-      printf("	} for\n");
-      printf("} bind def\n\n");
-
-      printf("%% -- drawfill => --\n");
-      printf("%%\n");
-      printf("%% fill in unused boxes before and after calendar dates\n");
-      printf("%%\n");
-      printf("/drawfill {\n");
-      printf("	0 startbox 1 sub fillboxes		%% fill boxes before calendar\n");
-      printf("	startbox ndays add 41 fillboxes		%% fill boxes after calendar\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_fillboxes);
+      OUT_LIT(ps_drawfill);
    }
 
    if (do_whole_year) {
       
       if (rotate == LANDSCAPE) {
          /* medium months (landscape) */
-         printf("/hspace gridwidth daywidth add def	%% one date box space between calendars\n");
-         printf("/hscale 0.2258 def			%% 1 / (4 + 3/7)\n");
-         printf("/vspace gridheight ytop add 135 add neg def %% vertical spacing\n");
-         printf("/vscale .25 def 			%% beats me how this was calculated\n");
-         printf("\n");
-         printf("/printmonth {\n");
-         printf("	/calsize medium def\n");
-         printf("\n");
-         printf("	posn 0 eq {		%% assume first month printed on page is posn 0\n");
-         printf("		startpage\n");
-         printf("		footstrings\n");
-         printf("	} if\n");
-         printf("\n");
-         printf("	gsave			%% draw medium calendar at selected position\n");
-         printf("	hscale vscale scale	%% landscape mode - 3 rows, 4 cols\n");
-         printf("	posn 4 mod hspace mul\n");
-         printf("	posn 4 idiv vspace mul 45 add\n");
-         printf("	translate\n");
-         printf("	calendar\n");
-         printf("	grestore\n");
-         printf("} bind def\n\n");
+         OUT_LIT(ps_printmonth_landscape);
       }
       else {
          /* medium months (portrait)  */
-         printf("/hspace gridwidth daywidth add def	%% one date box space between calendars\n");
-         printf("/hscale 0.3043 def			%% 1 / (3 + 2/7)\n");
-         printf("/vspace gridheight ytop add 135 add neg def %% vertical spacing\n");
-         printf("/vscale .194 def			%% beats me how this was calculated\n");
-         printf("\n");
-         printf("/printmonth {	\n");
-         printf("	/calsize medium def\n");
-         printf("\n");
-         printf("	posn 0 eq {		%% assume first month printed on page is posn 0\n");
-         printf("		gsave		%% print foot strings at original scale\n");
-         printf("		startpage\n");
-         printf("		0 25 translate  %% reposition footstrings slightly higher\n");
-         printf("		footstrings\n");
-         printf("		grestore\n");
-         printf("\n");
-         printf("		/sv_ysval ysval def	%% re-scale Y axis to full page height\n");
-         printf("		/ysval xsval pageheight pagewidth div dup mul mul def\n");
-         printf("		startpage\n");
-         printf("		/ysval sv_ysval def\n");
-         printf("	} if\n");
-         printf("\n");
-         printf("	gsave			%% draw medium calendar at selected position\n");
-         printf("	hscale vscale scale	%% portrait mode - 4 rows, 3 cols\n");
-         printf("	posn 3 mod hspace mul\n");
-         printf("	posn 3 idiv vspace mul 155 add\n");
-         printf("	translate\n");
-         printf("	calendar\n");
-         printf("	grestore\n");
-         printf("} bind def\n\n");
+         OUT_LIT(ps_printmonth_portrait);
       }
    }
    else {
-      if (head) {
-         /* date text */
-         printf("%%\n");
-         printf("%% Functions for printing text (and/or images) inside boxes:\n");
-         printf("%%\n");
-         printf("\n");
-         printf("%% <day> <text> daytext => --\n");
-         printf("%%\n");
-         printf("%% print <text> in <day> box (below date)\n");
-         printf("%%\n");
-         printf("/daytext {\n");
-         printf("	/mytext exch def /day exch def\n");
-         printf("	NotesFontSet\n");
-         printf("	day datepos datefontsize large get 0.75 mul datemargin large get\n");
-         printf("	  2 mul add notesfontsize 0.75 mul add sub dup\n");
-         printf("	  /ypos exch def exch textmargin add exch moveto\n");
-         printf("	currentpoint pop /LM exch def\n");
-         printf("	/RM LM daywidth textmargin 2 mul sub add def\n");
-         printf("	showtext\n");
-         printf("} bind def\n\n");
-
-         printf("%% <day> <text> holidaytext => --\n");
-         printf("%%\n");
-         printf("%% print <text> in <day> box (to right of date)\n");
-         printf("%%\n");
-         printf("/holidaytext {\n");
-         printf("	/mytext exch def /day exch def\n");
-         printf("\n");
-         printf("	/datesize datefontsize large get def \n");
-         printf("	/margin datemargin large get def\n");
-         printf("	/dwidth datewidth day 10 lt { 0 } { 1 } ifelse get def\n");
-         printf("\n");
-         printf("	%% display the text between the date and the moon icon (if any)\n");
-         printf("	NotesFontSet\n");
-         printf("	day datepos margin notesfontsize 0.75 mul add sub dup\n");
-         printf("	/ypos exch def exch dwidth add exch moveto\n");
-         printf("	currentpoint pop /LM exch def\n");
-         printf("	/mwidth do-moon-p {offset radius add} {0} ifelse def	%% moon width\n");
-         printf("	/RM LM daywidth textmargin sub dwidth mwidth add sub add def\n");
-         printf("	showtext\n");
-         printf("} bind def\n\n");
-
-         printf("%% <box> <text> notetext => --\n");
-         printf("%%\n");
-         printf("%% print notes heading (if any) and <text> in <box> (0..41)\n");
-         printf("%%\n");
-         printf("/notetext {\n");
-         printf("	/mytext exch def /box exch def\n");
-         printf("\n");
-         printf("	%% skip notes box heading if null\n");
-         printf("	notesheading () eq {\n");
-         printf("		box boxpos notemargin notesfontsize 0.75 mul add sub dup\n");
-         printf("	} {\n");
-         printf("		box boxpos notemargin headingfontsize 0.75 mul add sub exch\n");
-         printf("		  notemargin add exch moveto\n");
-         printf("		HeadingFontSet\n");
-         printf("		notesheading show\n");
-         printf("		box boxpos notemargin headingfontsize add\n");
-         printf("		  notesfontsize add sub dup\n");
-         printf("	} ifelse\n");
-         printf("	/ypos exch def exch notemargin add exch moveto\n");
-         printf("\n");
-         printf("	%% display the notes text\n");
-         printf("	NotesFontSet\n");
-         printf("	/LM currentpoint pop def\n");
-         printf("	/RM LM daywidth notemargin 2 mul sub add def\n");
-         printf("	showtext\n");
-         printf("} bind def\n\n");
-
-         printf("%% -- crlf => --\n");
-         printf("%%\n");
-         printf("%% simulate carriage return/line feed sequence\n");
-         printf("%%\n");
-         printf("/crlf {\n");
-         printf("	ypos notesfontsize sub /ypos exch def LM ypos moveto\n");
-         printf("} bind def\n\n");
-
-         printf("%% <string> prstr => --\n");
-         printf("%%\n");
-         printf("%% print <string> on current line if possible; otherwise print on next line\n");
-         printf("%%\n");
-         printf("/prstr {\n");
-         printf("	gsave				%% in case rescaling is necessary\n");
-         printf("	dup stringwidth pop currentpoint pop add RM gt {	%% too wide?\n");
-         printf("		%% move to the next line (unless this is the initial word)\n");
-         printf("		currentpoint pop LM ne {\n");
-         printf("			crlf hangingindent show\n");
-         printf("		} if\n");
-         printf("		%% rescale in X dimension as necessary to make word fit\n");
-         printf("		dup stringwidth pop RM currentpoint pop sub gt {\n");
-         printf("			dup stringwidth pop RM currentpoint pop sub exch div 1\n");
-         printf("			scale\n");
-         printf("		} if\n");
-         printf("	} if\n");
-         printf("	currfonttype BOLD eq\n");
-         printf("		{ dup currentpoint 2 index show exch 0.5 add exch moveto show }\n");
-         printf("		{ show }\n");
-         printf("	ifelse\n");
-         printf("	currentpoint grestore moveto	%% grestore alone would reset position\n");
-         printf("} bind def\n\n");
-
-         printf("%% -- showtext => --\n");
-         printf("%%\n");
-         printf("%% print words in 'mytext', inserting line breaks where necessary (or requested)\n");
-         printf("%%\n");
-         printf("/showtext {\n");
-         printf("	mytext {\n");
-         printf("		/word exch def\n");
-         printf("		/i 1 def\n");
-         printf("		/n 0 def\n");
-         printf("\n");
-         printf("		%% look up current word in list of special formatting strings\n");
-         printf("		[ linesep boldfont italicfont romanfont ] {\n");
-         printf("			word eq {\n");
-         printf("				/n i def\n");
-         printf("			} if\n");
-         printf("			/i i 1 add def\n");
-         printf("		} forall\n");
-         printf("	\n");
-         printf("		%% n will be 0 if current word is an ordinary word, 1..4 if it\n");
-         printf("		%% is a formatting string; execute corresponding block of code\n");
-         printf("		[\n");
-         printf("			{ word prstr ( ) show }		%% ordinary word\n");
-         printf("\n");
-         printf("			{ crlf				%% line separator (.p)\n");
-         printf("			  NotesFontSet }		%% reset font type\n");
-         printf("\n");
-         printf("			{ NotesFontSet			%% font => bold (.b)\n");
-         printf("			  /currfonttype BOLD def }\n");
-         printf("\n");
-         printf("			{ /currfonttype ITALIC def	%% font => italic (.i)\n");
-         printf("			  notesfont findfont italicmatrix makefont setfont }\n");
-         printf("\n");
-         printf("			{ NotesFontSet }		%% font => roman (.r)\n");
-         printf("		] n get exec\n");
-         printf("	} forall\n");
-         printf("} bind def\n\n");
-
-         printf("%% <day> <text> <EPS-image-filename> <x-scaling> <y-scaling> <x-offset> <y-offset> epsimage => --\n");
-         printf("%%\n");
-         printf("%% print image <EPS-image-filename> in <day> box (below date)\n");
-         printf("%%\n");
-         printf("/epsimage {\n");
-         printf("	/yoffset exch def /xoffset exch def\n");
-         printf("	/yscale exch def /xscale exch def\n");
-         printf("	/myimage exch def /mytext exch def /day exch def\n");
-         printf("	NotesFontSet\n");
-         printf("	day datepos datefontsize large get 0.75 mul datemargin large get\n");
-         printf("	2 mul add\n");
-         printf("	sub dup\n");
-         printf("	/ypos exch def exch textmargin add exch\n");
-         printf("	moveto\n");
-         printf("	currentpoint\n");
-         printf("	\n");
-         printf("	gsave\n");
-         printf("	yoffset add exch xoffset add exch  %% add the X,Y offsets\n");
-         printf("	translate\n");
-         printf("	xscale yscale scale\n");
-         printf("\n");
-         printf("	%% \n");
-         printf("	%% Temporarily redefine the 'showpage' operator to null so that it's\n");
-         printf("	%% ignored when the EPS image file is processed...\n");
-         printf("	%%\n");
-         printf("	1 dict begin /showpage { } bind def\n");
-         printf("	myimage run\n");
-         printf("	end\n");
-         printf("        \n");
-         printf("	grestore\n");
-         printf("} bind def\n\n");
+      if (use_text || use_images) {
+         /* date text and/or images */
+         OUT_LIT(ps_text_header);
+         if (use_daytext) OUT_LIT(ps_daytext);
+         if (use_holidaytext) OUT_LIT(ps_holidaytext);
+         if (use_notetext) OUT_LIT(ps_notetext);
+         if (use_text) {
+            OUT_LIT(ps_crlf);
+            OUT_LIT(ps_prstr);
+            OUT_LIT(ps_showtext);
+         }
+         if (use_images) OUT_LIT(ps_epsimage);
       }
 
 
       /* single month */
 
-      printf("%% -- printmonth => --\n");
-      printf("%%\n");
-      printf("%% print full-size calendar for 'month'/'year' on single page\n");
-      printf("%%\n");
-      printf("/printmonth {\n");
-      printf("	/calsize large def\n");
-      printf("	startpage\n");
-      printf("	calendar\n");
-      printf("	printsmallcals				%% small calendars\n");
-      printf("	\n");
-      printf("} bind def\n\n");
-
-      printf("%% scale factor (slightly < 1/7) and offset for printing small calendars\n");
-      printf("/scscale .138 def\n");
-      printf("/scoffset gridwidth gridwidth scscale 7 mul mul sub 2.0 div def\n");
-      printf("\n");
-      printf("%% -- printsmallcals => --\n");
-      printf("%%\n");
-      printf("%% print small calendars in boxes 'prev_small_cal' and 'next_small_cal'\n");
-      printf("%%\n");
-      printf("/printsmallcals {\n");
-      printf("	/calsize small def\n");
-      printf("	/sv_startbox startbox def\n");
-      printf("\n");
-      printf("	prev_small_cal 0 ge {			%% previous month/year\n");
-      printf("		/year p_year def\n");
-      printf("		/month p_month def\n");
-      printf("		/startbox p_startbox def\n");
-      printf("		/ndays p_ndays def\n");
-      printf("		gsave\n");
-      printf("		prev_small_cal boxpos translate\n");
-      printf("		scscale dup scale\n");
-      printf("		scoffset ytop neg translate\n");
-      printf("		calendar\n");
-      printf("		grestore\n");
-      printf("	} if\n");
-      printf("\n");
-      printf("	next_small_cal 0 ge {			%% next month/year\n");
-      printf("		/year n_year def\n");
-      printf("		/month n_month def\n");
-      printf("		/startbox n_startbox def\n");
-      printf("		/ndays n_ndays def\n");
-      printf("		gsave\n");
-      printf("		next_small_cal boxpos translate\n");
-      printf("		scscale dup scale\n");
-      printf("		scoffset ytop neg translate\n");
-      printf("		calendar\n");
-      printf("		grestore\n");
-      printf("	} if\n");
-      printf("\n");
-      printf("	/startbox sv_startbox def		%% required for text boxes\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_printmonth);
+      if (small_cal_pos != SC_NONE) OUT_LIT("	printsmallcals				% small calendars\n");
+      OUT_LIT("	\n} bind def\n\n");
+      if (small_cal_pos != SC_NONE) OUT_LIT(ps_printsmallcals);
    }
 
-   if (julian_dates == NO_JULIANS) {
-      /* no julian dates */
-      printf("/drawjnums {} bind def\n\n");
-   }
-   else {
+   if (julian_dates != NO_JULIANS) {
       /* some julian dates */
-      printf("%% -- drawjnums => --\n");
-      printf("%%\n");
-      printf("%% print day-of-year (and, optionally, days remaining) for each date\n");
-      printf("%%\n");
-      printf("/drawjnums {\n");
-      printf("	NotesFontSet\n");
-      printf("	1 datepos dayheight 3 sub sub exch daywidth 3 sub add exch moveto\n");
-      printf("\n");
-      printf("	1 1 ndays {\n");
-      printf("		/day exch def\n");
-      printf("		/jday jdstart day add 1 sub def\n");
-      printf("		/str jday 3 string cvs def\n");
-      printf("		julian-dates true eq {		%% print days left in year?\n");
-      printf("			/str str ( \\050) strcat yearlen jday sub 3 string cvs\n");
-      printf("				strcat (\\051) strcat def\n");
-      printf("		} if\n");
-      printf("		gsave\n");
-      printf("		str dup stringwidth pop 0 exch sub 0 rmoveto show\n");
-      printf("		grestore\n");
-      printf("		nextbox\n");
-      printf("	} for\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_drawjnums);
    }
 
    if (draw_moons == NO_MOONS) {
-      /* no moons */
-      printf("/do-moon-p { false } bind def\n");
-      printf("/drawmoons {} bind def\n\n");
+      /* no moons (holidaytext{} still asks whether to leave room for one) */
+      if (use_holidaytext) OUT_LIT("/do-moon-p { false } bind def\n\n");
    }
    else {
       /* moons on some or all days */
-      printf("%%\n");
-      printf("%% Moon-drawing functions:\n");
-      printf("%%\n\n");
-
-      printf("%% <phase> domoon => --\n");
-      printf("%%\n");
-      printf("%% draw icon showing moon at <phase> (0 = new; .25 = fq; .5 = full; .75 = lq)\n");
-      printf("%%\n");
-      printf("/domoon {\n");
-      printf("	/phase exch def\n");
-      printf("\n");
-      printf("	gsave\n");
-      printf("	currentpoint translate\n");
-      printf("	newpath\n");
-      printf("\n");
-      printf("	%% if moon is full, just draw unfilled circle\n");
-      printf("\n");
-      printf("	phase halfperiod .01 sub ge phase halfperiod .01 add le and {\n");
-      printf("		0 0 radius\n");
-      printf("		0 360 arc stroke\n");
-      printf("	}\n");
-      printf("	{\n");
-      printf("		%% draw the line arc now; prepare (but don't draw) the fill arc\n");
-      printf("\n");
-      printf("		0 0 radius			%% for line and fill arcs\n");
-      printf("		0 0 radius \n");
-      printf("		phase halfperiod lt {		%% phase between new and full\n");
-      printf("			270 90 arc stroke	%% (line on right, fill on left)\n");
-      printf("			0 radius neg moveto\n");
-      printf("			270 90 arcn \n");
-      printf("		}\n");
-      printf("		{				%% phase between full and new\n");
-      printf("			90 270 arc stroke	%% (line on left, fill on right)\n");
-      printf("			0 radius neg moveto\n");
-      printf("			270 90 arc \n");
-      printf("			/phase phase halfperiod sub def\n");
-      printf("		} ifelse\n");
-      printf("\n");
-      printf("		%% curveto uses (x0,y0) [current point], (x1,y1), (x2,y2),\n");
-      printf("		%% and (x3,y3) as the control points for drawing a Bezier\n");
-      printf("		%% cubic section, used here as the curve dividing the moon\n");
-      printf("		%% icon into dark and light sections.  x1 is in the range\n");
-      printf("		%% -R*sqrt(2) <= x1 <= R*sqrt(2) and y1 is in the range\n");
-      printf("		%% 0 <= y1 <= R; note that except in the degenerate case\n");
-      printf("		%% where x1 = y1 = x2 = y2 = 0, the curve does not actually\n");
-      printf("		%% pass through (x1,y1) or (x2,y2).\n");
-      printf("\n");
-      printf("		/x1 quartperiod phase sub rect mul def\n");
-      printf("		/y1 x1 abs 2 sqrt div def\n");
-      printf("\n");
-      printf("		%% push control points for curveto\n");
-      printf("\n");
-      printf("					%% x0 = 0   (current\n");
-      printf("					%% y0 = R    point)\n");
-      printf("		x1			%% x1\n");
-      printf("		y1			%% y1\n");
-      printf("		x1			%% x2 = x1\n");
-      printf("		y1 neg			%% y2 = -y1\n");
-      printf("		0			%% x3 = 0\n");
-      printf("		radius neg		%% y3 = -R\n");
-      printf("\n");
-      printf("		%% draw Bezier curve; fill area between curve and fill arc\n");
-      printf("\n");
-      printf("		curveto\n");
-      printf("		fill\n");
-      printf("	} ifelse\n");
-      printf("\n");
-      printf("	grestore\n");
-      printf("} bind def\n\n");
-
-      printf("%% -- do-moon-p => <bool>\n");
-      printf("%%\n");
-      printf("%% determine whether or not moon icon is to be drawn on 'day'; push result\n");
-      printf("%%\n");
-      printf("/do-moon-p {\n");
-      printf("	draw-moons (some) eq {		%% printing quarter moons?  look up day\n");
-      printf("		/p false def\n");
-      printf("		quarter_moons { day eq { /p true def } if } forall\n");
-      printf("		p\n");
-      printf("	}\n");
-      printf("	{\n");
-      printf("		draw-moons		%% all moons or no moons\n");
-      printf("	} ifelse\n");
-      printf("} bind def\n\n");
-
-      printf("%% -- drawmoons => --\n");
-      printf("%%\n");
-      printf("%% main routine to draw moon icons on calendar\n");
-      printf("%%\n");
-      printf("/drawmoons {\n");
-      printf("	gsave\n");
-      printf("	moonlinewidth setlinewidth\n");
-      printf("	1 datepos offset sub exch daywidth add offset sub exch moveto\n");
-      printf("	/n 0 def			%% index into moon_phases\n");
-      printf("	1 1 ndays {\n");
-      printf("		/day exch def\n");
-      printf("		do-moon-p {		%% draw a moon today?\n");
-      printf("			moon_phases n get domoon\n");
-      printf("			/n n 1 add def\n");
-      printf("		} if\n");
-      printf("		nextbox\n");
-      printf("	} for\n");
-      printf("	grestore\n");
-      printf("} bind def\n\n");
+      OUT_LIT(ps_domoon);
+      OUT_LIT(ps_do_moon_p);
+      OUT_LIT(ps_drawmoons);
    }
 
+   if (compress_ps) out_compress_end();
+
    /*
       Write out PostScript code to print calendars...
    */
@@ -1709,9 +1900,9 @@ void write_psfile (void)
    
 #ifdef EPS_DSC
    /* generate trailer at end of PostScript output */
-   printf("%%%%Trailer\n");
-   printf("clear flush\n");
-   printf("%%%%EOF\n");
+   OUT_LIT("%%Trailer\n");
+   OUT_LIT("clear flush\n");
+   OUT_LIT("%%EOF\n");
 #endif
 
    return;
@@ -1740,7 +1931,7 @@ void write_calfile (void)
    }
    
    /* print the date style for subsequent use by Pcal */
-   printf("%s -%c\n", kw_opt, date_style == USA_DATES ? F_USA_DATES :
+   out_printf("%s -%c\n", kw_opt, date_style == USA_DATES ? F_USA_DATES :
           F_EUR_DATES);
    
    for (i = 0, this_month = init_month, this_year = init_year;
@@ -1764,54 +1955,55 @@ void write_calfile (void)
 void single_month_html (int this_month, int this_year)
 {
    long holidays;
-   int day, box, len;
-   year_info *py;
+   int day, box, len, hol;
    month_info *pm;
-   register day_info *pd;
+   day_info *pd;
+   span_info *ps;
+   char *text;
    
    /* table heading with month and year */
-   printf("<a name=_%02d%02d>\n", this_month, this_year % 100);
-   printf("<table width=100%% border=%d>\n", BORDER);
-   printf("<tr><th colspan=7>%s", MONTHYEAR_PRE);
+   out_printf("<a name=_%02d%02d>\n", this_month, this_year % 100);
+   out_printf("<table width=100%% border=%d>\n", BORDER);
+   out_printf("<tr><th colspan=7>%s", MONTHYEAR_PRE);
    print_html(months_ml[output_language][this_month-1]);
-   printf(" %d%s</th></tr>\n", this_year, MONTHYEAR_POST);
+   out_printf(" %d%s</th></tr>\n", this_year, MONTHYEAR_POST);
    
    /* headings for weekday names */
-   printf("<tr>");
+   OUT_LIT("<tr>");
    for (day = 0; day < 7; day++) {
       char buf[40];
       strcpy(buf, days_ml[output_language][(day + first_day_of_week) % 7]);
 
       /* buf[ABBR_MONTH_LEN] = '\0'; */
 
-      printf("<th width=14%%>");
+      OUT_LIT("<th width=14%>");
       print_html(buf);
-      printf("</th>");
+      OUT_LIT("</th>");
    }
-   printf("</tr>\n");
+   OUT_LIT("</tr>\n");
    
    /* blank space at beginning (if necessary) - divide into N one-column
     * boxes (#if DIVIDE_BLANK_SPACE) or print as single N-column box
     */
-   printf("<tr>\n");
+   OUT_LIT("<tr>\n");
    if ((box = START_BOX(this_month, this_year)) > 0) {
 
 #if DIVIDE_BLANK_SPACE
       int i;
       for (i = 0; i < box; i++) {
-         printf("<td>");
+         OUT_LIT("<td>");
          BLANKLINES(TEXTLINES);
-         printf("</td>\n");
+         OUT_LIT("</td>\n");
       }
 #else
-      printf("<td colspan=%d>", box);
+      out_printf("<td colspan=%d>", box);
       BLANKLINES(TEXTLINES);
-      printf("</td>\n");
+      OUT_LIT("</td>\n");
 #endif
    }
 
    /* get pointer to text information for current month */
-   pm = (py = find_year(this_year, FALSE)) != NULL ? py->month[this_month-1] : NULL;
+   pm = find_month_info(this_month, this_year);
 
    /* main loop for dates */
    len = LENGTH_OF(this_month, this_year);
@@ -1820,31 +2012,31 @@ void single_month_html (int this_month, int this_year)
         day++, box++, holidays >>= 1) {
       int nrows;
       
-      if (box > 0 && box % 7 == 0) printf("<tr>\n");   /* start of row */
+      if (box > 0 && box % 7 == 0) OUT_LIT("<tr>\n");   /* start of row */
          
-      printf("<td valign=top>");
+      OUT_LIT("<td valign=top>");
 
       /* special HTML code for holidays (cf. pcaldefs.h) */
-      if (holidays & 01) printf("%s%d%s", HOLIDAY_PRE, day, HOLIDAY_POST);
-      else printf("%d", day);
+      if (holidays & 01) out_printf("%s%d%s", HOLIDAY_PRE, day, HOLIDAY_POST);
+      else out_int(day, 0, ' ');
 
       /* print associated text (count lines) */
-      for (nrows = 0, pd = pm ? pm->day[day-1] : NULL;
-           pd;
-           pd = pd->next, nrows++) {
+      for (nrows = 0, pd = NULL, ps = NULL;
+           (text = next_day_text(pm, this_month, day, this_year, &pd, &ps, &hol)) != NULL;
+           nrows++) {
          /* Skip lines specifying an EPS image... */
-         if (ci_strncmp(pd->text, "image:", 6) == 0) continue;
-         printf("\n<br>");
+         if (ci_strncmp(text, "image:", 6) == 0) continue;
+         OUT_LIT("\n<br>");
          this_day = day;
          RESET_DATE();   /* reset working date */
-         print_html(pd->text);
+         print_html(text);
       }
       
       /* pad first box in each row with blank lines */
       if (box % 7 == 0 && nrows < TEXTLINES) BLANKLINES(TEXTLINES - nrows);
       
-      printf("</td>\n");
-      if (box % 7 == 6) printf("</tr>\n");   /* end of row */
+      OUT_LIT("</td>\n");
+      if (box % 7 == 6) OUT_LIT("</tr>\n");   /* end of row */
    }
 
    /* blank space at end (if necessary) - divide into N one-column
@@ -1854,29 +2046,29 @@ void single_month_html (int this_month, int this_year)
 #if DIVIDE_BLANK_SPACE
       int i;
       for (i = box; i < 7; i++) {
-         printf("<td>");
+         OUT_LIT("<td>");
          BLANKLINES(TEXTLINES);
-         printf("</td>\n");
+         OUT_LIT("</td>\n");
       }
 #else
-      printf("<td colspan=%d>", 7 - box);
+      out_printf("<td colspan=%d>", 7 - box);
       BLANKLINES(TEXTLINES);
-      printf("</td>\n");
+      OUT_LIT("</td>\n");
 #endif
    }
-   printf("</tr>\n");
-   printf("</table>\n");
+   OUT_LIT("</tr>\n");
+   OUT_LIT("</table>\n");
 
    /* links to other months on page */
    if (nmonths > 2) {
       int j, m, y;
       char c = date_style == EUR_DATES ? '.' : '/';
       
-      printf("<p>");
+      OUT_LIT("<p>");
       for (j = 0, m = init_month, y = init_year;
            j < nmonths;
            j++, BUMP_MONTH_AND_YEAR(m, y)) {
-         printf("<a href=#_%02d%02d>%02d%c%02d</a>%s\n",
+         out_printf("<a href=#_%02d%02d>%02d%c%02d</a>%s\n",
                 m, y % 100, m, c, y % 100,
                 j % 12 == 11 ? "<br>" : "&nbsp;");
       }
@@ -1899,18 +2091,18 @@ void single_month_html (int this_month, int this_year)
 void single_month_one_column_html (int this_month, int this_year)
 {
    long holidays;
-   int day, box = 0, len, i;
-   year_info *py;
+   int day, box = 0, len, i, hol;
    month_info *pm;
-   register day_info *pd;
-   char *text_short;
+   day_info *pd;
+   span_info *ps;
+   char *text, *text_short;
    
    /* table heading with first 5 chars of the month */
-   printf("<table border=%d>\n", BORDER);
-   printf("<tr><th width=100px>%s</th></tr>\n", months_ml[output_language][this_month-1]);
+   out_printf("<table border=%d>\n", BORDER);
+   out_printf("<tr><th width=100px>%s</th></tr>\n", months_ml[output_language][this_month-1]);
    
    /* get pointer to text information for current month */
-   pm = (py = find_year(this_year, FALSE)) != NULL ? py->month[this_month-1] : NULL;
+   pm = find_month_info(this_month, this_year);
 
    /* main loop for dates */
    len = LENGTH_OF(this_month, this_year);
@@ -1920,62 +2112,62 @@ void single_month_one_column_html (int this_month, int this_year)
       int nrows;
       
       /* print only one column for the month */
-      printf("<tr>\n");
-      printf("<td valign=top>");
+      OUT_LIT("<tr>\n");
+      OUT_LIT("<td valign=top>");
 
       /* special HTML code for holidays (cf. pcaldefs.h) */
       if (holidays & 01) {
-         printf("%s%d%s %c", HOLIDAY_PRE, day, HOLIDAY_POST,
+         out_printf("%s%d%s %c", HOLIDAY_PRE, day, HOLIDAY_POST,
                 days_ml[output_language][(day + START_BOX(this_month, this_year) + 
                                           first_day_of_week - 1) % 7][0]);
       }
       else {
          /* print Sundays in bold */
          if ((day + START_BOX(this_month, this_year) + first_day_of_week - 1) % 7 == 0) {
-            printf("<B>%d %c</B>", day,
+            out_printf("<B>%d %c</B>", day,
                    days_ml[output_language][(day + START_BOX(this_month, this_year) + 
                                              first_day_of_week - 1) % 7][0]);
          }
          /* print Saturdays in gray */
          else if ((day + START_BOX(this_month, this_year) + first_day_of_week - 1) % 7 == 6) {
-            printf("<B><FONT color=darkgray>%d</FONT> %c</B>", day,
+            out_printf("<B><FONT color=darkgray>%d</FONT> %c</B>", day,
                    days_ml[output_language][(day + START_BOX(this_month, this_year) + 
                                              first_day_of_week - 1) % 7][0]);
          }
          else {
-            printf("%d %c", day, days_ml[output_language]
+            out_printf("%d %c", day, days_ml[output_language]
                    [(day + START_BOX(this_month, this_year) + first_day_of_week - 1) % 7][0]);
          }
          /* print associated text (count lines),
             not for holidays */
-         for (nrows = 0, pd = pm ? pm->day[day-1] : NULL;
-              pd;
-              pd = pd->next, nrows++) {
+         for (nrows = 0, pd = NULL, ps = NULL;
+              (text = next_day_text(pm, this_month, day, this_year, &pd, &ps, &hol)) != NULL;
+              nrows++) {
             /* Skip lines specifying an EPS image... */
-            if (ci_strncmp(pd->text, "image:", 6) == 0) continue;
-            printf("\n<I>");
+            if (ci_strncmp(text, "image:", 6) == 0) continue;
+            OUT_LIT("\n<I>");
             this_day = day;
             RESET_DATE();   /* reset working date */
-            text_short = pd->text;
+            text_short = text;
             for  (i=0; i < 5; i++) {
                if (text_short[i] == '\0') break;
                /* if text starts with < it is probably an HTML tag (e.g. <I>)
                   -> skip three letters
                */
                if(text_short[0] == '<' && text_short[i+3] == '\0') break;
-               if(text_short[0] == '<') printf("%c",text_short[i+3]);
-               else printf("%c",text_short[i]);
+               if(text_short[0] == '<') out_char(text_short[i+3]);
+               else out_char(text_short[i]);
             }
-            printf("</I>\n");
+            OUT_LIT("</I>\n");
          }
       }
       
       /* TR-tag to end the row */
-      printf("</td></TR>\n");
-      if (box % 7 == 6) printf("</tr>\n");   /* end of row */
+      OUT_LIT("</td></TR>\n");
+      if (box % 7 == 6) OUT_LIT("</tr>\n");   /* end of row */
    }
-   printf("</tr>\n");
-   printf("</table>\n");
+   OUT_LIT("</tr>\n");
+   OUT_LIT("</table>\n");
 
    return;   
 }
@@ -1995,7 +2187,6 @@ void multiple_months_html (int first_month, int first_year, int ncols)
 {
    long holidays;
    int day, box, len;
-   year_info *py;
    month_info *pm;
    int i, m, d, y, w, wd1, wd2, nw;
    
@@ -2004,23 +2195,23 @@ void multiple_months_html (int first_month, int first_year, int ncols)
    wd2 = (100 - (ncols * (7 * wd1))) / (ncols - 1);
    
    /* table heading with months and year */
-   printf("<table width=100%% border=%d>\n", 0);
+   out_printf("<table width=100%% border=%d>\n", 0);
    
-   printf("<tr>");
+   OUT_LIT("<tr>");
    for (i = 0, m = first_month, y = first_year;
         i < ncols;
         i++, BUMP_MONTH_AND_YEAR(m, y)) {
-      if (i > 0) printf("<th><br></th>");
-      printf("<th colspan=7>%s", MONTHYEAR_W_PRE);
+      if (i > 0) OUT_LIT("<th><br></th>");
+      out_printf("<th colspan=7>%s", MONTHYEAR_W_PRE);
       print_html(months_ml[output_language][m-1]);
-      printf(" %d%s</th>\n", y, MONTHYEAR_W_POST);
+      out_printf(" %d%s</th>\n", y, MONTHYEAR_W_POST);
    }
-   printf("</tr>\n");
+   OUT_LIT("</tr>\n");
    
    /* headings for weekday names */
-   printf("<tr>");
+   OUT_LIT("<tr>");
    for (i = 0; i < ncols; i++) {
-      if (i > 0) printf("\n<th width=%d%%><br></th>", wd2);
+      if (i > 0) out_printf("\n<th width=%d%%><br></th>", wd2);
       for (day = 0; day < 7; day++) {
          char buf[40];
          strcpy(buf, days_ml[output_language][(day + first_day_of_week) % 7]);
@@ -2029,12 +2220,12 @@ void multiple_months_html (int first_month, int first_year, int ncols)
 #else
          buf[2] = '\0';   /* truncate to two characters */
 #endif
-         printf("<th width=%d%%>", wd1);
+         out_printf("<th width=%d%%>", wd1);
          print_html(buf);
-         printf("</th>");
+         OUT_LIT("</th>");
       }
    }
-   printf("</tr>\n");
+   OUT_LIT("</tr>\n");
    
 #ifdef CONSISTENT_SPACING
    /* always print 6 weeks (to maintain consistent vertical spacing) */
@@ -2052,42 +2243,42 @@ void multiple_months_html (int first_month, int first_year, int ncols)
    /* main loop to print dates (one week at a time) */
    
    for (w = 0; w < nw; w++) {
-      printf("<tr>");
+      OUT_LIT("<tr>");
 
       /* print one week of dates for each month */
       
       for (i = 0, m = first_month, y = first_year;
            i < ncols;
            i++, BUMP_MONTH_AND_YEAR(m, y)) {
-         if (i > 0) printf("<td><br></td>");
+         if (i > 0) OUT_LIT("<td><br></td>");
 
          /* get starting box, month length, holiday info */
          box = START_BOX(m, y);
          len = LENGTH_OF(m, y);
-         pm = (py = find_year(y, FALSE)) != NULL ? py->month[m-1] : NULL;
+         pm = find_month_info(m, y);
          holidays = pm ? pm->holidays : 0;
          
          /* loop over days in current week and month */
          
          for (d = 1; d <= 7; d++) {
             day = (7 * w) + d - box;
-            if (day < 1 || day > len) printf("<td><br></td>");
+            if (day < 1 || day > len) OUT_LIT("<td><br></td>");
             else {
-               printf("<td align=center>");
+               OUT_LIT("<td align=center>");
                if (holidays & (1L << (day - 1))) {
-                  printf("%s%d%s", HOLIDAY_PRE, day, HOLIDAY_POST);
+                  out_printf("%s%d%s", HOLIDAY_PRE, day, HOLIDAY_POST);
                }
-               else printf("%d", day);
+               else out_int(day, 0, ' ');
 
-               printf("</td>");
+               OUT_LIT("</td>");
             }
          }
       }
-      printf("</tr>\n");
+      OUT_LIT("</tr>\n");
    }
    
    /* end of table */
-   printf("</table>\n");
+   OUT_LIT("</table>\n");
 
    return;
 }
@@ -2124,51 +2315,51 @@ void write_htmlfile (void)
    RESET_DATE();
    
    /* HTML boilerplate */
-   printf("<html>\n");
-   printf("<head>\n");
+   OUT_LIT("<html>\n");
+   OUT_LIT("<head>\n");
    
    /*
     * if center footstring (-C) was specified, use it as the title;
     * otherwise contrive title from beginning/ending month/year
     */
-   printf("<title>");
+   OUT_LIT("<title>");
    if (cfoot[0]) {
       print_html(cfoot);
    }
    else {
       if (do_whole_year && init_month == JAN) {
-         printf("%d", init_year);
-         if (final_year > init_year) printf(" - %d", final_year);
+         out_int(init_year, 0, ' ');
+         if (final_year > init_year) out_printf(" - %d", final_year);
       } 
       else {
          char c = date_style == EUR_DATES ? '.' : '/';
-         printf("%d%c%02d", init_month, c, init_year % 100);
+         out_printf("%d%c%02d", init_month, c, init_year % 100);
          if (nmonths > 1) {
-            printf(" - %d%c%02d", final_month, c, final_year % 100);
+            out_printf(" - %d%c%02d", final_month, c, final_year % 100);
          }
       }
    }
-   printf("</title>\n");
-   printf("</head>\n");
+   OUT_LIT("</title>\n");
+   OUT_LIT("</head>\n");
    
    /* generate <body> definition with attributes */
-   printf("<body");
+   OUT_LIT("<body");
    for (pb = body_attributes; pb->attribute; pb++) {
       char *p = pb->value;
       if (p && *p) {
-         printf(" %s=%s%s\"", pb->attribute,
+         out_printf(" %s=%s%s\"", pb->attribute,
                 pb->numeric && p[0] != '#' ? "\"#" : "\"",
                 pb->value);
       }
    }
-   printf(">\n");
+   OUT_LIT(">\n");
    
    /* repeat center footstring (if specified) as heading */
    if (cfoot[0]) {
       RESET_DATE();
-      printf("%s", HEADING_PRE);
+      out_str(HEADING_PRE);
       print_html(cfoot);
-      printf("%s\n", HEADING_POST);
+      out_printf("%s\n", HEADING_POST);
    }
    
    /* loop over all specified months, creating HTML table for each */
@@ -2181,7 +2372,7 @@ void write_htmlfile (void)
       
       nc = (rotate == LANDSCAPE) ? 4 : 3;
       for (i = 0; i < nmonths; i += nc) {
-         if (i > 0) printf("<p>\n");
+         if (i > 0) OUT_LIT("<p>\n");
          multiple_months_html(this_month, this_year, nc);
          for (j = 0; j < nc; j++) BUMP_MONTH_AND_YEAR(this_month, this_year);
       }
@@ -2189,26 +2380,26 @@ void write_htmlfile (void)
    else {
       /* single-month mode - generate one month per table
        * either in one or several columns */
-      if (one_column) printf("<TABLE><TR>");
+      if (one_column) OUT_LIT("<TABLE><TR>");
       for (i = 0; i < nmonths; i++) {
          if (one_column) {
-            printf("<TD valign=\"top\">");
+            OUT_LIT("<TD valign=\"top\">");
             single_month_one_column_html(this_month, this_year);
-            printf("</TD>");
+            OUT_LIT("</TD>");
          }
          else {
-            printf("<TD valign=\"top\" width=\"%i%%\">",100/nmonths);
-            if (i > 0) printf("<p><br>\n");
+            out_printf("<TD valign=\"top\" width=\"%i%%\">",100/nmonths);
+            if (i > 0) OUT_LIT("<p><br>\n");
             single_month_html(this_month, this_year);
          }
          BUMP_MONTH_AND_YEAR(this_month, this_year);
       }
-      printf("</TR></TABLE>");
+      OUT_LIT("</TR></TABLE>");
    }
    
    /* boilerplate to terminate HTML file */
-   printf("</body>\n");
-   printf("</html>\n");
+   OUT_LIT("</body>\n");
+   OUT_LIT("</html>\n");
 
    return;
 }
@@ -2540,20 +2731,20 @@ char *print_word (char *p)
       if (c == '%' && p[1] != '\0') {
          p = expand_fmt(buf, p + 1);
          if (*buf && first) {
-            printf("(");
+            OUT_LIT("(");
             first = FALSE;
          }
-         PUTSTR(isalnum, buf, stdout);
+         OUT_PUTSTR(isalnum, buf);
       } 
       else {
-         if (first) printf("(");
+         if (first) OUT_LIT("(");
          first = FALSE;
-         PUTCHAR(isalnum, c, stdout);
+         OUT_PUTCHAR(isalnum, c);
          p++;
       }
    }
    
-   if (!first) printf(")");
+   if (!first) OUT_LIT(")");
    
    return p;
 }
@@ -2605,7 +2796,7 @@ void print_pstext (char *p)
 {
    char *s = p;   /* save for possible second pass */
    
-   while ((p = print_word(p)) != NULL) printf(" ");
+   while ((p = print_word(p)) != NULL) OUT_LIT(" ");
 
    /* repeat to generate debugging info if requested */
    if (debug_text) {
@@ -2634,10 +2825,10 @@ void print_text (char *p)
       if (c == '%' && p[1] != '\0') {
          p = expand_fmt(buf, p + 1);
          /* AH: non-ascii for -c mode should pass clean! */
-         PUTSTR_CLEAN(isprint, buf, stdout);
+         OUT_PUTSTR_CLEAN(isprint, buf);
       } 
       else {
-         PUTCHAR_CLEAN(isprint, c, stdout);
+         OUT_PUTCHAR_CLEAN(isprint, c);
          p++;
       }
    }
@@ -2668,18 +2859,18 @@ void def_footstring (char *p, char *str)
    this_day = 1;   /* set default day in foot string */
    RESET_DATE();   /* reset working date */
    
-   printf("/%s (", str);
+   out_printf("/%s (", str);
    while ((c = *p) != '\0') {
       if (c == '%' && p[1] != '\0') {
          p = expand_fmt(buf, p + 1);
-         PUTSTR(isalnum, buf, stdout);
+         OUT_PUTSTR(isalnum, buf);
       } 
       else {
-         PUTCHAR(isalnum, c, stdout);
+         OUT_PUTCHAR(isalnum, c);
          p++;
       }
    }
-   printf(") def\n");
+   OUT_LIT(") def\n");
 
    return;
 }
@@ -2690,6 +2881,45 @@ void def_footstring (char *p, char *str)
  */
 
 
+/* ---------------------------------------------------------------------------
+
+   next_day_text
+
+   Notes:
+
+      This routine returns the next text for the specified day of the
+      specified month/year (NULL if no more): first the day's own entries
+      (in order of entry), then the text of any span events covering it (cf.
+      'find_span_info()').  It also returns the text's holiday flag via
+      'pis_holiday'.
+
+      The caller initializes '*ppd' and '*pps' to NULL before the first
+      call; 'pm' is the month's data (cf. 'find_month_info()'), if any.
+
+*/
+char *next_day_text (month_info *pm, int month, int day, int year,
+                     day_info **ppd, span_info **pps, int *pis_holiday)
+{
+   day_info *pd;
+
+   if (*pps == NULL && pm != NULL) {   /* day's own entries */
+      pd = *ppd ? *ppd + 1 : FIRST_DAY_INFO(pm, day-1);
+      if (pd < END_DAY_INFO(pm, day-1)) {
+         *ppd = pd;
+         *pis_holiday = pd->is_holiday;
+         return pd->text;
+      }
+   }
+
+   /* span events (which do not apply to the notes boxes) */
+   if (day < FIRST_NOTE_DAY && (*pps = find_span_info(month, day, year, *pps)) != NULL) {
+      *pis_holiday = (*pps)->is_holiday;
+      return (*pps)->text;
+   }
+
+   return NULL;
+}
+
 /* ---------------------------------------------------------------------------
 
    find_daytext
@@ -2706,36 +2936,36 @@ void def_footstring (char *p, char *str)
 void find_daytext (int month, int year, int is_holiday)
 {
    register int day;
-   year_info *py;
    month_info *pm;
-   register day_info *pd;
-   int first;
-   char *fcn = is_holiday ? "holidaytext" : "daytext";
+   day_info *pd;
+   span_info *ps;
+   int first, text_hol;
+   char *text, *fcn = is_holiday ? "holidaytext" : "daytext";
    char hol = is_holiday ? '*' : ' ';
    
    /* if no text for this year and month, return */
    
-   if ((py = find_year(year, FALSE)) == NULL || (pm = py->month[month-1]) == NULL) {
+   if ((pm = find_month_info(month, year)) == NULL) {
       return;
    }
    
    /* walk array of day text pointers and linked lists of text */
 
    for (day = 1; day <= LAST_NOTE_DAY; day++) {
-      for (pd = pm->day[day-1], first = TRUE;
-           pd;
-           pd = pd->next) {
-         if (pd->is_holiday != is_holiday) continue;
+      for (pd = NULL, ps = NULL, first = TRUE;
+           (text = next_day_text(pm, month, day, year, &pd, &ps, &text_hol)) != NULL;
+           ) {
+         if (text_hol != is_holiday) continue;
          /* Skip lines specifying an EPS image... */
-         if (ci_strncmp(pd->text, "image:", 6) == 0) continue;
+         if (ci_strncmp(text, "image:", 6) == 0) continue;
          if (first) {
-            printf("%d [ \n", day >= FIRST_NOTE_DAY ?
+            out_printf("%d [ \n", day >= FIRST_NOTE_DAY ?
                    note_box(month, day, year) : day);
          }
          else {
-            printf("\n");
+            OUT_LIT("\n");
             print_word(LINE_SEP);   /* separate lines */
-            printf("\n");
+            OUT_LIT("\n");
          }
          this_day = day >= FIRST_NOTE_DAY ? 1 : day;
          RESET_DATE();   /* reset working date */
@@ -2747,12 +2977,12 @@ void find_daytext (int month, int year, int is_holiday)
                fprintf(stderr, "%02d[%02d]%d  ", month, day - FIRST_NOTE_DAY + 1, year);
             }
          }
-         print_pstext(pd->text);
+         print_pstext(text);
          if (debug_text) fprintf(stderr, "\n");
          first = FALSE;
       }
       if (! first) {   /* wrap up call (if one made) */
-         printf("\n] %s\n", day >= FIRST_NOTE_DAY ? "notetext" : fcn);
+         out_printf("\n] %s\n", day >= FIRST_NOTE_DAY ? "notetext" : fcn);
       }
    }
 
@@ -2772,39 +3002,43 @@ void find_daytext (int month, int year, int is_holiday)
 void find_images (int month, int year)
 {
    register int day;
-   year_info *py;
    month_info *pm;
-   register day_info *pd;
+   day_info *pd;
+   span_info *ps;
+   char *text;
+   int hol;
    
    /* if no text for this year and month, return */
    
-   if ((py = find_year(year, FALSE)) == NULL || (pm = py->month[month-1]) == NULL) {
+   if ((pm = find_month_info(month, year)) == NULL) {
       return;
    }
 
    /* walk array of day text pointers and linked lists of text */
    
    for (day = 1; day <= LAST_NOTE_DAY; day++) {
-      for (pd = pm->day[day-1]; pd; pd = pd->next) {
+      for (pd = NULL, ps = NULL;
+           (text = next_day_text(pm, month, day, year, &pd, &ps, &hol)) != NULL;
+           ) {
          
          /* Determine if this is a 'daytext' or an 'image'... */
-         if (ci_strncmp(pd->text, "image:", 6) == 0) {
+         if (ci_strncmp(text, "image:", 6) == 0) {
             
             char temp_str[300];
             char *p;
             
-            printf("%d [()] \n", day);
+            out_printf("%d [()] \n", day);
             
-            strncpy(temp_str, pd->text, sizeof temp_str);
-            p = strchr(pd->text, ' ');  /* Isolate the EPS image filename */
+            /* the text may be shared with other days (cf. intern_text()),
+               so isolate the EPS image filename without modifying it */
+            p = strchr(text, ' ');
             strncpy(temp_str, p+1, sizeof temp_str);  /* Copy the remaining parameters */
-            *p = '\0';
-            printf("(%s) %s ", pd->text+6, temp_str);
+            out_printf("(%.*s) %s ", (int) (p - text) - 6, text+6, temp_str);
             
             this_day = 1;
             RESET_DATE();   /* reset working date */
             
-            printf("epsimage\n");
+            OUT_LIT("epsimage\n");
          }
       }
    }
@@ -2826,7 +3060,6 @@ void find_images (int month, int year)
 void print_colors (int month, int year)
 {
    register int day;
-   year_info *py;
    month_info *pm;
    unsigned long holidays;
    int j, len;
@@ -2841,7 +3074,7 @@ void print_colors (int month, int year)
       color[day] = day_color[j];
    }
    
-   pm = (py = find_year(year, FALSE)) ? py->month[month-1] : NULL;
+   pm = find_month_info(month, year);
    
    /* override weekday color for holidays */
    for (holidays = pm ? pm->holidays : 0, day = 1;
@@ -2850,12 +3083,12 @@ void print_colors (int month, int year)
       if (holidays & 01) color[day] = holiday_color;
    }
    
-   printf("/date_color [ -1");   /* dummy value for element 0 */
+   OUT_LIT("/date_color [ -1");   /* dummy value for element 0 */
 
    for (day = 1; day <= len; day++) {
-      printf("%s %d", day % 10 == 1 ? " " : "", color[day]);
+      out_printf("%s %d", day % 10 == 1 ? " " : "", color[day]);
    }
-   printf(" ] def\n");
+   OUT_LIT(" ] def\n");
 
    return;
 }
@@ -2873,28 +3106,26 @@ void print_colors (int month, int year)
 void find_noteboxes (int month, int year)
 {
    register int day;
-   year_info *py;
    month_info *pm;
    
    /* if no text for this year and month, print empty list and return */
    
-   if ((py = find_year(year, FALSE)) == NULL ||
-       (pm = py->month[month-1]) == NULL) {
-      printf("/noteboxes [ ] def\n");
+   if ((pm = find_month_info(month, year)) == NULL) {
+      OUT_LIT("/noteboxes [ ] def\n");
       return;
    }
    
-   printf("/noteboxes [");   /* start definition of list */
+   OUT_LIT("/noteboxes [");   /* start definition of list */
    
    /* walk array of note text pointers, converting days to box numbers */
    
    for (day = FIRST_NOTE_DAY; day <= LAST_NOTE_DAY; day++) {
-      if (pm->day[day-1]) {
-         printf(" %d", note_box(month, day, year));
+      if (FIRST_DAY_INFO(pm, day-1) < END_DAY_INFO(pm, day-1)) {
+         out_printf(" %d", note_box(month, day, year));
       }
    }
 
-   printf(" ] def\n");
+   OUT_LIT(" ] def\n");
 
    return;
 }
@@ -2912,22 +3143,23 @@ void find_noteboxes (int month, int year)
 void print_dates (int month, int year)
 {
    register int day;
-   year_info *py;
    month_info *pm;
-   register day_info *pd;
+   day_info *pd;
+   span_info *ps;
+   char *text;
    unsigned long holidays;
-   int has_holiday_text;
+   int has_holiday_text, hol;
    static int save_year = 0;
    
    /* if no text for this year and month, return */
    
-   if ((py = find_year(year, FALSE)) == NULL || (pm = py->month[month-1]) == NULL) {
+   if ((pm = find_month_info(month, year)) == NULL) {
       return;
    }
    
    /* print the year if it has changed */
    
-   if (year != save_year) printf("%s %d\n", kw_year, save_year = year);
+   if (year != save_year) out_printf("%s %d\n", kw_year, save_year = year);
 
    /* walk array of day text pointers and linked lists of text */
    
@@ -2935,27 +3167,29 @@ void print_dates (int month, int year)
         day < FIRST_NOTE_DAY;
         holidays >>= 1L, day++) {
       has_holiday_text = FALSE;
-      for (pd = pm->day[day-1]; pd; pd = pd->next) {
+      for (pd = NULL, ps = NULL;
+           (text = next_day_text(pm, month, day, year, &pd, &ps, &hol)) != NULL;
+           ) {
          /* Bypass entries that specify an EPS image... */
-         if (ci_strncmp(pd->text, "image:", 6) == 0) continue;
-         if (date_style == USA_DATES) printf("%02d/%02d", month, day);
-         else printf("%02d/%02d", day, month);
+         if (ci_strncmp(text, "image:", 6) == 0) continue;
+         if (date_style == USA_DATES) out_printf("%02d/%02d", month, day);
+         else out_printf("%02d/%02d", day, month);
 #ifdef KEEP_ASTERISKS
-         printf(pd->is_holiday ? "*\t" : "\t");
+         out_printf(hol ? "*\t" : "\t");
 #else
-         printf("\t");
+         OUT_LIT("\t");
 #endif
          this_day = day;
          RESET_DATE();   /* reset working date */
-         print_text(pd->text);
-         printf("\n");
-         has_holiday_text |= pd->is_holiday;
+         print_text(text);
+         OUT_LIT("\n");
+         has_holiday_text |= hol;
       }
 #ifdef KEEP_ASTERISKS
       /* was date flagged as holiday w/o associated text? */
       if ((holidays & 01) && !has_holiday_text) {
-         if (date_style == USA_DATES) printf("%02d/%02d*\n", month, day);
-         else printf("%02d/%02d*\n", day, month);
+         if (date_style == USA_DATES) out_printf("%02d/%02d*\n", month, day);
+         else out_printf("%02d/%02d*\n", day, month);
       }
 #endif
    }
@@ -2988,9 +3222,9 @@ void print_moon_info (int month, int year)
 
    /* print the phase of the moon for each day of the month */
    
-   printf("/moon_phases [\t\t%% from algorithm ");
-   if (atof(time_zone) != 0.0) printf(" (UTC offset = %s)", time_zone);
-   printf("\n\t");
+   OUT_LIT("/moon_phases [\t\t% from algorithm ");
+   if (atof(time_zone) != 0.0) out_printf(" (UTC offset = %s)", time_zone);
+   OUT_LIT("\n\t");
    
    for (n = 0, qdays = 0L, day = 1, ndays = LENGTH_OF(month, year);
         day <= ndays;
@@ -3006,21 +3240,21 @@ void print_moon_info (int month, int year)
       /* adjust phase to exact quarter if printing only quarters */
       if (draw_moons == SOME_MOONS && quarter != MOON_OTHER) phase = 0.25 * quarter;
       if (draw_moons == ALL_MOONS || quarter != MOON_OTHER) {
-         printf("%.3f%s", PRT_TWEAK(phase), ++n % 10 == 0 ? "\n\t" : " ");
+         out_printf("%.3f%s", PRT_TWEAK(phase), ++n % 10 == 0 ? "\n\t" : " ");
       }
 
       if (quarter != MOON_OTHER) qdays |= 1L << (day - 1);
    }
-   printf("] def\n");
+   OUT_LIT("] def\n");
    
    /* if drawing only quarter moons, print days when they occur */
    
    if (draw_moons == SOME_MOONS) {
-      printf("/quarter_moons [ ");
+      OUT_LIT("/quarter_moons [ ");
       for (day = 1; qdays; day++, qdays >>= 1) {
-         if (qdays & 01) printf("%d ", day);
+         if (qdays & 01) out_printf("%d ", day);
       }
-      printf("] def\n");
+      OUT_LIT("] def\n");
    }
    
    return;
@@ -3038,10 +3272,10 @@ void print_moon_info (int month, int year)
 void print_julian_info (int month, int year)
 {
    if (julian_dates != NO_JULIANS) {
-      printf("/jdstart %d def\n", DAY_OF_YEAR(month, 1, year));
+      out_printf("/jdstart %d def\n", DAY_OF_YEAR(month, 1, year));
    }
    if (julian_dates == ALL_JULIANS) {
-      printf("/yearlen %d def\n", YEAR_LEN(year));
+      out_printf("/yearlen %d def\n", YEAR_LEN(year));
    }
    return;
 }
@@ -3067,15 +3301,19 @@ void print_month (int month, int year)
    /* start of new physical page? */
    if (!do_whole_year || nmonths % 12 == 0) {
       page++;
-      printf("%%%%Page: %d %d\n", page, page);
-      printf("%%%%BeginPageSetup\n");
-      printf("clear flush\n");
-      printf("/PageNum { %d } def\n", page);
-      printf("/PageState save def\n");
-      printf("%%%%EndPageSetup\n\n");
+      out_printf("%%%%Page: %d %d\n", page, page);
+      OUT_LIT("%%BeginPageSetup\n");
+      OUT_LIT("clear flush\n");
+      out_printf("/PageNum { %d } def\n", page);
+      OUT_LIT("/PageState save def\n");
+      OUT_LIT("%%EndPageSetup\n\n");
    }
 #endif
 
+   /* -Q: compress each page apart from its setup and trailer (cf.
+      out_compress_end() regarding 'PageState restore') */
+   if (compress_ps && (!do_whole_year || nmonths % 12 == 0)) out_compress_begin();
+
    if (do_whole_year) {
       /* reset foot strings at start of each page */
       if (nmonths % 12 == 0) {
@@ -3083,13 +3321,13 @@ void print_month (int month, int year)
          def_footstring(cfoot, "Cfootstring");
          def_footstring(rfoot, "Rfootstring");
          def_footstring(notes_hdr, "notesheading");
-         printf("\n");
+         OUT_LIT("\n");
       }
    }
    
    /* set up year and month */
-   printf("/year %d def\n", year);
-   printf("/month %d def\n", month);
+   out_printf("/year %d def\n", year);
+   out_printf("/month %d def\n", month);
    
    /* move starting box to second row if conflict with small calendars */
    startbox = START_BOX(month, year);
@@ -3099,20 +3337,20 @@ void print_month (int month, int year)
       startbox += 7;
    }
 
-   printf("/startbox %d def\n", startbox);
-   printf("/ndays %d def\n", LENGTH_OF(month, year));
+   out_printf("/startbox %d def\n", startbox);
+   out_printf("/ndays %d def\n", LENGTH_OF(month, year));
    
    find_noteboxes(month, year);   /* make list of note boxes */
    print_colors(month, year);   /* make list of date colors */
 
    /* Are we printing 12 months per page or only one? */
    if (do_whole_year) {
-      printf("/posn %d def\n", nmonths % 12);   /* location on page */
+      out_printf("/posn %d def\n", nmonths % 12);   /* location on page */
 
       print_julian_info(month, year);   /* Julian date info */
       print_moon_info(month, year);   /* moon info */
 
-      printf("printmonth\n\n");
+      OUT_LIT("printmonth\n\n");
    }
    else {
       /* reset foot strings each month (may change) */
@@ -3126,21 +3364,21 @@ void print_month (int month, int year)
       if (small_cal_pos != SC_NONE) {
          int m, y;
          
-         printf("/p_year %d def\n", y = PREV_YEAR(month, year));
-         printf("/p_month %d def\n", m = PREV_MONTH(month, year));
-         printf("/p_startbox %d def\n", START_BOX(m, y));
-         printf("/p_ndays %d def\n", LENGTH_OF(m, y));
+         out_printf("/p_year %d def\n", y = PREV_YEAR(month, year));
+         out_printf("/p_month %d def\n", m = PREV_MONTH(month, year));
+         out_printf("/p_startbox %d def\n", START_BOX(m, y));
+         out_printf("/p_ndays %d def\n", LENGTH_OF(m, y));
          
-         printf("/n_year %d def\n", y = NEXT_YEAR(month, year));
-         printf("/n_month %d def\n", m = NEXT_MONTH(month, year));
-         printf("/n_startbox %d def\n", START_BOX(m, y));
-         printf("/n_ndays %d def\n", LENGTH_OF(m, y));
+         out_printf("/n_year %d def\n", y = NEXT_YEAR(month, year));
+         out_printf("/n_month %d def\n", m = NEXT_MONTH(month, year));
+         out_printf("/n_startbox %d def\n", START_BOX(m, y));
+         out_printf("/n_ndays %d def\n", LENGTH_OF(m, y));
       }
 
       print_julian_info(month, year);   /* Julian date info */
       print_moon_info(month, year);   /* moon info */
       
-      printf("printmonth\n");
+      OUT_LIT("printmonth\n");
       find_daytext(month, year, TRUE);   /* holiday text */
       find_daytext(month, year, FALSE);   /* day and note text */
       find_images(month, year);   /* EPS images */
@@ -3148,13 +3386,14 @@ void print_month (int month, int year)
    
    /* end of physical page? */
    if (!do_whole_year || ++nmonths % 12 == 0) {
+      if (compress_ps) out_compress_end();
 #ifdef EPS_DSC
-      printf("%%%%PageTrailer\n");
-      printf("showpage\n");
-      printf("clear flush\n");
-      printf("PageState restore\n");
+      OUT_LIT("%%PageTrailer\n");
+      OUT_LIT("showpage\n");
+      OUT_LIT("clear flush\n");
+      OUT_LIT("PageState restore\n");
 #else
-      printf("showpage\n");
+      OUT_LIT("showpage\n");
 #endif
    }
 }
@@ -3176,10 +3415,10 @@ void print_html (char *p)
    while ((c = *p) != '\0') {
       if (c == '%' && p[1] != '\0') {
          p = expand_fmt(buf, p + 1);
-         PUTSTR_CLEAN(isalnum, buf, stdout);
+         OUT_PUTSTR_CLEAN(isalnum, buf);
       }
-      else if (c < ' ' || c > '\176') printf("&#%03d;", *p++ & CHAR_MSK);
-      else printf("%c", *p++);
+      else if (c < ' ' || c > '\176') out_printf("&#%03d;", *p++ & CHAR_MSK);
+      else out_char(*p++);
    }
    return;
 }